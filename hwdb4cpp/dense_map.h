@@ -0,0 +1,305 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hwdb4cpp {
+
+/// Dense index of a coordinate type, specialized for each key type of a DenseMap.
+/// Specializations provide the number of indices and the index of a key:
+///   static constexpr size_t size;
+///   static size_t index(Key const key);
+template <typename Key>
+struct DenseIndex;
+
+/// Associative container for keys of a small and dense coordinate space.
+/// Entries live in a fixed array indexed by DenseIndex<Key> with a bitset marking
+/// present slots, lookups are a single array read and iteration is a linear scan in
+/// ascending index order. The array is allocated on first insertion, so empty maps
+/// are cheap and moving a map is O(1).
+/// The interface is the subset of std::map used for database entries. Keys sharing
+/// an index, e.g. the same FPGA on different wafers, cannot be stored together,
+/// inserting such a key throws std::invalid_argument.
+template <typename Key, typename Value>
+class DenseMap
+{
+public:
+	typedef Key key_type;
+	typedef Value mapped_type;
+	typedef std::pair<Key const, Value> value_type;
+	typedef size_t size_type;
+
+	static constexpr size_t capacity = DenseIndex<Key>::size;
+
+private:
+	typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Slot;
+
+	template <typename Map, typename Reference>
+	class Iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef typename DenseMap::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef typename std::remove_reference<Reference>::type* pointer;
+		typedef Reference reference;
+
+		Iterator() : m_map(0), m_index(0) {}
+		Iterator(Map* map, size_t index) : m_map(map), m_index(index) {}
+		/// conversion of iterator to const_iterator
+		template <typename OtherMap, typename OtherReference>
+		Iterator(Iterator<OtherMap, OtherReference> const& other) :
+		    m_map(other.m_map), m_index(other.m_index)
+		{}
+
+		reference operator*() const { return m_map->slot(m_index); }
+		pointer operator->() const { return &m_map->slot(m_index); }
+
+		Iterator& operator++()
+		{
+			m_index = m_map->next(m_index);
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator ret = *this;
+			++*this;
+			return ret;
+		}
+
+		Iterator& operator--()
+		{
+			m_index = m_map->previous(m_index);
+			return *this;
+		}
+
+		Iterator operator--(int)
+		{
+			Iterator ret = *this;
+			--*this;
+			return ret;
+		}
+
+		friend bool operator==(Iterator const& a, Iterator const& b)
+		{
+			return a.m_index == b.m_index;
+		}
+		friend bool operator!=(Iterator const& a, Iterator const& b) { return !(a == b); }
+
+	private:
+		template <typename OtherMap, typename OtherReference>
+		friend class Iterator;
+		friend class DenseMap;
+
+		Map* m_map;
+		size_t m_index;
+	};
+
+public:
+	typedef Iterator<DenseMap, value_type&> iterator;
+	typedef Iterator<DenseMap const, value_type const&> const_iterator;
+
+	DenseMap() : m_size(0) {}
+
+	DenseMap(DenseMap const& other) : m_size(0)
+	{
+		for (const_iterator it = other.begin(); it != other.end(); ++it) {
+			insert(*it);
+		}
+	}
+
+	DenseMap(DenseMap&& other) noexcept :
+	    m_slots(std::move(other.m_slots)), m_present(other.m_present), m_size(other.m_size)
+	{
+		other.m_present.reset();
+		other.m_size = 0;
+	}
+
+	DenseMap& operator=(DenseMap other) noexcept
+	{
+		swap(other);
+		return *this;
+	}
+
+	~DenseMap() { clear(); }
+
+	iterator begin() { return iterator(this, next_present(0)); }
+	iterator end() { return iterator(this, capacity); }
+	const_iterator begin() const { return const_iterator(this, next_present(0)); }
+	const_iterator end() const { return const_iterator(this, capacity); }
+
+	size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	void clear()
+	{
+		for (size_t i = next_present(0); i < capacity; i = next_present(i + 1)) {
+			slot(i).~value_type();
+		}
+		m_present.reset();
+		m_size = 0;
+	}
+
+	void swap(DenseMap& other) noexcept
+	{
+		std::swap(m_slots, other.m_slots);
+		std::swap(m_present, other.m_present);
+		std::swap(m_size, other.m_size);
+	}
+
+	iterator find(Key const& key) { return iterator(this, lookup(key)); }
+	const_iterator find(Key const& key) const { return const_iterator(this, lookup(key)); }
+
+	size_t count(Key const& key) const { return lookup(key) == capacity ? 0 : 1; }
+
+	/// @throws std::out_of_range if key is not present
+	Value& at(Key const& key)
+	{
+		size_t const index = lookup(key);
+		if (index == capacity) {
+			throw std::out_of_range("DenseMap::at");
+		}
+		return slot(index).second;
+	}
+
+	Value const& at(Key const& key) const
+	{
+		size_t const index = lookup(key);
+		if (index == capacity) {
+			throw std::out_of_range("DenseMap::at");
+		}
+		return slot(index).second;
+	}
+
+	Value& operator[](Key const& key) { return emplace(key, Value()).first->second; }
+
+	std::pair<iterator, bool> insert(value_type const& value)
+	{
+		return emplace(value.first, value.second);
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Key const& key, Args&&... args)
+	{
+		size_t const index = DenseIndex<Key>::index(key);
+		if (m_present[index]) {
+			if (!(slot(index).first == key)) {
+				throw std::invalid_argument("DenseMap: key collides with present key");
+			}
+			return std::make_pair(iterator(this, index), false);
+		}
+		if (!m_slots) {
+			m_slots.reset(new Slot[capacity]);
+		}
+		new (&m_slots[index]) value_type(key, Value(std::forward<Args>(args)...));
+		m_present.set(index);
+		++m_size;
+		return std::make_pair(iterator(this, index), true);
+	}
+
+	size_t erase(Key const& key)
+	{
+		size_t const index = lookup(key);
+		if (index == capacity) {
+			return 0;
+		}
+		erase_index(index);
+		return 1;
+	}
+
+	iterator erase(const_iterator position)
+	{
+		size_t const index = position.m_index;
+		erase_index(index);
+		return iterator(this, next_present(index + 1));
+	}
+
+	/// keys in iteration order
+	std::vector<Key> keys() const
+	{
+		std::vector<Key> ret;
+		ret.reserve(m_size);
+		for (const_iterator it = begin(); it != end(); ++it) {
+			ret.push_back(it->first);
+		}
+		return ret;
+	}
+
+	friend bool operator==(DenseMap const& a, DenseMap const& b)
+	{
+		if (a.m_present != b.m_present) {
+			return false;
+		}
+		for (const_iterator it = a.begin(), other = b.begin(); it != a.end(); ++it, ++other) {
+			if (!(it->first == other->first) || !(it->second == other->second)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	friend bool operator!=(DenseMap const& a, DenseMap const& b) { return !(a == b); }
+
+private:
+	value_type& slot(size_t const index)
+	{
+		return *reinterpret_cast<value_type*>(&m_slots[index]);
+	}
+
+	value_type const& slot(size_t const index) const
+	{
+		return *reinterpret_cast<value_type const*>(&m_slots[index]);
+	}
+
+	/// index of key if present, capacity otherwise
+	size_t lookup(Key const& key) const
+	{
+		size_t const index = DenseIndex<Key>::index(key);
+		return (m_present[index] && slot(index).first == key) ? index : capacity;
+	}
+
+	size_t next_present(size_t index) const
+	{
+		if (m_size == 0) {
+			return capacity;
+		}
+		while (index < capacity && !m_present[index]) {
+			++index;
+		}
+		return index;
+	}
+
+	size_t next(size_t const index) const { return next_present(index + 1); }
+
+	size_t previous(size_t index) const
+	{
+		while (index > 0) {
+			--index;
+			if (m_present[index]) {
+				return index;
+			}
+		}
+		return capacity;
+	}
+
+	void erase_index(size_t const index)
+	{
+		slot(index).~value_type();
+		m_present.reset(index);
+		--m_size;
+	}
+
+	std::unique_ptr<Slot[]> m_slots;
+	std::bitset<capacity> m_present;
+	size_t m_size;
+};
+
+} // namespace hwdb4cpp
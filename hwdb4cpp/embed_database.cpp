@@ -0,0 +1,53 @@
+#include "hwdb4cpp.h"
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/// Build tool of the hwdb4cpp_embedded library: compiles a YAML database into C++
+/// source defining its binary snapshot as static data, see database::load_embedded.
+int main(int argc, char* argv[])
+{
+	if (argc != 3) {
+		std::cerr << "usage: " << argv[0] << " <db.yaml> <output.cpp>" << std::endl;
+		return 1;
+	}
+	std::string const yaml_path = argv[1];
+	std::string const output_path = argv[2];
+
+	std::string snapshot;
+	try {
+		std::ostringstream ss;
+		hwdb4cpp::database::dump_snapshot(yaml_path, ss);
+		snapshot = ss.str();
+	} catch (std::exception const& err) {
+		std::cerr << "cannot compile " << yaml_path << ": " << err.what() << std::endl;
+		return 1;
+	}
+
+	std::ofstream out(output_path, std::ios::out | std::ios::trunc);
+	out << "// generated by hwdb_embed_database from " << yaml_path << ", do not edit\n"
+	    << "#include <cstddef>\n\n"
+	    << "namespace hwdb4cpp {\n"
+	    << "namespace detail {\n\n"
+	    << "extern char const embedded_snapshot[];\n"
+	    << "extern size_t const embedded_snapshot_size;\n\n"
+	    << "char const embedded_snapshot[] = {";
+	char const* const digits = "0123456789abcdef";
+	for (size_t i = 0; i < snapshot.size(); ++i) {
+		unsigned char const byte = static_cast<unsigned char>(snapshot[i]);
+		out << (i % 16 == 0 ? "\n\t" : " ") << "'\\x" << digits[byte >> 4] << digits[byte & 0xf]
+		    << "',";
+	}
+	out << "\n};\n\n"
+	    << "size_t const embedded_snapshot_size = sizeof(embedded_snapshot);\n\n"
+	    << "} // namespace detail\n"
+	    << "} // namespace hwdb4cpp\n";
+	if (!out) {
+		std::cerr << "cannot write " << output_path << std::endl;
+		return 1;
+	}
+	return 0;
+}
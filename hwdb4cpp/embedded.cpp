@@ -0,0 +1,20 @@
+#include "hwdb4cpp.h"
+
+#include <cstddef>
+
+namespace hwdb4cpp {
+namespace detail {
+
+/// Snapshot of the YAML database, defined by the source generated by
+/// hwdb_embed_database at build time
+extern char const embedded_snapshot[];
+extern size_t const embedded_snapshot_size;
+
+} // namespace detail
+
+void database::load_embedded()
+{
+	load_embedded_snapshot(std::string_view(detail::embedded_snapshot, detail::embedded_snapshot_size));
+}
+
+} // namespace hwdb4cpp
@@ -0,0 +1,379 @@
+#include "hwdb4cpp.h"
+#include "indexes.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace halco::common;
+using namespace halco::hicann::v2;
+
+namespace hwdb4cpp {
+
+/// Setup tables sorted by id
+struct frozen_database::Tables
+{
+	std::vector<std::pair<Wafer, WaferEntry> > wafers;
+	std::vector<std::pair<std::string, DLSSetupEntry> > dls_setups;
+	std::vector<std::pair<size_t, HXCubeSetupEntry> > hxcube_setups;
+	std::vector<std::pair<size_t, JboaSetupEntry> > jboa_setups;
+	/// shared with the database the tables were created from
+	std::shared_ptr<detail::Indexes const> indexes;
+};
+
+namespace {
+
+/// entry of id in table sorted by id, nullptr if missing
+template <typename Key, typename Value>
+Value const* find_entry(std::vector<std::pair<Key, Value> > const& table, Key const& id)
+{
+	auto const it = std::lower_bound(
+	    table.begin(), table.end(), id,
+	    [](std::pair<Key, Value> const& item, Key const& key) { return item.first < key; });
+	if (it == table.end() || id < it->first) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+template <typename Key, typename Value>
+Value const& at_entry(std::vector<std::pair<Key, Value> > const& table, Key const& id)
+{
+	Value const* const entry = find_entry(table, id);
+	if (!entry) {
+		throw std::out_of_range("no entry for id in frozen hwdb");
+	}
+	return *entry;
+}
+
+template <typename Key, typename Value>
+std::vector<Key> get_ids(std::vector<std::pair<Key, Value> > const& table)
+{
+	std::vector<Key> ret;
+	ret.reserve(table.size());
+	for (auto const& item : table) {
+		ret.push_back(item.first);
+	}
+	return ret;
+}
+
+} // anonymous namespace
+
+frozen_database database::freeze() const&
+{
+	materialize();
+	auto tables = std::make_shared<frozen_database::Tables>();
+	tables->wafers.assign(mWaferData.begin(), mWaferData.end());
+	tables->dls_setups.assign(mDLSData.begin(), mDLSData.end());
+	tables->hxcube_setups.assign(mHXCubeData.begin(), mHXCubeData.end());
+	tables->jboa_setups.assign(mJboaData.begin(), mJboaData.end());
+	tables->indexes = get_indexes();
+	return frozen_database(std::move(tables));
+}
+
+frozen_database database::freeze() &&
+{
+	materialize();
+	auto tables = std::make_shared<frozen_database::Tables>();
+	tables->indexes = get_indexes();
+	tables->wafers.reserve(mWaferData.size());
+	for (auto& item : mWaferData) {
+		tables->wafers.emplace_back(item.first, std::move(item.second));
+	}
+	tables->dls_setups.reserve(mDLSData.size());
+	for (auto& item : mDLSData) {
+		tables->dls_setups.emplace_back(item.first, std::move(item.second));
+	}
+	tables->hxcube_setups.reserve(mHXCubeData.size());
+	for (auto& item : mHXCubeData) {
+		tables->hxcube_setups.emplace_back(item.first, std::move(item.second));
+	}
+	tables->jboa_setups.reserve(mJboaData.size());
+	for (auto& item : mJboaData) {
+		tables->jboa_setups.emplace_back(item.first, std::move(item.second));
+	}
+	clear();
+	return frozen_database(std::move(tables));
+}
+
+frozen_database::frozen_database(std::shared_ptr<Tables const> tables) : m_tables(std::move(tables))
+{}
+
+WaferEntry const* frozen_database::find_wafer(Wafer const wafer) const
+{
+	return find_entry(m_tables->wafers, wafer);
+}
+
+bool frozen_database::has_wafer_entry(Wafer const wafer) const
+{
+	return find_wafer(wafer) != nullptr;
+}
+
+WaferEntry const& frozen_database::get_wafer_entry(Wafer const wafer) const
+{
+	return at_entry(m_tables->wafers, wafer);
+}
+
+std::vector<Wafer> frozen_database::get_wafer_coordinates() const
+{
+	return get_ids(m_tables->wafers);
+}
+
+bool frozen_database::has_fpga_entry(FPGAGlobal const fpga) const
+{
+	WaferEntry const* const wafer = find_wafer(fpga.toWafer());
+	return wafer && wafer->fpgas.count(fpga);
+}
+
+FPGAEntry const& frozen_database::get_fpga_entry(FPGAGlobal const fpga) const
+{
+	return get_wafer_entry(fpga.toWafer()).fpgas.at(fpga);
+}
+
+FPGAEntryMap frozen_database::get_fpga_entries(Wafer const wafer) const
+{
+	return get_wafer_entry(wafer).fpgas;
+}
+
+bool frozen_database::has_reticle_entry(DNCGlobal const reticle) const
+{
+	WaferEntry const* const wafer = find_wafer(reticle.toWafer());
+	return wafer && wafer->reticles.count(reticle);
+}
+
+ReticleEntry const& frozen_database::get_reticle_entry(DNCGlobal const reticle) const
+{
+	return get_wafer_entry(reticle.toWafer()).reticles.at(reticle);
+}
+
+ReticleEntryMap frozen_database::get_reticle_entries(Wafer const wafer) const
+{
+	return get_wafer_entry(wafer).reticles;
+}
+
+bool frozen_database::has_ananas_entry(AnanasGlobal const ananas) const
+{
+	WaferEntry const* const wafer = find_wafer(ananas.toWafer());
+	return wafer && wafer->ananas.count(ananas);
+}
+
+AnanasEntry const& frozen_database::get_ananas_entry(AnanasGlobal const ananas) const
+{
+	return get_wafer_entry(ananas.toWafer()).ananas.at(ananas);
+}
+
+AnanasEntryMap frozen_database::get_ananas_entries(Wafer const wafer) const
+{
+	return get_wafer_entry(wafer).ananas;
+}
+
+bool frozen_database::has_hicann_entry(HICANNGlobal const hicann) const
+{
+	WaferEntry const* const wafer = find_wafer(hicann.toWafer());
+	return wafer && wafer->has_hicann(hicann);
+}
+
+HICANNEntry const& frozen_database::get_hicann_entry(HICANNGlobal const hicann) const
+{
+	return get_wafer_entry(hicann.toWafer()).get_hicann(hicann);
+}
+
+HICANNEntryMap frozen_database::get_hicann_entries(Wafer const wafer) const
+{
+	return get_wafer_entry(wafer).get_hicanns();
+}
+
+HICANNEntryMap frozen_database::get_hicann_entries(FPGAGlobal const fpga) const
+{
+	return get_hicann_entries(gridLookupDNCGlobal(fpga, DNCOnFPGA(Enum(0))));
+}
+
+HICANNEntryMap frozen_database::get_hicann_entries(DNCGlobal const reticle) const
+{
+	WaferEntry const* const wafer = find_wafer(reticle.toWafer());
+	if (!wafer) {
+		return HICANNEntryMap();
+	}
+	return wafer->get_hicanns(reticle);
+}
+
+bool frozen_database::has_adc_entry(GlobalAnalog_t const analog) const
+{
+	WaferEntry const* const wafer = find_wafer(analog.first.toWafer());
+	return wafer && wafer->adcs.count(analog);
+}
+
+ADCEntry const& frozen_database::get_adc_entry(GlobalAnalog_t const analog) const
+{
+	return get_wafer_entry(analog.first.toWafer()).adcs.at(analog);
+}
+
+ADCEntryMap frozen_database::get_adc_entries(Wafer const wafer) const
+{
+	return get_wafer_entry(wafer).adcs;
+}
+
+ADCEntryMap frozen_database::get_adc_entries(FPGAGlobal const fpga) const
+{
+	return get_wafer_entry(fpga.toWafer()).get_adcs(fpga);
+}
+
+bool frozen_database::has_dls_entry(std::string const dls_setup) const
+{
+	return find_entry(m_tables->dls_setups, dls_setup) != nullptr;
+}
+
+DLSSetupEntry const& frozen_database::get_dls_entry(std::string const dls_setup) const
+{
+	return at_entry(m_tables->dls_setups, dls_setup);
+}
+
+std::vector<std::string> frozen_database::get_dls_setup_ids() const
+{
+	return get_ids(m_tables->dls_setups);
+}
+
+bool frozen_database::has_hxcube_setup_entry(size_t const hxcube_id) const
+{
+	return find_entry(m_tables->hxcube_setups, hxcube_id) != nullptr;
+}
+
+HXCubeSetupEntry const& frozen_database::get_hxcube_setup_entry(size_t const hxcube_id) const
+{
+	return at_entry(m_tables->hxcube_setups, hxcube_id);
+}
+
+std::vector<size_t> frozen_database::get_hxcube_ids() const
+{
+	return get_ids(m_tables->hxcube_setups);
+}
+
+bool frozen_database::has_jboa_setup_entry(size_t const jboa_id) const
+{
+	return find_entry(m_tables->jboa_setups, jboa_id) != nullptr;
+}
+
+JboaSetupEntry const& frozen_database::get_jboa_setup_entry(size_t const jboa_id) const
+{
+	return at_entry(m_tables->jboa_setups, jboa_id);
+}
+
+std::vector<size_t> frozen_database::get_jboa_ids() const
+{
+	return get_ids(m_tables->jboa_setups);
+}
+
+std::vector<NetworkEndpoint> frozen_database::find_endpoints(IPv4 const& ip) const
+{
+	return m_tables->indexes->find_endpoints(ip);
+}
+
+std::vector<NetworkEndpoint> frozen_database::find_endpoints(
+    IPv4 const& ip, uint16_t const port) const
+{
+	return m_tables->indexes->find_endpoints(ip, port);
+}
+
+std::vector<NetworkEndpoint> frozen_database::find_endpoints_in_subnet(
+    IPv4 const& network, size_t const prefix_length) const
+{
+	return m_tables->indexes->find_endpoints_in_subnet(network, prefix_length);
+}
+
+std::optional<UniqueBranchIdentifier> frozen_database::find_chip(size_t const chip_serial) const
+{
+	UniqueBranchIdentifier const* const id = m_tables->indexes->find_chip(chip_serial);
+	return id ? std::optional<UniqueBranchIdentifier>(*id) : std::nullopt;
+}
+
+std::string frozen_database::get_unique_branch_identifier(size_t const chip_serial) const
+{
+	return m_tables->indexes->get_unique_branch_identifier(chip_serial);
+}
+
+std::vector<std::string> frozen_database::get_unique_branch_identifiers(
+    std::vector<size_t> const& chip_serials) const
+{
+	return m_tables->indexes->get_unique_branch_identifiers(chip_serials);
+}
+
+std::vector<std::string> frozen_database::get_adc_serials() const
+{
+	return m_tables->indexes->get_adc_serials();
+}
+
+std::vector<ADCChannel> frozen_database::get_adc_channels(std::string const& adc) const
+{
+	std::vector<ADCChannel> const* const channels = m_tables->indexes->find_adc_channels(adc);
+	return channels ? *channels : std::vector<ADCChannel>();
+}
+
+std::vector<ADCConflict> frozen_database::get_adc_conflicts() const
+{
+	return m_tables->indexes->get_adc_conflicts();
+}
+
+std::optional<FPGALocation> frozen_database::find_fpga_by_fuse_dna(uint64_t const fuse_dna) const
+{
+	FPGALocation const* const fpga = m_tables->indexes->find_fpga_by_fuse_dna(fuse_dna);
+	return fpga ? std::optional<FPGALocation>(*fpga) : std::nullopt;
+}
+
+std::optional<FPGALocation> frozen_database::find_fpga_by_dna_port(uint64_t const dna_port) const
+{
+	FPGALocation const* const fpga = m_tables->indexes->find_fpga_by_dna_port(dna_port);
+	return fpga ? std::optional<FPGALocation>(*fpga) : std::nullopt;
+}
+
+std::vector<std::optional<FPGALocation> > frozen_database::find_fpgas_by_dna_port(
+    std::vector<uint64_t> const& dna_ports) const
+{
+	return m_tables->indexes->find_fpgas_by_dna_port(dna_ports);
+}
+
+template <typename Entity>
+bool frozen_database::has_index(std::string const& name) const
+{
+	return m_tables->indexes->find_secondary_index<Entity>(name) != nullptr;
+}
+
+template <typename Entity>
+std::vector<typename IndexedEntity<Entity>::coordinate_type> frozen_database::find_by_index(
+    std::string const& name, IndexKey const& key) const
+{
+	return m_tables->indexes->get_secondary_index<Entity>(name).find(key);
+}
+
+template <typename Entity>
+std::vector<typename IndexedEntity<Entity>::coordinate_type>
+frozen_database::find_by_index_range(
+    std::string const& name, IndexKey const& lower, IndexKey const& upper) const
+{
+	return m_tables->indexes->get_secondary_index<Entity>(name).find_range(lower, upper);
+}
+
+#define HWDB4CPP_INSTANTIATE_INDEX(Entity)                                                         \
+	template bool frozen_database::has_index<Entity>(std::string const&) const;                    \
+	template std::vector<IndexedEntity<Entity>::coordinate_type>                                   \
+	frozen_database::find_by_index<Entity>(std::string const&, IndexKey const&) const;             \
+	template std::vector<IndexedEntity<Entity>::coordinate_type>                                   \
+	frozen_database::find_by_index_range<Entity>(                                                  \
+	    std::string const&, IndexKey const&, IndexKey const&) const;
+
+HWDB4CPP_INSTANTIATE_INDEX(WaferEntry)
+HWDB4CPP_INSTANTIATE_INDEX(FPGAEntry)
+HWDB4CPP_INSTANTIATE_INDEX(ReticleEntry)
+HWDB4CPP_INSTANTIATE_INDEX(AnanasEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HICANNEntry)
+HWDB4CPP_INSTANTIATE_INDEX(ADCEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HXCubeSetupEntry)
+HWDB4CPP_INSTANTIATE_INDEX(JboaSetupEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HXCubeFPGAEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HXCubeWingEntry)
+HWDB4CPP_INSTANTIATE_INDEX(JboaAggregatorEntry)
+#undef HWDB4CPP_INSTANTIATE_INDEX
+
+} // namespace hwdb4cpp
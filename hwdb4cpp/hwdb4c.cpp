@@ -1,8 +1,11 @@
 #include "hwdb4c.h"
 #include "halco/common/iter_all.h"
+#include "hwdb4c_database.h"
 #include "hwdb4cpp.h"
 
+#include <algorithm>
 #include <fstream>
+#include <future>
 #include <iostream>
 
 #define HWDB4C_MAX_STRING_LENGTH 200
@@ -13,14 +16,16 @@ using namespace halco::hicann::v2;
 
 extern "C" {
 
-struct hwdb4c_database_t
+struct hwdb4c_load_filter_t
 {
-	hwdb4cpp::database database;
+	hwdb4cpp::LoadFilter filter;
 };
 
 // converts hwdb4cpp::FPGAEntry to hwdb4c_fpga_entry
 int _convert_fpga_entry(
-    hwdb4cpp::FPGAEntry fpga_entry_cpp, FPGAGlobal fpgacoord, struct hwdb4c_fpga_entry** ret)
+    hwdb4cpp::FPGAEntry const& fpga_entry_cpp,
+    FPGAGlobal fpgacoord,
+    struct hwdb4c_fpga_entry** ret)
 {
 	struct hwdb4c_fpga_entry* fpga_entry_c =
 	    (hwdb4c_fpga_entry*) malloc(sizeof(struct hwdb4c_fpga_entry));
@@ -35,7 +40,7 @@ int _convert_fpga_entry(
 
 // converts hwdb4cpp::ReticleEntry to hwdb4c_reticle_entry
 int _convert_reticle_entry(
-    hwdb4cpp::ReticleEntry reticle_entry_cpp,
+    hwdb4cpp::ReticleEntry const& reticle_entry_cpp,
     DNCGlobal reticlecoord,
     struct hwdb4c_reticle_entry** ret)
 {
@@ -50,7 +55,7 @@ int _convert_reticle_entry(
 }
 
 int _convert_ananas_entry(
-    hwdb4cpp::AnanasEntry ananas_entry_cpp,
+    hwdb4cpp::AnanasEntry const& ananas_entry_cpp,
     AnanasGlobal ananascoord,
     struct hwdb4c_ananas_entry** ret)
 {
@@ -68,7 +73,7 @@ int _convert_ananas_entry(
 
 // converts hwdb4cpp::HICANNEntry to hwdb4c_hicann_entry
 int _convert_hicann_entry(
-    hwdb4cpp::HICANNEntry hicann_entry_cpp,
+    hwdb4cpp::HICANNEntry const& hicann_entry_cpp,
     HICANNGlobal hicanncoord,
     struct hwdb4c_hicann_entry** ret)
 {
@@ -91,7 +96,9 @@ int _convert_hicann_entry(
 
 // converts hwdb4cpp::ADCEntry to hwdb4c_adc_entry
 int _convert_adc_entry(
-    hwdb4cpp::ADCEntry adc_entry_cpp, hwdb4cpp::GlobalAnalog_t key, struct hwdb4c_adc_entry** ret)
+    hwdb4cpp::ADCEntry const& adc_entry_cpp,
+    hwdb4cpp::GlobalAnalog_t key,
+    struct hwdb4c_adc_entry** ret)
 {
 	struct hwdb4c_adc_entry* adc_entry_c =
 	    (hwdb4c_adc_entry*) malloc(sizeof(struct hwdb4c_adc_entry));
@@ -118,7 +125,9 @@ int _convert_adc_entry(
 
 // converts hwdb4cpp::WaferEntry to hwdb4c_wafer_entry
 int _convert_wafer_entry(
-    hwdb4cpp::WaferEntry wafer_entry_cpp, Wafer wafercoord, struct hwdb4c_wafer_entry** ret)
+    hwdb4cpp::WaferEntry const& wafer_entry_cpp,
+    Wafer wafercoord,
+    struct hwdb4c_wafer_entry** ret)
 {
 	struct hwdb4c_wafer_entry* wafer_entry_c =
 	    (hwdb4c_wafer_entry*) malloc(sizeof(struct hwdb4c_wafer_entry));
@@ -173,20 +182,29 @@ int _convert_wafer_entry(
 		ananas_counter++;
 	}
 
-	wafer_entry_c->num_hicann_entries = wafer_entry_cpp.hicanns.size();
+	size_t num_hicann_entries = 0;
+	wafer_entry_cpp.for_each_hicann(
+	    [&num_hicann_entries](HICANNGlobal const, hwdb4cpp::HICANNEntry const&) {
+		    num_hicann_entries++;
+	    });
+	wafer_entry_c->num_hicann_entries = num_hicann_entries;
 	wafer_entry_c->hicanns = (hwdb4c_hicann_entry**) malloc(
 	    sizeof(struct hwdb4c_hicann_entry*) * wafer_entry_c->num_hicann_entries);
 	if (!wafer_entry_c->hicanns)
 		return HWDB4C_FAILURE;
 	size_t hicann_counter = 0;
-	for (auto hicann_it = wafer_entry_cpp.hicanns.begin();
-	     hicann_it != wafer_entry_cpp.hicanns.end(); hicann_it++) {
-		if (_convert_hicann_entry(
-		        hicann_it->second, hicann_it->first, &(wafer_entry_c->hicanns[hicann_counter])) ==
+	bool hicann_failure = false;
+	wafer_entry_cpp.for_each_hicann([&](HICANNGlobal const hicann,
+	                                    hwdb4cpp::HICANNEntry const& entry) {
+		if (hicann_failure)
+			return;
+		if (_convert_hicann_entry(entry, hicann, &(wafer_entry_c->hicanns[hicann_counter])) ==
 		    HWDB4C_FAILURE)
-			return HWDB4C_FAILURE;
+			hicann_failure = true;
 		hicann_counter++;
-	}
+	});
+	if (hicann_failure)
+		return HWDB4C_FAILURE;
 
 	wafer_entry_c->num_adc_entries = wafer_entry_cpp.adcs.size();
 	wafer_entry_c->adcs = (hwdb4c_adc_entry**) malloc(
@@ -210,7 +228,7 @@ int _convert_wafer_entry(
 }
 
 int _convert_dls_entry(
-    hwdb4cpp::DLSSetupEntry dls_setup_entry_cpp,
+    hwdb4cpp::DLSSetupEntry const& dls_setup_entry_cpp,
     char* dls_setup,
     struct hwdb4c_dls_setup_entry** ret)
 {
@@ -306,7 +324,7 @@ void _convert_hxcube_fpga_entry(
 
 // converts hwdb4cpp::HXCubeSetupEntry to hwdb4c_hxcube_setup_entry (required for SLURM)
 int _convert_hxcube_setup_entry(
-    hwdb4cpp::HXCubeSetupEntry hxcube_entry_cpp,
+    hwdb4cpp::HXCubeSetupEntry const& hxcube_entry_cpp,
     size_t hxcube_id,
     struct hwdb4c_hxcube_setup_entry** ret)
 {
@@ -372,7 +390,9 @@ void _convert_jboa_aggregator_entry(
 
 // converts hwdb4cpp::JboaSetupEntry to hwdb4c_jboa_setup_entry (required for SLURM)
 int _convert_jboa_setup_entry(
-    hwdb4cpp::JboaSetupEntry jboa_entry_cpp, size_t jboa_id, struct hwdb4c_jboa_setup_entry** ret)
+    hwdb4cpp::JboaSetupEntry const& jboa_entry_cpp,
+    size_t jboa_id,
+    struct hwdb4c_jboa_setup_entry** ret)
 {
 	struct hwdb4c_jboa_setup_entry* jboa_entry_c =
 	    (hwdb4c_jboa_setup_entry*) malloc(sizeof(struct hwdb4c_jboa_setup_entry));
@@ -485,6 +505,161 @@ void hwdb4c_free_hwdb(struct hwdb4c_database_t* handle)
 	delete (handle);
 }
 
+// converts hwdb4c_setup_family_t to hwdb4cpp::SetupFamily
+int _convert_setup_family(enum hwdb4c_setup_family_t family, hwdb4cpp::SetupFamily* ret)
+{
+	switch (family) {
+		case HWDB4C_WAFER:
+			*ret = hwdb4cpp::SetupFamily::wafer;
+			break;
+		case HWDB4C_DLS_SETUP:
+			*ret = hwdb4cpp::SetupFamily::dls_setup;
+			break;
+		case HWDB4C_HXCUBE_SETUP:
+			*ret = hwdb4cpp::SetupFamily::hxcube;
+			break;
+		case HWDB4C_JBOA_SETUP:
+			*ret = hwdb4cpp::SetupFamily::jboa;
+			break;
+		default:
+			return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_alloc_load_filter(struct hwdb4c_load_filter_t** ret)
+{
+	try {
+		*ret = new struct hwdb4c_load_filter_t();
+	} catch (...) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_filter_add_family(struct hwdb4c_load_filter_t* filter, enum hwdb4c_setup_family_t family)
+{
+	hwdb4cpp::SetupFamily family_cpp;
+	if (_convert_setup_family(family, &family_cpp) != HWDB4C_SUCCESS)
+		return HWDB4C_FAILURE;
+	try {
+		filter->filter.add(family_cpp);
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_filter_add_id(
+    struct hwdb4c_load_filter_t* filter, enum hwdb4c_setup_family_t family, size_t id)
+{
+	hwdb4cpp::SetupFamily family_cpp;
+	if (_convert_setup_family(family, &family_cpp) != HWDB4C_SUCCESS)
+		return HWDB4C_FAILURE;
+	try {
+		filter->filter.add(family_cpp, id);
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_filter_add_dls_setup(struct hwdb4c_load_filter_t* filter, char const* dls_setup)
+{
+	if (dls_setup == NULL)
+		return HWDB4C_FAILURE;
+	try {
+		filter->filter.add(hwdb4cpp::SetupFamily::dls_setup, std::string(dls_setup));
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+void hwdb4c_free_load_filter(struct hwdb4c_load_filter_t* filter)
+{
+	delete (filter);
+}
+
+int hwdb4c_load_hwdb_filtered(
+    struct hwdb4c_database_t* handle,
+    char const* hwdb_path,
+    struct hwdb4c_load_filter_t const* filter)
+{
+	std::string path;
+	if (hwdb_path == NULL)
+		path = handle->database.get_default_path();
+	else
+		path = std::string(hwdb_path);
+	hwdb4cpp::LoadOptions options;
+	if (filter != NULL)
+		options.filter = filter->filter;
+	try {
+		handle->database.load(path, options);
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_hwdb_from_buffer(struct hwdb4c_database_t* handle, char const* buffer, size_t size)
+{
+	if (buffer == NULL && size != 0)
+		return HWDB4C_FAILURE;
+	try {
+		handle->database.load_from_buffer(std::string_view(buffer, size));
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_hwdb_from_fd(struct hwdb4c_database_t* handle, int fd)
+{
+	try {
+		handle->database.load_from_fd(fd);
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_hwdb_async(struct hwdb4c_database_t* handle, char const* hwdb_path)
+{
+	if (handle->pending_load.valid())
+		return HWDB4C_FAILURE;
+	std::string path;
+	if (hwdb_path == NULL)
+		path = handle->database.get_default_path();
+	else
+		path = std::string(hwdb_path);
+	try {
+		handle->pending_load = handle->database.load_async(path);
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_hwdb_poll(struct hwdb4c_database_t* handle, bool* done)
+{
+	*done = !handle->pending_load.valid() ||
+	        handle->pending_load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_load_hwdb_wait(struct hwdb4c_database_t* handle)
+{
+	if (!handle->pending_load.valid())
+		return HWDB4C_SUCCESS;
+	try {
+		handle->pending_load.get();
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
 char* hwdb4c_get_yaml_entries(char const* hwdb_path, char const* node, char const* query)
 {
 	hwdb4cpp::database database;
@@ -593,49 +768,57 @@ int hwdb4c_has_adc_entry(
 int hwdb4c_get_fpga_entry(
     struct hwdb4c_database_t* handle, size_t fpgaglobal_id, struct hwdb4c_fpga_entry** ret)
 {
-	hwdb4cpp::FPGAEntry fpga_entry_cpp;
+	hwdb4cpp::FPGAEntry const* fpga_entry_cpp;
 	try {
-		fpga_entry_cpp = handle->database.get_fpga_entry(FPGAGlobal(Enum(fpgaglobal_id)));
+		fpga_entry_cpp = handle->database.find_fpga_entry(FPGAGlobal(Enum(fpgaglobal_id)));
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_fpga_entry(fpga_entry_cpp, FPGAGlobal(Enum(fpgaglobal_id)), ret);
+	if (!fpga_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_fpga_entry(*fpga_entry_cpp, FPGAGlobal(Enum(fpgaglobal_id)), ret);
 }
 
 int hwdb4c_get_reticle_entry(
     struct hwdb4c_database_t* handle, size_t reticleglobal_id, struct hwdb4c_reticle_entry** ret)
 {
-	hwdb4cpp::ReticleEntry reticle_entry_cpp;
+	hwdb4cpp::ReticleEntry const* reticle_entry_cpp;
 	try {
-		reticle_entry_cpp = handle->database.get_reticle_entry(DNCGlobal(Enum(reticleglobal_id)));
+		reticle_entry_cpp = handle->database.find_reticle_entry(DNCGlobal(Enum(reticleglobal_id)));
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_reticle_entry(reticle_entry_cpp, DNCGlobal(Enum(reticleglobal_id)), ret);
+	if (!reticle_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_reticle_entry(*reticle_entry_cpp, DNCGlobal(Enum(reticleglobal_id)), ret);
 }
 
 int hwdb4c_get_ananas_entry(
     struct hwdb4c_database_t* handle, size_t ananasglobal_id, struct hwdb4c_ananas_entry** ret)
 {
-	hwdb4cpp::AnanasEntry ananas_entry_cpp;
+	hwdb4cpp::AnanasEntry const* ananas_entry_cpp;
 	try {
-		ananas_entry_cpp = handle->database.get_ananas_entry(AnanasGlobal(Enum(ananasglobal_id)));
+		ananas_entry_cpp = handle->database.find_ananas_entry(AnanasGlobal(Enum(ananasglobal_id)));
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_ananas_entry(ananas_entry_cpp, AnanasGlobal(Enum(ananasglobal_id)), ret);
+	if (!ananas_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_ananas_entry(*ananas_entry_cpp, AnanasGlobal(Enum(ananasglobal_id)), ret);
 }
 
 int hwdb4c_get_hicann_entry(
     struct hwdb4c_database_t* handle, size_t hicannglobal_id, struct hwdb4c_hicann_entry** ret)
 {
-	hwdb4cpp::HICANNEntry hicann_entry_cpp;
+	hwdb4cpp::HICANNEntry const* hicann_entry_cpp;
 	try {
-		hicann_entry_cpp = handle->database.get_hicann_entry(HICANNGlobal(Enum(hicannglobal_id)));
+		hicann_entry_cpp = handle->database.find_hicann_entry(HICANNGlobal(Enum(hicannglobal_id)));
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_hicann_entry(hicann_entry_cpp, HICANNGlobal(Enum(hicannglobal_id)), ret);
+	if (!hicann_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_hicann_entry(*hicann_entry_cpp, HICANNGlobal(Enum(hicannglobal_id)), ret);
 }
 
 int hwdb4c_get_adc_entry(
@@ -644,65 +827,75 @@ int hwdb4c_get_adc_entry(
     size_t analogonhicann,
     struct hwdb4c_adc_entry** adc)
 {
-	hwdb4cpp::ADCEntry adc_entry_cpp;
+	hwdb4cpp::ADCEntry const* adc_entry_cpp;
 	hwdb4cpp::GlobalAnalog_t adc_key;
 	try {
 		adc_key = hwdb4cpp::GlobalAnalog_t(
 		    FPGAGlobal(Enum(fpgaglobal_id)), AnalogOnHICANN(uint8_t(analogonhicann)));
-		adc_entry_cpp = handle->database.get_adc_entry(adc_key);
+		adc_entry_cpp = handle->database.find_adc_entry(adc_key);
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	bool returnval = _convert_adc_entry(adc_entry_cpp, adc_key, adc);
+	if (!adc_entry_cpp)
+		return HWDB4C_FAILURE;
+	bool returnval = _convert_adc_entry(*adc_entry_cpp, adc_key, adc);
 	return returnval;
 }
 
 int hwdb4c_get_wafer_entry(
     struct hwdb4c_database_t* handle, size_t wafer_id, struct hwdb4c_wafer_entry** ret)
 {
-	hwdb4cpp::WaferEntry wafer_entry_cpp;
+	hwdb4cpp::WaferEntry const* wafer_entry_cpp;
 	try {
-		wafer_entry_cpp = handle->database.get_wafer_entry(Wafer(wafer_id));
+		wafer_entry_cpp = handle->database.find_wafer_entry(Wafer(wafer_id));
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_wafer_entry(wafer_entry_cpp, Wafer(wafer_id), ret);
+	if (!wafer_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_wafer_entry(*wafer_entry_cpp, Wafer(wafer_id), ret);
 }
 
 int hwdb4c_get_dls_entry(
     struct hwdb4c_database_t* handle, char* dls_setup, struct hwdb4c_dls_setup_entry** ret)
 {
-	hwdb4cpp::DLSSetupEntry dls_setup_entry_cpp;
+	hwdb4cpp::DLSSetupEntry const* dls_setup_entry_cpp;
 	try {
-		dls_setup_entry_cpp = handle->database.get_dls_entry(dls_setup);
+		dls_setup_entry_cpp = handle->database.find_dls_entry(dls_setup);
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_dls_entry(dls_setup_entry_cpp, dls_setup, ret);
+	if (!dls_setup_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_dls_entry(*dls_setup_entry_cpp, dls_setup, ret);
 }
 
 int hwdb4c_get_hxcube_setup_entry(
     struct hwdb4c_database_t* handle, size_t hxcube_id, struct hwdb4c_hxcube_setup_entry** ret)
 {
-	hwdb4cpp::HXCubeSetupEntry hxcube_entry_cpp;
+	hwdb4cpp::HXCubeSetupEntry const* hxcube_entry_cpp;
 	try {
-		hxcube_entry_cpp = handle->database.get_hxcube_setup_entry(hxcube_id);
+		hxcube_entry_cpp = handle->database.find_hxcube_setup_entry(hxcube_id);
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_hxcube_setup_entry(hxcube_entry_cpp, hxcube_id, ret);
+	if (!hxcube_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_hxcube_setup_entry(*hxcube_entry_cpp, hxcube_id, ret);
 }
 
 int hwdb4c_get_jboa_setup_entry(
     struct hwdb4c_database_t* handle, size_t jboa_id, struct hwdb4c_jboa_setup_entry** ret)
 {
-	hwdb4cpp::JboaSetupEntry jboa_entry_cpp;
+	hwdb4cpp::JboaSetupEntry const* jboa_entry_cpp;
 	try {
-		jboa_entry_cpp = handle->database.get_jboa_setup_entry(jboa_id);
+		jboa_entry_cpp = handle->database.find_jboa_setup_entry(jboa_id);
 	} catch (const std::out_of_range& hdke) {
 		return HWDB4C_FAILURE;
 	}
-	return _convert_jboa_setup_entry(jboa_entry_cpp, jboa_id, ret);
+	if (!jboa_entry_cpp)
+		return HWDB4C_FAILURE;
+	return _convert_jboa_setup_entry(*jboa_entry_cpp, jboa_id, ret);
 }
 
 int hwdb4c_get_wafer_coordinates(
@@ -759,7 +952,7 @@ int hwdb4c_get_hicann_entries_of_FPGAGlobal(
     struct hwdb4c_hicann_entry*** hicanns,
     size_t* num_hicanns)
 {
-	std::map<HICANNGlobal, hwdb4cpp::HICANNEntry> hicann_map;
+	hwdb4cpp::HICANNEntryMap hicann_map;
 	try {
 		hicann_map = handle->database.get_hicann_entries(FPGAGlobal(Enum(fpgaglobal_id)));
 	} catch (const std::out_of_range& oor) {
@@ -786,7 +979,7 @@ int hwdb4c_get_hicann_entries_of_Wafer(
     struct hwdb4c_hicann_entry*** hicanns,
     size_t* num_hicanns)
 {
-	std::map<HICANNGlobal, hwdb4cpp::HICANNEntry> hicann_map;
+	hwdb4cpp::HICANNEntryMap hicann_map;
 	try {
 		hicann_map = handle->database.get_hicann_entries(Wafer(wafer_id));
 	} catch (const std::out_of_range& oor) {
@@ -806,18 +999,219 @@ int hwdb4c_get_hicann_entries_of_Wafer(
 	return HWDB4C_SUCCESS;
 }
 
+int hwdb4c_get_hicann_entries_of_DNCGlobal(
+    struct hwdb4c_database_t* handle,
+    size_t reticleglobal_id,
+    struct hwdb4c_hicann_entry*** hicanns,
+    size_t* num_hicanns)
+{
+	hwdb4cpp::HICANNEntryMap hicann_map;
+	try {
+		hicann_map = handle->database.get_hicann_entries(DNCGlobal(Enum(reticleglobal_id)));
+	} catch (const std::out_of_range& oor) {
+		return HWDB4C_FAILURE;
+	}
+	*num_hicanns = hicann_map.size();
+	*hicanns = (hwdb4c_hicann_entry**) malloc(sizeof(struct hwdb4c_hicann_entry*) * *num_hicanns);
+	if (!*hicanns && *num_hicanns)
+		return HWDB4C_FAILURE;
+	size_t hicann_counter = 0;
+	for (auto hicann_it = hicann_map.begin(); hicann_it != hicann_map.end(); hicann_it++) {
+		if (_convert_hicann_entry(
+		        hicann_it->second, hicann_it->first, &(*hicanns)[hicann_counter]) == HWDB4C_FAILURE)
+			return HWDB4C_FAILURE;
+		hicann_counter++;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_get_fpga_entries_of_Wafer(
+    struct hwdb4c_database_t* handle,
+    size_t wafer_id,
+    struct hwdb4c_fpga_entry*** fpgas,
+    size_t* num_fpgas)
+{
+	hwdb4cpp::WaferEntry const* wafer_entry_cpp;
+	try {
+		wafer_entry_cpp = handle->database.find_wafer_entry(Wafer(wafer_id));
+	} catch (const std::out_of_range& oor) {
+		return HWDB4C_FAILURE;
+	}
+	if (!wafer_entry_cpp)
+		return HWDB4C_FAILURE;
+	hwdb4cpp::FPGAEntryMap const& fpga_map = wafer_entry_cpp->fpgas;
+	*num_fpgas = fpga_map.size();
+	*fpgas = (hwdb4c_fpga_entry**) malloc(sizeof(struct hwdb4c_fpga_entry*) * *num_fpgas);
+	if (!*fpgas && *num_fpgas)
+		return HWDB4C_FAILURE;
+	size_t fpga_counter = 0;
+	for (auto fpga_it = fpga_map.begin(); fpga_it != fpga_map.end(); fpga_it++) {
+		if (_convert_fpga_entry(fpga_it->second, fpga_it->first, &(*fpgas)[fpga_counter]) ==
+		    HWDB4C_FAILURE)
+			return HWDB4C_FAILURE;
+		fpga_counter++;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+// converts ip_addr_t to IPv4
+IPv4 _convert_ip(ip_addr_t const ip)
+{
+	return IPv4::from_string(inet_ntoa(ip));
+}
+
+// converts hwdb4cpp::EndpointOwner to hwdb4c_endpoint_owner_t
+enum hwdb4c_endpoint_owner_t _convert_endpoint_owner(hwdb4cpp::EndpointOwner const owner)
+{
+	switch (owner) {
+		case hwdb4cpp::EndpointOwner::fpga:
+			return HWDB4C_ENDPOINT_FPGA;
+		case hwdb4cpp::EndpointOwner::ananas_data:
+			return HWDB4C_ENDPOINT_ANANAS_DATA;
+		case hwdb4cpp::EndpointOwner::ananas_reset:
+			return HWDB4C_ENDPOINT_ANANAS_RESET;
+		case hwdb4cpp::EndpointOwner::adc:
+			return HWDB4C_ENDPOINT_ADC;
+		case hwdb4cpp::EndpointOwner::macu:
+			return HWDB4C_ENDPOINT_MACU;
+		case hwdb4cpp::EndpointOwner::hxcube_fpga:
+			return HWDB4C_ENDPOINT_HXCUBE_FPGA;
+		case hwdb4cpp::EndpointOwner::jboa_fpga:
+			return HWDB4C_ENDPOINT_JBOA_FPGA;
+		case hwdb4cpp::EndpointOwner::jboa_aggregator:
+			return HWDB4C_ENDPOINT_JBOA_AGGREGATOR;
+	}
+	throw std::logic_error("unknown endpoint owner");
+}
+
+// converts hwdb4cpp::NetworkEndpoints to an array of hwdb4c_network_endpoint
+int _convert_network_endpoints(
+    std::vector<hwdb4cpp::NetworkEndpoint> const& endpoints_cpp,
+    struct hwdb4c_network_endpoint** endpoints,
+    size_t* num_endpoints)
+{
+	*num_endpoints = endpoints_cpp.size();
+	*endpoints = (hwdb4c_network_endpoint*) malloc(
+	    sizeof(struct hwdb4c_network_endpoint) * *num_endpoints);
+	if (!*endpoints && *num_endpoints)
+		return HWDB4C_FAILURE;
+	for (size_t i = 0; i < *num_endpoints; i++) {
+		struct hwdb4c_network_endpoint* endpoint = &(*endpoints)[i];
+		inet_aton(endpoints_cpp[i].ip.to_string().c_str(), &(endpoint->ip));
+		endpoint->port = endpoints_cpp[i].port;
+		endpoint->owner = _convert_endpoint_owner(endpoints_cpp[i].owner);
+		endpoint->setup_id = endpoints_cpp[i].setup;
+		endpoint->index = endpoints_cpp[i].index;
+		endpoint->sub_index = endpoints_cpp[i].sub_index;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_find_endpoints(
+    struct hwdb4c_database_t* handle,
+    ip_addr_t ip,
+    struct hwdb4c_network_endpoint** endpoints,
+    size_t* num_endpoints)
+{
+	try {
+		return _convert_network_endpoints(
+		    handle->database.find_endpoints(_convert_ip(ip)), endpoints, num_endpoints);
+	} catch (const std::exception& e) {
+		return HWDB4C_FAILURE;
+	}
+}
+
+int hwdb4c_find_endpoints_with_port(
+    struct hwdb4c_database_t* handle,
+    ip_addr_t ip,
+    uint16_t port,
+    struct hwdb4c_network_endpoint** endpoints,
+    size_t* num_endpoints)
+{
+	try {
+		return _convert_network_endpoints(
+		    handle->database.find_endpoints(_convert_ip(ip), port), endpoints, num_endpoints);
+	} catch (const std::exception& e) {
+		return HWDB4C_FAILURE;
+	}
+}
+
+int hwdb4c_find_endpoints_in_subnet(
+    struct hwdb4c_database_t* handle,
+    ip_addr_t network,
+    size_t prefix_length,
+    struct hwdb4c_network_endpoint** endpoints,
+    size_t* num_endpoints)
+{
+	try {
+		return _convert_network_endpoints(
+		    handle->database.find_endpoints_in_subnet(_convert_ip(network), prefix_length),
+		    endpoints, num_endpoints);
+	} catch (const std::exception& e) {
+		return HWDB4C_FAILURE;
+	}
+}
+
+// converts hwdb4cpp::FPGALocation to hwdb4c_fpga_location
+int _convert_fpga_location(
+    std::optional<hwdb4cpp::FPGALocation> const& fpga_cpp, struct hwdb4c_fpga_location* ret)
+{
+	if (!fpga_cpp)
+		return HWDB4C_FAILURE;
+	switch (fpga_cpp->family) {
+		case hwdb4cpp::SetupFamily::hxcube:
+			ret->family = HWDB4C_HXCUBE_SETUP;
+			break;
+		case hwdb4cpp::SetupFamily::jboa:
+			ret->family = HWDB4C_JBOA_SETUP;
+			break;
+		default:
+			return HWDB4C_FAILURE;
+	}
+	ret->setup_id = fpga_cpp->setup_id;
+	ret->fpga_id = fpga_cpp->fpga_id;
+	return HWDB4C_SUCCESS;
+}
+
+int hwdb4c_find_fpga_by_fuse_dna(
+    struct hwdb4c_database_t* handle, uint64_t fuse_dna, struct hwdb4c_fpga_location* ret)
+{
+	try {
+		return _convert_fpga_location(handle->database.find_fpga_by_fuse_dna(fuse_dna), ret);
+	} catch (const std::exception& e) {
+		return HWDB4C_FAILURE;
+	}
+}
+
+int hwdb4c_find_fpga_by_dna_port(
+    struct hwdb4c_database_t* handle, uint64_t dna_port, struct hwdb4c_fpga_location* ret)
+{
+	try {
+		return _convert_fpga_location(handle->database.find_fpga_by_dna_port(dna_port), ret);
+	} catch (const std::exception& e) {
+		return HWDB4C_FAILURE;
+	}
+}
+
+void hwdb4c_dna_ports_from_fuse_dnas(uint64_t const* fuse_dnas, uint64_t* dna_ports, size_t num)
+{
+	std::transform(
+	    fuse_dnas, fuse_dnas + num, dna_ports, hwdb4cpp::HXCubeFPGAEntry::dna_port_from_fuse_dna);
+}
+
 int hwdb4c_get_adc_entries_of_Wafer(
     struct hwdb4c_database_t* handle,
     size_t wafer_id,
     struct hwdb4c_adc_entry*** adcs,
     size_t* num_adcs)
 {
-	std::map<hwdb4cpp::GlobalAnalog_t, hwdb4cpp::ADCEntry> adc_map;
+	hwdb4cpp::ADCEntryMap const* adc_view;
 	try {
-		adc_map = handle->database.get_adc_entries(Wafer(wafer_id));
+		adc_view = &handle->database.view_adc_entries(Wafer(wafer_id));
 	} catch (const std::out_of_range& oor) {
 		return HWDB4C_FAILURE;
 	}
+	hwdb4cpp::ADCEntryMap const& adc_map = *adc_view;
 	*num_adcs = adc_map.size();
 	*adcs = (hwdb4c_adc_entry**) malloc(sizeof(struct hwdb4c_adc_entry*) * *num_adcs);
 	if (!*adcs)
@@ -971,6 +1365,15 @@ void hwdb4c_free_hicann_entries(struct hwdb4c_hicann_entry** hicanns, size_t num
 	free(hicanns);
 }
 
+void hwdb4c_free_fpga_entries(struct hwdb4c_fpga_entry** fpgas, size_t num_fpgas)
+{
+	size_t fpgacounter;
+	for (fpgacounter = 0; fpgacounter < num_fpgas; fpgacounter++) {
+		hwdb4c_free_fpga_entry(fpgas[fpgacounter]);
+	}
+	free(fpgas);
+}
+
 void hwdb4c_free_adc_entries(struct hwdb4c_adc_entry** adcs, size_t num_adcs)
 {
 	size_t adccounter;
@@ -17,6 +17,14 @@ extern "C" {
 typedef struct in_addr ip_addr_t; // in network byte order
 typedef uint16_t udp_port_t;
 struct SYMBOL_VISIBLE hwdb4c_database_t;
+struct SYMBOL_VISIBLE hwdb4c_load_filter_t;
+
+enum hwdb4c_setup_family_t {
+	HWDB4C_WAFER,
+	HWDB4C_DLS_SETUP,
+	HWDB4C_HXCUBE_SETUP,
+	HWDB4C_JBOA_SETUP
+};
 
 struct SYMBOL_VISIBLE hwdb4c_fpga_entry {
 	//key
@@ -162,6 +170,38 @@ struct SYMBOL_VISIBLE hwdb4c_jboa_setup_entry
 	char* xilinx_hw_server;
 };
 
+enum hwdb4c_endpoint_owner_t {
+	HWDB4C_ENDPOINT_FPGA,
+	HWDB4C_ENDPOINT_ANANAS_DATA,
+	HWDB4C_ENDPOINT_ANANAS_RESET,
+	HWDB4C_ENDPOINT_ADC,
+	HWDB4C_ENDPOINT_MACU,
+	HWDB4C_ENDPOINT_HXCUBE_FPGA,
+	HWDB4C_ENDPOINT_JBOA_FPGA,
+	HWDB4C_ENDPOINT_JBOA_AGGREGATOR
+};
+
+// HX cube or jBOA FPGA, family is HWDB4C_HXCUBE_SETUP or HWDB4C_JBOA_SETUP
+struct SYMBOL_VISIBLE hwdb4c_fpga_location
+{
+	enum hwdb4c_setup_family_t family;
+	size_t setup_id;
+	size_t fpga_id;
+};
+
+// network address of an entry, see hwdb4cpp::NetworkEndpoint for the meaning of the ids
+struct SYMBOL_VISIBLE hwdb4c_network_endpoint
+{
+	ip_addr_t ip;
+	// UDP or TCP port, 0 for endpoints given by their address only
+	uint16_t port;
+	enum hwdb4c_endpoint_owner_t owner;
+	// wafer_id, hxcube_id or jboa_id
+	size_t setup_id;
+	size_t index;
+	size_t sub_index;
+};
+
 
 // functions to allocate cpp hwdb object
 int hwdb4c_alloc_hwdb(struct hwdb4c_database_t** ret) SYMBOL_VISIBLE;
@@ -174,6 +214,40 @@ void hwdb4c_clear_hwdb(struct hwdb4c_database_t* handle) SYMBOL_VISIBLE;
 // free HWDB handle
 void hwdb4c_free_hwdb(struct hwdb4c_database_t* ret) SYMBOL_VISIBLE;
 
+// functions to allocate load filter, an empty filter selects all setups
+int hwdb4c_alloc_load_filter(struct hwdb4c_load_filter_t** ret) SYMBOL_VISIBLE;
+// select all setups of a family
+int hwdb4c_load_filter_add_family(struct hwdb4c_load_filter_t* filter, enum hwdb4c_setup_family_t family)
+	SYMBOL_VISIBLE;
+// select a single wafer, hxcube or jboa setup
+int hwdb4c_load_filter_add_id(
+	struct hwdb4c_load_filter_t* filter, enum hwdb4c_setup_family_t family, size_t id) SYMBOL_VISIBLE;
+// select a single DLS setup
+int hwdb4c_load_filter_add_dls_setup(struct hwdb4c_load_filter_t* filter, char const* dls_setup)
+	SYMBOL_VISIBLE;
+// free load filter
+void hwdb4c_free_load_filter(struct hwdb4c_load_filter_t* filter) SYMBOL_VISIBLE;
+// load only the setups selected by filter, either from path or if path is NULL from default hwdb path
+int hwdb4c_load_hwdb_filtered(
+	struct hwdb4c_database_t* handle,
+	char const* hwdb_path,
+	struct hwdb4c_load_filter_t const* filter) SYMBOL_VISIBLE;
+// load database from YAML contents of size bytes in buffer
+int hwdb4c_load_hwdb_from_buffer(
+	struct hwdb4c_database_t* handle, char const* buffer, size_t size) SYMBOL_VISIBLE;
+// load database from open file descriptor until its end, fd is not closed
+int hwdb4c_load_hwdb_from_fd(struct hwdb4c_database_t* handle, int fd) SYMBOL_VISIBLE;
+// load database compiled into the hwdb4cpp_embedded library at build time, no file is read,
+// only available in the hwdb4c_embedded library built with --hwdb-embedded-yaml
+int hwdb4c_load_embedded(struct hwdb4c_database_t* handle) SYMBOL_VISIBLE;
+// start loading database from path (or default hwdb path if NULL) in the background,
+// the handle must not be used except for poll and wait until the load has finished
+int hwdb4c_load_hwdb_async(struct hwdb4c_database_t* handle, char const* hwdb_path) SYMBOL_VISIBLE;
+// check without blocking if a background load has finished, true if none is pending
+int hwdb4c_load_hwdb_poll(struct hwdb4c_database_t* handle, bool* done) SYMBOL_VISIBLE;
+// wait for a background load to finish and return its result, success if none is pending
+int hwdb4c_load_hwdb_wait(struct hwdb4c_database_t* handle) SYMBOL_VISIBLE;
+
 // return matching yaml entries for query
 char* hwdb4c_get_yaml_entries(char const* hwdb_path, char const* node, char const* query)
 	SYMBOL_VISIBLE;
@@ -222,6 +296,41 @@ int hwdb4c_get_adc_entries_of_Wafer(struct hwdb4c_database_t* handle, size_t waf
 int hwdb4c_get_adc_entries_of_FPGAGlobal(struct hwdb4c_database_t* handle, size_t fpgaglobal_id, struct hwdb4c_adc_entry*** adcs, size_t* num_adcs) SYMBOL_VISIBLE;
 int hwdb4c_get_hicann_entries_of_Wafer(struct hwdb4c_database_t* handle, size_t wafer_id, struct hwdb4c_hicann_entry*** hicanns, size_t* num_hicanns) SYMBOL_VISIBLE;
 int hwdb4c_get_hicann_entries_of_FPGAGlobal(struct hwdb4c_database_t* handle, size_t fpgaglobal_id, struct hwdb4c_hicann_entry*** hicanns, size_t* num_hicanns) SYMBOL_VISIBLE;
+int hwdb4c_get_hicann_entries_of_DNCGlobal(struct hwdb4c_database_t* handle, size_t reticleglobal_id, struct hwdb4c_hicann_entry*** hicanns, size_t* num_hicanns) SYMBOL_VISIBLE;
+int hwdb4c_get_fpga_entries_of_Wafer(struct hwdb4c_database_t* handle, size_t wafer_id, struct hwdb4c_fpga_entry*** fpgas, size_t* num_fpgas) SYMBOL_VISIBLE;
+
+// reverse lookup of the entries using an address, a subnet is given by its network address and prefix length
+// returns an array of size num_endpoints, ownership of array lies with user
+int hwdb4c_find_endpoints(
+	struct hwdb4c_database_t* handle,
+	ip_addr_t ip,
+	struct hwdb4c_network_endpoint** endpoints,
+	size_t* num_endpoints) SYMBOL_VISIBLE;
+int hwdb4c_find_endpoints_with_port(
+	struct hwdb4c_database_t* handle,
+	ip_addr_t ip,
+	uint16_t port,
+	struct hwdb4c_network_endpoint** endpoints,
+	size_t* num_endpoints) SYMBOL_VISIBLE;
+int hwdb4c_find_endpoints_in_subnet(
+	struct hwdb4c_database_t* handle,
+	ip_addr_t network,
+	size_t prefix_length,
+	struct hwdb4c_network_endpoint** endpoints,
+	size_t* num_endpoints) SYMBOL_VISIBLE;
+
+// lookup of the HX cube or jBOA FPGA by its FUSE_DNA or DNA_PORT, returns HWDB4C_FAILURE if there is none
+int hwdb4c_find_fpga_by_fuse_dna(
+	struct hwdb4c_database_t* handle,
+	uint64_t fuse_dna,
+	struct hwdb4c_fpga_location* ret) SYMBOL_VISIBLE;
+int hwdb4c_find_fpga_by_dna_port(
+	struct hwdb4c_database_t* handle,
+	uint64_t dna_port,
+	struct hwdb4c_fpga_location* ret) SYMBOL_VISIBLE;
+// DNA_PORT values of num FUSE_DNA values, same as dna_port of hwdb4c_hxcube_fpga_entry
+void hwdb4c_dna_ports_from_fuse_dnas(uint64_t const* fuse_dnas, uint64_t* dna_ports, size_t num)
+	SYMBOL_VISIBLE;
 
 // free memory of an entry
 void hwdb4c_free_fpga_entry(struct hwdb4c_fpga_entry* fpga) SYMBOL_VISIBLE;
@@ -232,6 +341,7 @@ void hwdb4c_free_adc_entry(struct hwdb4c_adc_entry* adc) SYMBOL_VISIBLE;
 void hwdb4c_free_wafer_entry(struct hwdb4c_wafer_entry* wafer) SYMBOL_VISIBLE;
 void hwdb4c_free_dls_setup_entry(struct hwdb4c_dls_setup_entry* dls_setup) SYMBOL_VISIBLE;
 void hwdb4c_free_hicann_entries(struct hwdb4c_hicann_entry** hicanns, size_t num_hicanns) SYMBOL_VISIBLE;
+void hwdb4c_free_fpga_entries(struct hwdb4c_fpga_entry** fpgas, size_t num_fpgas) SYMBOL_VISIBLE;
 void hwdb4c_free_adc_entries(struct hwdb4c_adc_entry** adcs, size_t num_adcs) SYMBOL_VISIBLE;
 void hwdb4c_free_hxcube_setup_entry(struct hwdb4c_hxcube_setup_entry* setup) SYMBOL_VISIBLE;
 void hwdb4c_free_hxcube_fpga_entry(struct hwdb4c_hxcube_fpga_entry* fpga) SYMBOL_VISIBLE;
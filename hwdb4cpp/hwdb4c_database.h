@@ -0,0 +1,14 @@
+#pragma once
+
+#include "hwdb4cpp.h"
+
+#include <future>
+
+/// Opaque handle of the C interface, shared by hwdb4c and hwdb4c_embedded
+struct hwdb4c_database_t
+{
+	hwdb4cpp::database database;
+	// background load started by hwdb4c_load_hwdb_async, declared last to be
+	// waited for before the database is destroyed
+	std::future<void> pending_load;
+};
@@ -0,0 +1,16 @@
+#include "hwdb4c.h"
+#include "hwdb4c_database.h"
+
+extern "C" {
+
+int hwdb4c_load_embedded(struct hwdb4c_database_t* handle)
+{
+	try {
+		handle->database.load_embedded();
+	} catch (const std::exception&) {
+		return HWDB4C_FAILURE;
+	}
+	return HWDB4C_SUCCESS;
+}
+
+} // extern "C"
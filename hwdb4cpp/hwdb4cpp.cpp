@@ -1,20 +1,45 @@
 #include "hwdb4cpp.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
-#include <regex>
+#include <charconv>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include <dirent.h>
+#include <sys/stat.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/asio/ip/address.hpp>
 #include <boost/make_shared.hpp>
 #include <log4cxx/logger.h>
+#include <yaml-cpp/eventhandler.h>
 #include <yaml-cpp/yaml.h>
 
 #include "halco/common/iter_all.h"
 #include "hate/type_index.h"
+#include "indexes.h"
+#include "mapped_file.h"
 
 std::string const hwdb4cpp::database::default_path = "/wang/data/bss-hwdb/db.yaml";
 
@@ -44,6 +69,8 @@ struct FPGAYAML : public FPGAEntry
 	FPGAYAML() {}
 	FPGAYAML(FPGAEntry const& base) : FPGAEntry(base) {}
 	size_t coordinate = 0;
+	/// number of items of a range entry, starting at coordinate
+	size_t count = 1;
 };
 
 struct ReticleYAML : public ReticleEntry
@@ -51,6 +78,7 @@ struct ReticleYAML : public ReticleEntry
 	ReticleYAML() {}
 	ReticleYAML(ReticleEntry const& base) : ReticleEntry(base) {}
 	size_t coordinate = 0;
+	size_t count = 1;
 };
 
 struct AnanasYAML : public AnanasEntry
@@ -72,6 +100,7 @@ struct HXFPGAYAML : public HXCubeFPGAEntry
 	HXFPGAYAML() {}
 	HXFPGAYAML(HXCubeFPGAEntry const& base) : HXCubeFPGAEntry(base) {}
 	size_t coordinate = 0;
+	size_t count = 1;
 };
 
 struct JboaAggregatorYAML : public JboaAggregatorEntry
@@ -81,6 +110,189 @@ struct JboaAggregatorYAML : public JboaAggregatorEntry
 	size_t coordinate = 0;
 };
 
+/// Compile-time perfect hash over the keys of an entry mapping.
+/// The decoders iterate a mapping once and dispatch on the index of each key,
+/// `case fields["key"]:` fails to compile for keys not in the table.
+template <size_t N>
+class FieldTable
+{
+public:
+	static constexpr size_t size = N;
+
+	constexpr FieldTable(std::string_view const (&keys)[N]) : m_keys(), m_slots(), m_seed(0)
+	{
+		for (size_t i = 0; i < N; ++i) {
+			m_keys[i] = keys[i];
+		}
+		// search seed for which all keys hash to different slots
+		for (bool collision = true; collision; ++m_seed) {
+			collision = false;
+			for (auto& slot : m_slots) {
+				slot = 0;
+			}
+			for (size_t i = 0; i < N && !collision; ++i) {
+				size_t const slot = hash(m_keys[i], m_seed) % num_slots;
+				collision = m_slots[slot] != 0;
+				m_slots[slot] = i + 1;
+			}
+		}
+		--m_seed;
+	}
+
+	/// Index of key, size if key is unknown
+	constexpr size_t find(std::string_view const key) const
+	{
+		size_t const index = m_slots[hash(key, m_seed) % num_slots];
+		return (index != 0 && m_keys[index - 1] == key) ? index - 1 : N;
+	}
+
+	/// Index of a known key
+	constexpr size_t operator[](std::string_view const key) const
+	{
+		size_t const index = find(key);
+		if (index == N) {
+			throw std::logic_error("unknown field");
+		}
+		return index;
+	}
+
+	constexpr std::string_view key(size_t const index) const { return m_keys[index]; }
+
+private:
+	static constexpr size_t num_slots = 2 * N + 1;
+
+	static constexpr uint32_t hash(std::string_view const key, uint32_t const seed)
+	{
+		uint32_t value = 2166136261u ^ seed;
+		for (char const c : key) {
+			value ^= static_cast<unsigned char>(c);
+			value *= 16777619u;
+		}
+		return value ^ (value >> 15);
+	}
+
+	std::array<std::string_view, N> m_keys;
+	std::array<size_t, num_slots> m_slots;
+	uint32_t m_seed;
+};
+
+/// dnc_on_fpga is accepted for old facets systems but not used
+constexpr FieldTable<8> adc_fields(
+    {"adc", "channel", "trigger", "analog", "fpga", "remote_ip", "remote_port", "dnc_on_fpga"});
+constexpr FieldTable<3> fpga_fields({"fpga", "ip", "highspeed"});
+constexpr FieldTable<9> hxfpga_fields(
+    {"fpga", "ip", "fuse_dna", "ci_test_node", "handwritten_chip_serial", "chip_revision",
+      "eeprom_chip_serial", "synram_timing_pcconf", "synram_timing_wconf"});
+constexpr FieldTable<3> aggregator_fields({"aggregator", "ip", "ci_test_node"});
+constexpr FieldTable<2> reticle_fields({"reticle", "to_be_powered"});
+constexpr FieldTable<4> ananas_fields({"ananas", "ip", "baseport_data", "baseport_reset"});
+constexpr FieldTable<3> hicann_fields({"hicann", "version", "label"});
+
+/// Fields found in an entry mapping
+template <size_t N>
+using FieldSet = std::bitset<N>;
+
+/// Parse coordinate range "first-last" of a sequence entry (decimal only) with
+/// coordinates below size, returns false if value is no range
+bool parse_range(std::string_view const value, size_t const size, size_t& first, size_t& count)
+{
+	size_t const dash = value.find('-');
+	if (dash == std::string_view::npos) {
+		return false;
+	}
+	auto const parse = [](std::string_view const part, size_t& result) {
+		char const* const end = part.data() + part.size();
+		auto const [ptr, ec] = std::from_chars(part.data(), end, result);
+		return !part.empty() && ec == std::errc() && ptr == end;
+	};
+	size_t last = 0;
+	if (!parse(value.substr(0, dash), first) || !parse(value.substr(dash + 1), last) ||
+	    last < first || last >= size) {
+		throw std::runtime_error("invalid coordinate range '" + std::string(value) + "'");
+	}
+	count = last - first + 1;
+	return true;
+}
+
+std::string format_range(size_t const first, size_t const count)
+{
+	return std::to_string(first) + "-" + std::to_string(first + count - 1);
+}
+
+/// Address offset positions after ip, range entries have consecutive addresses
+IPv4 ip_offset(IPv4 const& ip, size_t const offset)
+{
+	uint64_t const value = ((uint64_t(ip[0]) << 24) | (uint64_t(ip[1]) << 16) |
+	                        (uint64_t(ip[2]) << 8) | uint64_t(ip[3])) +
+	                       offset;
+	if (value > std::numeric_limits<uint32_t>::max()) {
+		throw std::runtime_error("ip range exceeds address space: " + ip.to_string());
+	}
+	IPv4 ret;
+	for (size_t i = 0; i < 4; ++i) {
+		ret[i] = static_cast<uint8_t>(value >> (24 - 8 * i));
+	}
+	return ret;
+}
+
+// Single items of range entries
+
+FPGAYAML range_item(FPGAYAML item, size_t const offset)
+{
+	item.coordinate += offset;
+	item.ip = ip_offset(item.ip, offset);
+	item.count = 1;
+	return item;
+}
+
+ReticleYAML range_item(ReticleYAML item, size_t const offset)
+{
+	item.coordinate += offset;
+	item.count = 1;
+	return item;
+}
+
+HXFPGAYAML range_item(HXFPGAYAML item, size_t const offset)
+{
+	item.coordinate += offset;
+	item.ip = ip_offset(item.ip, offset);
+	item.count = 1;
+	return item;
+}
+
+// Check if item continues range with the same settings, used to write ranges on dump
+
+bool continues_range(FPGAYAML const& range, FPGAYAML const& item)
+{
+	return item.coordinate == range.coordinate + range.count &&
+	       item.ip == ip_offset(range.ip, range.count) && item.highspeed == range.highspeed;
+}
+
+bool continues_range(ReticleYAML const& range, ReticleYAML const& item)
+{
+	return item.coordinate == range.coordinate + range.count &&
+	       item.to_be_powered == range.to_be_powered;
+}
+
+bool continues_range(HXFPGAYAML const& range, HXFPGAYAML const& item)
+{
+	return item.coordinate == range.coordinate + range.count &&
+	       item.ip == ip_offset(range.ip, range.count) &&
+	       item.ci_test_node == range.ci_test_node && !range.fuse_dna && !range.wing &&
+	       !item.fuse_dna && !item.wing;
+}
+
+/// Append item to sequence entries, merging it into the last range if possible
+template <typename T>
+void append_range_item(std::vector<T>& data, T const& item)
+{
+	if (!data.empty() && continues_range(data.back(), item)) {
+		++data.back().count;
+	} else {
+		data.push_back(item);
+	}
+}
+
 } // anonymous namespace
 
 // Converter for our YAML entries
@@ -120,6 +332,68 @@ T get_entry(const Node& node, const std::string name, const T default_value)
 	}
 }
 
+// Call f(index, value) for each entry of mapping node in a single pass, unknown
+// and repeated keys are rejected
+template <size_t N, typename F>
+FieldSet<N> for_each_field(const Node& node, FieldTable<N> const& fields, F&& f)
+{
+	FieldSet<N> found;
+	for (auto const& item : node) {
+		std::string const& key = item.first.Scalar();
+		size_t const index = fields.find(key);
+		if (index == N) {
+			throw RepresentationException(item.first.Mark(), "unknown key '" + key + "'");
+		} else if (found[index]) {
+			throw RepresentationException(item.first.Mark(), "duplicate key '" + key + "'");
+		}
+		found.set(index);
+		try {
+			f(index, item.second);
+		} catch (const YAML::Exception& err) {
+			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+			LOG4CXX_ERROR(
+			    logger, "Error converting key '" << key << "' of node YAML'" << node
+			                                     << "': " << err.what());
+			throw;
+		}
+	}
+	return found;
+}
+
+// Throw if one of the required keys was not found
+template <size_t N>
+void require_fields(
+    const Node& node,
+    FieldTable<N> const& fields,
+    FieldSet<N> const& found,
+    std::initializer_list<size_t> const required)
+{
+	for (size_t const index : required) {
+		if (!found[index]) {
+			throw KeyNotFound(node.Mark(), std::string(fields.key(index)));
+		}
+	}
+}
+
+// Decode single coordinate or range "first-last" of a sequence entry, coordinates of
+// ranges have to be below size
+void decode_coordinate(const Node& node, size_t const size, size_t& first, size_t& count)
+{
+	count = 1;
+	if (!node.IsScalar() || !parse_range(node.Scalar(), size, first, count)) {
+		first = node.as<size_t>();
+	}
+}
+
+void encode_coordinate(Node node, size_t const first, size_t const count)
+{
+	if (count > 1) {
+		node = format_range(first, count);
+	} else {
+		node = first;
+	}
+}
+
 } // anonymous namespace
 
 template <>
@@ -183,18 +457,44 @@ struct convert<ADCYAML>
 
 	static bool decode(const Node& node, ADCYAML& data)
 	{
-		if (!node.IsMap() || node.size() > 8) {
+		if (!node.IsMap()) {
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
 		}
-		data.coord = get_entry<std::string>(node, "adc");
-		data.channel = ChannelOnADC(get_entry<size_t>(node, "channel"));
-		data.trigger = TriggerOnADC(get_entry<size_t>(node, "trigger"));
-		data.analog = get_entry<size_t>(node, "analog");
-		data.fpga = get_entry<size_t>(node, "fpga");
-		data.remote_ip = get_entry<IPv4>(node, "remote_ip", IPv4());
-		data.remote_port = TCPPort(get_entry<size_t>(node, "remote_port", 0));
+		auto const& fields = adc_fields;
+		data.remote_ip = IPv4();
+		data.remote_port = TCPPort(0);
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["adc"]:
+					data.coord = value.as<std::string>();
+					break;
+				case fields["channel"]:
+					data.channel = ChannelOnADC(value.as<size_t>());
+					break;
+				case fields["trigger"]:
+					data.trigger = TriggerOnADC(value.as<size_t>());
+					break;
+				case fields["analog"]:
+					data.analog = value.as<size_t>();
+					break;
+				case fields["fpga"]:
+					data.fpga = value.as<size_t>();
+					break;
+				case fields["remote_ip"]:
+					data.remote_ip = value.as<IPv4>();
+					break;
+				case fields["remote_port"]:
+					data.remote_port = TCPPort(value.as<size_t>());
+					break;
+				case fields["dnc_on_fpga"]:
+					break;
+			}
+		});
+		require_fields(
+		    node, fields, found,
+		    {fields["adc"], fields["channel"], fields["trigger"], fields["analog"], fields["fpga"]});
 		return true;
 	}
 };
@@ -205,7 +505,7 @@ struct convert<FPGAYAML>
 	static Node encode(const FPGAYAML& data)
 	{
 		Node node;
-		node["fpga"] = data.coordinate;
+		encode_coordinate(node["fpga"], data.coordinate, data.count);
 		node["ip"] = data.ip.to_string();
 		if (data.highspeed == false) {
 			node["highspeed"] = data.highspeed;
@@ -215,14 +515,27 @@ struct convert<FPGAYAML>
 
 	static bool decode(const Node& node, FPGAYAML& data)
 	{
-		if (!node.IsMap() || node.size() > 3) {
+		if (!node.IsMap()) {
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
 		}
-		data.coordinate = get_entry<size_t>(node, "fpga");
-		data.ip = IPv4::from_string(get_entry<std::string>(node, "ip"));
-		data.highspeed = get_entry<bool>(node, "highspeed", true);
+		auto const& fields = fpga_fields;
+		data.highspeed = true;
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["fpga"]:
+					decode_coordinate(value, FPGAOnWafer::size, data.coordinate, data.count);
+					break;
+				case fields["ip"]:
+					data.ip = IPv4::from_string(value.as<std::string>());
+					break;
+				case fields["highspeed"]:
+					data.highspeed = value.as<bool>();
+					break;
+			}
+		});
+		require_fields(node, fields, found, {fields["fpga"], fields["ip"]});
 		return true;
 	}
 };
@@ -233,7 +546,7 @@ struct convert<HXFPGAYAML>
 	static Node encode(const HXFPGAYAML& data)
 	{
 		Node node;
-		node["fpga"] = data.coordinate;
+		encode_coordinate(node["fpga"], data.coordinate, data.count);
 		node["ip"] = data.ip.to_string();
 		if (data.fuse_dna) {
 			node["fuse_dna"] = data.fuse_dna.value();
@@ -263,25 +576,49 @@ struct convert<HXFPGAYAML>
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
-		} else if (node.size() > 11) {
-			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
-			LOG4CXX_ERROR(logger, "Too many entries! Decoding failed of: '''\n" << node << "'''");
-			return false;
 		}
-		data.coordinate = get_entry<size_t>(node, "fpga");
-		data.ip = IPv4::from_string(get_entry<std::string>(node, "ip"));
-		auto fuse_dna = node["fuse_dna"];
-		if (fuse_dna.IsDefined()) {
-			data.fuse_dna = fuse_dna.as<uint64_t>();
-		}
-		data.ci_test_node = get_entry<bool>(node, "ci_test_node", false);
-		auto hand_serial = node["handwritten_chip_serial"];
-		auto chip_rev = node["chip_revision"];
-		auto eeprom = node["eeprom_chip_serial"];
-		auto synram_timing_pcconf = node["synram_timing_pcconf"];
-		auto synram_timing_wconf = node["synram_timing_wconf"];
-		if (hand_serial.IsDefined() || chip_rev.IsDefined()) {
-			if (!hand_serial.IsDefined() || !chip_rev.IsDefined()) {
+		auto const& fields = hxfpga_fields;
+		data.fuse_dna.reset();
+		data.ci_test_node = false;
+		data.wing.reset();
+		HXCubeWingEntry wing;
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["fpga"]:
+					decode_coordinate(
+					    value, std::numeric_limits<size_t>::max(), data.coordinate, data.count);
+					break;
+				case fields["ip"]:
+					data.ip = IPv4::from_string(value.as<std::string>());
+					break;
+				case fields["fuse_dna"]:
+					data.fuse_dna = value.as<uint64_t>();
+					break;
+				case fields["ci_test_node"]:
+					data.ci_test_node = value.as<bool>();
+					break;
+				case fields["handwritten_chip_serial"]:
+					wing.handwritten_chip_serial = value.as<size_t>();
+					break;
+				case fields["chip_revision"]:
+					wing.chip_revision = value.as<size_t>();
+					break;
+				case fields["eeprom_chip_serial"]:
+					wing.eeprom_chip_serial = value.as<size_t>();
+					break;
+				case fields["synram_timing_pcconf"]:
+					wing.synram_timing_pcconf = value.as<std::array<std::array<uint16_t, 2>, 2>>();
+					break;
+				case fields["synram_timing_wconf"]:
+					wing.synram_timing_wconf = value.as<std::array<std::array<uint16_t, 2>, 2>>();
+					break;
+			}
+		});
+		require_fields(node, fields, found, {fields["fpga"], fields["ip"]});
+		bool const hand_serial = found[fields["handwritten_chip_serial"]];
+		bool const chip_rev = found[fields["chip_revision"]];
+		if (hand_serial || chip_rev) {
+			if (!hand_serial || !chip_rev) {
 				log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 				LOG4CXX_ERROR(
 				    logger, "Decoding failed. Hand serial and chip revision need to be "
@@ -289,31 +626,25 @@ struct convert<HXFPGAYAML>
 				                << node << "'''");
 				return false;
 			}
-			HXCubeWingEntry wing;
-			wing.handwritten_chip_serial = get_entry<size_t>(node, "handwritten_chip_serial");
-			wing.chip_revision = get_entry<size_t>(node, "chip_revision");
-			if (eeprom.IsDefined()) {
-				wing.eeprom_chip_serial = get_entry<size_t>(node, "eeprom_chip_serial");
-			}
-			if (synram_timing_pcconf.IsDefined()) {
-				wing.synram_timing_pcconf =
-				    get_entry<std::array<std::array<uint16_t, 2>, 2>>(node, "synram_timing_pcconf");
-			}
-			if (synram_timing_wconf.IsDefined()) {
-				wing.synram_timing_wconf =
-				    get_entry<std::array<std::array<uint16_t, 2>, 2>>(node, "synram_timing_wconf");
-			}
 			data.wing = wing;
-		} else {
-			if (eeprom.IsDefined() || synram_timing_pcconf.IsDefined() ||
-			    synram_timing_wconf.IsDefined()) {
-				log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
-				LOG4CXX_ERROR(
-				    logger, "Decoding failed. Only optional entries found. Node: '''\n"
-				                << node << "'''");
-				return false;
-			}
+		} else if (
+		    found[fields["eeprom_chip_serial"]] || found[fields["synram_timing_pcconf"]] ||
+		    found[fields["synram_timing_wconf"]]) {
+			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+			LOG4CXX_ERROR(
+			    logger, "Decoding failed. Only optional entries found. Node: '''\n"
+			                << node << "'''");
+			return false;
+		}
+		if (data.count > 1 && (data.fuse_dna || data.wing)) {
+			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+			LOG4CXX_ERROR(
+			    logger, "Decoding failed. FPGA ranges cannot have per FPGA entries. Node: '''\n"
+			                << node << "'''");
+			return false;
 		}
+		// consecutive addresses of all FPGAs of a range have to exist
+		ip_offset(data.ip, data.count - 1);
 		return true;
 	}
 };
@@ -338,14 +669,23 @@ struct convert<JboaAggregatorYAML>
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
-		} else if (node.size() > 3) {
-			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
-			LOG4CXX_ERROR(logger, "Too many entries! Decoding failed of: '''\n" << node << "'''");
-			return false;
 		}
-		data.coordinate = get_entry<size_t>(node, "aggregator");
-		data.ip = IPv4::from_string(get_entry<std::string>(node, "ip"));
-		data.ci_test_node = get_entry<bool>(node, "ci_test_node", false);
+		auto const& fields = aggregator_fields;
+		data.ci_test_node = false;
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["aggregator"]:
+					data.coordinate = value.as<size_t>();
+					break;
+				case fields["ip"]:
+					data.ip = IPv4::from_string(value.as<std::string>());
+					break;
+				case fields["ci_test_node"]:
+					data.ci_test_node = value.as<bool>();
+					break;
+			}
+		});
+		require_fields(node, fields, found, {fields["aggregator"], fields["ip"]});
 		return true;
 	}
 };
@@ -356,7 +696,7 @@ struct convert<ReticleYAML>
 	static Node encode(const ReticleYAML& data)
 	{
 		Node node;
-		node["reticle"] = data.coordinate;
+		encode_coordinate(node["reticle"], data.coordinate, data.count);
 		if (data.to_be_powered == false) {
 			node["to_be_powered"] = data.to_be_powered;
 		}
@@ -365,13 +705,24 @@ struct convert<ReticleYAML>
 
 	static bool decode(const Node& node, ReticleYAML& data)
 	{
-		if (!node.IsMap() || node.size() > 2) {
+		if (!node.IsMap()) {
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
 		}
-		data.coordinate = get_entry<size_t>(node, "reticle");
-		data.to_be_powered = get_entry<bool>(node, "to_be_powered", true);
+		auto const& fields = reticle_fields;
+		data.to_be_powered = true;
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["reticle"]:
+					decode_coordinate(value, DNCOnWafer::size, data.coordinate, data.count);
+					break;
+				case fields["to_be_powered"]:
+					data.to_be_powered = value.as<bool>();
+					break;
+			}
+		});
+		require_fields(node, fields, found, {fields["reticle"]});
 		return true;
 	}
 };
@@ -391,15 +742,31 @@ struct convert<AnanasYAML>
 
 	static bool decode(const Node& node, AnanasYAML& data)
 	{
-		if (!node.IsMap() || node.size() > 4) {
+		if (!node.IsMap()) {
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
 		}
-		data.coordinate = get_entry<size_t>(node, "ananas");
-		data.ip = IPv4::from_string(get_entry<std::string>(node, "ip"));
-		data.baseport_data = halco::hicann::v2::UDPPort(get_entry<size_t>(node, "baseport_data"));
-		data.baseport_reset = halco::hicann::v2::UDPPort(get_entry<size_t>(node, "baseport_reset"));
+		auto const& fields = ananas_fields;
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["ananas"]:
+					data.coordinate = value.as<size_t>();
+					break;
+				case fields["ip"]:
+					data.ip = IPv4::from_string(value.as<std::string>());
+					break;
+				case fields["baseport_data"]:
+					data.baseport_data = halco::hicann::v2::UDPPort(value.as<size_t>());
+					break;
+				case fields["baseport_reset"]:
+					data.baseport_reset = halco::hicann::v2::UDPPort(value.as<size_t>());
+					break;
+			}
+		});
+		require_fields(
+		    node, fields, found,
+		    {fields["ananas"], fields["ip"], fields["baseport_data"], fields["baseport_reset"]});
 		return true;
 	}
 };
@@ -420,14 +787,28 @@ struct convert<HICANNYAML>
 
 	static bool decode(const Node& node, HICANNYAML& data)
 	{
-		if (!node.IsMap() || node.size() > 3) {
+		if (!node.IsMap()) {
 			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
 			LOG4CXX_ERROR(logger, "Decoding failed of: '''\n" << node << "'''");
 			return false;
 		}
-		data.coordinate = get_entry<size_t>(node, "hicann", 0);
-		data.version = get_entry<size_t>(node, "version");
-		data.label = get_entry<std::string>(node, "label", "");
+		auto const& fields = hicann_fields;
+		data.coordinate = 0;
+		data.label.clear();
+		auto const found = for_each_field(node, fields, [&](size_t const field, const Node& value) {
+			switch (field) {
+				case fields["hicann"]:
+					data.coordinate = value.as<size_t>();
+					break;
+				case fields["version"]:
+					data.version = value.as<size_t>();
+					break;
+				case fields["label"]:
+					data.label = value.as<std::string>();
+					break;
+			}
+		});
+		require_fields(node, fields, found, {fields["version"]});
 		return true;
 	}
 };
@@ -437,276 +818,2481 @@ struct convert<HICANNYAML>
 
 namespace hwdb4cpp {
 
-uint64_t HXCubeFPGAEntry::get_dna_port() const
+bool WaferEntry::has_hicann(HICANNGlobal const hicann) const
 {
-	auto dna = std::bitset<64>(fuse_dna.value());
+	return find_hicann(hicann) != nullptr;
+}
 
-	// see Xilinx UG470 (v1.13.1) Table 5-16
-	std::bitset<57> dna_port;
-	for (size_t i = 0; i < 57; ++i) {
-		dna_port[i] = dna[63 - i];
+HICANNEntry const* WaferEntry::find_hicann(HICANNGlobal const hicann) const
+{
+	if (HICANNEntry const* const entry = find_shared_hicann_entry(hicann.toFPGAGlobal())) {
+		return entry;
 	}
-
-	return dna_port.to_ullong();
+	auto const it = mHICANNs.find(hicann);
+	return it == mHICANNs.end() ? nullptr : &it->second;
 }
 
-std::string HXCubeSetupEntry::get_unique_branch_identifier(size_t chip_serial) const
+HICANNEntry const& WaferEntry::get_hicann(HICANNGlobal const hicann) const
 {
-	using namespace std::string_literals;
-	for (auto fpga : fpgas) {
-		if (!fpga.second.wing) {
-			continue;
-		}
-		if ((fpga.second.wing.value().handwritten_chip_serial == chip_serial) ||
-		    (fpga.second.wing.value().eeprom_chip_serial == chip_serial)) {
-			return "hxcube"s + std::to_string(hxcube_id) + "fpga"s + std::to_string(fpga.first) +
-			       "chip"s + std::to_string(fpga.second.wing.value().handwritten_chip_serial) +
-			       "_"s + std::to_string(1) /* not yet in hwdb: Issue #3641 */;
-		}
+	HICANNEntry const* const entry = find_hicann(hicann);
+	if (!entry) {
+		throw std::out_of_range("HICANN not available");
 	}
-	throw std::runtime_error("No chip with serial " + std::to_string(chip_serial) + " found");
+	return *entry;
 }
 
-std::tuple<size_t, size_t, size_t, size_t> HXCubeSetupEntry::get_ids_from_unique_branch_identifier(
-    std::string identifier)
+HICANNEntryMap WaferEntry::get_hicanns() const
 {
-	std::regex regex("hxcube(\\d+)fpga(\\d+)chip(\\d+)_(\\d+)");
-	std::smatch match;
-	if (std::regex_match(identifier, match, regex)) {
-		assert(match.size() == 5);
-		return {std::stoi(match[1]), std::stoi(match[2]), std::stoi(match[3]), std::stoi(match[4])};
+	if (mSharedHICANNs.none()) {
+		return mHICANNs;
 	}
-	throw std::runtime_error("Found no match for hxcube ID in identifier.");
+	HICANNEntryMap ret;
+	for_each_hicann([&ret](HICANNGlobal const hicann, HICANNEntry const& entry) { ret[hicann] = entry; });
+	return ret;
 }
 
-std::string JboaSetupEntry::get_unique_branch_identifier(size_t chip_serial) const
+HICANNEntryMap WaferEntry::get_hicanns(DNCGlobal const reticle) const
 {
-	using namespace std::string_literals;
-	for (auto fpga : fpgas) {
-		if (!fpga.second.wing) {
-			continue;
-		}
-		if ((fpga.second.wing.value().handwritten_chip_serial == chip_serial) ||
-		    (fpga.second.wing.value().eeprom_chip_serial == chip_serial)) {
-			return "jboa"s + std::to_string(jboa_id) + "fpga"s + std::to_string(fpga.first) +
-			       "chip"s + std::to_string(fpga.second.wing.value().handwritten_chip_serial) +
-			       "_"s + std::to_string(1) /* not yet in hwdb: Issue #3641 */;
+	HICANNEntryMap ret;
+	DNCOnWafer const dnc = reticle.toDNCOnWafer();
+	for (auto hicann : iter_all<HICANNOnDNC>()) {
+		HICANNGlobal const hicannglobal(hicann.toHICANNOnWafer(dnc), reticle.toWafer());
+		if (HICANNEntry const* const entry = find_hicann(hicannglobal)) {
+			ret.emplace(hicannglobal, *entry);
 		}
 	}
-	throw std::runtime_error("No chip with serial " + std::to_string(chip_serial) + " found");
+	return ret;
 }
 
-std::tuple<size_t, size_t, size_t, size_t> JboaSetupEntry::get_ids_from_unique_branch_identifier(
-    std::string identifier)
+ADCEntryMap WaferEntry::get_adcs(FPGAGlobal const fpga) const
 {
-	std::regex regex("jboa(\\d+)fpga(\\d+)chip(\\d+)_(\\d+)");
-	std::smatch match;
-	if (std::regex_match(identifier, match, regex)) {
-		assert(match.size() == 5);
-		return {std::stoi(match[1]), std::stoi(match[2]), std::stoi(match[3]), std::stoi(match[4])};
-	}
-	throw std::runtime_error("Found no match for jboa ID in identifier.");
+	// keys are ordered by FPGA first
+	return ADCEntryMap(
+	    adcs.lower_bound(GlobalAnalog_t(fpga, AnalogOnHICANN(AnalogOnHICANN::min))),
+	    adcs.upper_bound(GlobalAnalog_t(fpga, AnalogOnHICANN(AnalogOnHICANN::max))));
 }
 
-void database::clear()
+void WaferEntry::set_hicann(HICANNGlobal const hicann, HICANNEntry const& entry)
 {
-	mWaferData.clear();
-	mDLSData.clear();
-	mHXCubeData.clear();
-	mJboaData.clear();
+	HICANNEntry const* const shared = find_shared_hicann_entry(hicann.toFPGAGlobal());
+	if (shared && shared->version == entry.version && shared->label == entry.label) {
+		return;
+	}
+	expand_hicanns();
+	mHICANNs[hicann] = entry;
 }
 
-void database::load(std::string const path)
+void WaferEntry::set_hicanns(FPGAGlobal const fpga, HICANNEntry const& entry)
 {
-	if (!(mWaferData.empty() && mDLSData.empty() && mHXCubeData.empty() && mJboaData.empty()))
-		throw std::runtime_error("database has to be empty before loading new file");
-
-	for (YAML::Node& config : YAML::LoadAllFromFile(path)) {
-		// yaml node is from a wafer
-		if (config["wafer"].IsDefined()) {
-
-			Wafer wafer(YAML::get_entry<size_t>(config, "wafer"));
-			// FIXME: use encode/decode schema (see FPGAYAML below)
-			WaferEntry entry;
-			entry.setup_type = YAML::get_entry<SetupType>(config, "setuptype");
-			if (entry.setup_type == SetupType::BSSWafer) {
-				entry.macu = YAML::get_entry<IPv4>(config, "macu");
-				entry.macu_version = YAML::get_entry<size_t>(config, "macuversion");
-			} else {
-				entry.macu = YAML::get_entry<IPv4>(config, "macu", IPv4());
-				entry.macu_version = YAML::get_entry<size_t>(config, "macuversion", 0);
-			}
-			add_wafer_entry(wafer, entry);
-
-			auto fpga_entries = config["fpgas"];
-			if (fpga_entries.IsDefined()) {
-				for (const auto& entry : fpga_entries.as<std::vector<FPGAYAML> >()) {
-					FPGAGlobal const fpga(FPGAOnWafer(entry.coordinate), wafer);
-					add_fpga_entry(fpga, entry);
-				}
-			}
-
-			auto reticle_entries = config["reticles"];
-			if (reticle_entries.IsDefined()) {
-				for (const auto& entry : reticle_entries.as<std::vector<ReticleYAML> >()) {
-					DNCGlobal const reticle(DNCOnWafer(Enum(entry.coordinate)), wafer);
-					add_reticle_entry(reticle, entry);
-				}
-			}
-
-			auto ananas_entries = config["ananas"];
-			if (ananas_entries.IsDefined()) {
-				for (const auto& entry : ananas_entries.as<std::vector<AnanasYAML> >()) {
-					AnanasGlobal const ananas(AnanasOnWafer(entry.coordinate), wafer);
-					add_ananas_entry(ananas, entry);
-				}
-			}
+	bool const shareable =
+	    mSharedHICANNs.none() ||
+	    (fpga.toWafer() == mSharedHICANNsWafer && entry.version == mSharedHICANNsEntry.version &&
+	     entry.label == mSharedHICANNsEntry.label);
+	if (mHICANNs.empty() && shareable) {
+		mSharedHICANNs.set(fpga.toFPGAOnWafer().toEnum().value());
+		mSharedHICANNsWafer = fpga.toWafer();
+		mSharedHICANNsEntry = entry;
+		return;
+	}
+	expand_hicanns();
+	for (auto hicann : fpga.toHICANNGlobal()) {
+		mHICANNs[hicann] = entry;
+	}
+}
 
-			auto adc_entries = config["adcs"];
-			if (adc_entries.IsDefined()) {
-				for (const auto& entry : adc_entries.as<std::vector<ADCYAML> >()) {
-					FPGAGlobal const fpga(FPGAOnWafer(entry.fpga), wafer);
-					GlobalAnalog_t const coord(fpga, AnalogOnHICANN(entry.analog));
-					add_adc_entry(coord, entry);
-				}
-			}
+bool WaferEntry::remove_hicann(HICANNGlobal const hicann)
+{
+	if (!has_hicann(hicann)) {
+		return false;
+	}
+	expand_hicanns();
+	return mHICANNs.erase(hicann);
+}
 
-			YAML::Node hicanns_node = config["hicanns"];
-			if (!hicanns_node.IsDefined()) {
-				// No HICANNs -> ignore
-			} else if (hicanns_node.IsSequence()) {
-				auto hicann_entries = hicanns_node.as<std::vector<HICANNYAML> >();
-				for (const auto& entry : hicann_entries) {
-					HICANNGlobal const hicann(HICANNOnWafer(Enum(entry.coordinate)), wafer);
-					add_hicann_entry(hicann, entry);
-				}
-			} else if (hicanns_node.IsMap()) {
-				const HICANNYAML entry = hicanns_node.as<HICANNYAML>();
-				for (auto hicann : iter_all<HICANNOnWafer>()) {
-					if (has_fpga_entry(HICANNGlobal(hicann, wafer).toFPGAGlobal())) {
-						HICANNGlobal const hicann_global(hicann, wafer);
-						add_hicann_entry(hicann_global, entry);
-					}
-				}
-			} else {
-				throw std::runtime_error("hicanns entry must be a squence or a map");
-			}
+void WaferEntry::remove_hicanns(FPGAGlobal const fpga)
+{
+	if (find_shared_hicann_entry(fpga)) {
+		mSharedHICANNs.reset(fpga.toFPGAOnWafer().toEnum().value());
+		return;
+	}
+	for (auto hicann : fpga.toHICANNGlobal()) {
+		mHICANNs.erase(hicann);
+	}
+}
 
-		}
+HICANNEntry const* WaferEntry::find_shared_hicann_entry(FPGAGlobal const fpga) const
+{
+	if (mSharedHICANNs.none() || fpga.toWafer() != mSharedHICANNsWafer ||
+	    !mSharedHICANNs.test(fpga.toFPGAOnWafer().toEnum().value())) {
+		return nullptr;
+	}
+	return &mSharedHICANNsEntry;
+}
 
-		// yaml node is from a dls setup
-		else if (config["dls_setup"].IsDefined()) {
+void WaferEntry::expand_hicanns()
+{
+	if (mSharedHICANNs.any()) {
+		mHICANNs = get_hicanns();
+		mSharedHICANNs.reset();
+		mSharedHICANNsEntry = HICANNEntry();
+	}
+}
 
-			auto dls_setup = config["dls_setup"].as<std::string>();
-			DLSSetupEntry entry;
-			add_dls_entry(dls_setup, entry);
+uint64_t HXCubeFPGAEntry::get_dna_port() const
+{
+	return dna_port_from_fuse_dna(fuse_dna.value());
+}
 
-			auto fpga_name_entry = config["fpga_name"];
-			if (fpga_name_entry.IsDefined()) {
-				mDLSData.at(dls_setup).fpga_name = fpga_name_entry.as<std::string>();
-			}
+uint64_t HXCubeFPGAEntry::dna_port_from_fuse_dna(uint64_t const fuse_dna)
+{
+	// see Xilinx UG470 (v1.13.1) Table 5-16: bit i of the 57 bit DNA_PORT is bit 63 - i
+	// of the FUSE_DNA, i.e. the reversed FUSE_DNA without its lowest 7 bits
+	uint64_t dna = fuse_dna;
+	dna = ((dna >> 1) & 0x5555555555555555ull) | ((dna & 0x5555555555555555ull) << 1);
+	dna = ((dna >> 2) & 0x3333333333333333ull) | ((dna & 0x3333333333333333ull) << 2);
+	dna = ((dna >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((dna & 0x0F0F0F0F0F0F0F0Full) << 4);
+	dna = ((dna >> 8) & 0x00FF00FF00FF00FFull) | ((dna & 0x00FF00FF00FF00FFull) << 8);
+	dna = ((dna >> 16) & 0x0000FFFF0000FFFFull) | ((dna & 0x0000FFFF0000FFFFull) << 16);
+	dna = (dna >> 32) | (dna << 32);
+	return dna & ((uint64_t(1) << 57) - 1);
+}
 
-			auto board_name_entry = config["board_name"];
-			if (board_name_entry.IsDefined()) {
-				mDLSData.at(dls_setup).board_name = board_name_entry.as<std::string>();
-			}
+std::vector<uint64_t> HXCubeFPGAEntry::dna_ports_from_fuse_dnas(
+    std::vector<uint64_t> const& fuse_dnas)
+{
+	std::vector<uint64_t> ret(fuse_dnas.size());
+	std::transform(fuse_dnas.begin(), fuse_dnas.end(), ret.begin(), dna_port_from_fuse_dna);
+	return ret;
+}
 
-			auto board_version_entry = config["board_version"];
-			if (board_version_entry.IsDefined()) {
-				mDLSData.at(dls_setup).board_version = board_version_entry.as<size_t>();
-			}
+namespace {
 
-			auto chip_id_entry = config["chip_id"];
-			if (chip_id_entry.IsDefined()) {
-				mDLSData.at(dls_setup).chip_id = chip_id_entry.as<size_t>();
-			}
+std::string_view unique_branch_prefix(SetupFamily const family)
+{
+	switch (family) {
+		case SetupFamily::hxcube:
+			return "hxcube";
+		case SetupFamily::jboa:
+			return "jboa";
+		default:
+			return std::string_view();
+	}
+}
 
-			auto chip_version_entry = config["chip_version"];
-			if (chip_version_entry.IsDefined()) {
-				mDLSData.at(dls_setup).chip_version = chip_version_entry.as<size_t>();
-			}
+/// remove literal from the front of identifier if it starts with it
+bool consume_literal(std::string_view& identifier, std::string_view const literal)
+{
+	if (identifier.substr(0, literal.size()) != literal) {
+		return false;
+	}
+	identifier.remove_prefix(literal.size());
+	return true;
+}
 
-			auto ntpwr_ip_entry = config["ntpwr_ip"];
-			if (ntpwr_ip_entry.IsDefined()) {
-				mDLSData.at(dls_setup).ntpwr_ip = ntpwr_ip_entry.as<std::string>();
-			}
+/// remove a decimal number from the front of identifier
+bool consume_number(std::string_view& identifier, size_t& ret)
+{
+	auto const result = std::from_chars(identifier.data(), identifier.data() + identifier.size(), ret);
+	if (result.ec != std::errc() || result.ptr == identifier.data()) {
+		return false;
+	}
+	identifier.remove_prefix(result.ptr - identifier.data());
+	return true;
+}
 
-			auto ntpwr_slot_entry = config["ntpwr_slot"];
-			if (ntpwr_slot_entry.IsDefined()) {
-				mDLSData.at(dls_setup).ntpwr_slot = ntpwr_slot_entry.as<size_t>();
-			}
+/// identifier of the first chip on fpgas with the given handwritten or EEPROM serial
+std::optional<UniqueBranchIdentifier> find_chip_on_fpgas(
+    SetupFamily const family,
+    size_t const setup_id,
+    std::map<size_t, HXCubeFPGAEntry> const& fpgas,
+    size_t const chip_serial)
+{
+	for (auto const& fpga : fpgas) {
+		if (!fpga.second.wing) {
+			continue;
 		}
-		// yaml node is from a HXCube setup
-		else if (config["hxcube_id"].IsDefined()) {
-			auto hxcube_id = config["hxcube_id"].as<size_t>();
-			HXCubeSetupEntry entry;
-			entry.hxcube_id = hxcube_id;
-			add_hxcube_setup_entry(hxcube_id, entry);
-
-			auto fpga_entries = config["fpgas"];
-			if (fpga_entries.IsDefined()) {
-				for (const auto& entry : fpga_entries.as<std::vector<HXFPGAYAML> >()) {
-					mHXCubeData.at(hxcube_id).fpgas[entry.coordinate] =
-					    dynamic_cast<HXCubeFPGAEntry const&>(entry);
-				}
-			}
+		HXCubeWingEntry const& wing = *fpga.second.wing;
+		if (wing.handwritten_chip_serial == chip_serial || wing.eeprom_chip_serial == chip_serial) {
+			UniqueBranchIdentifier ret;
+			ret.family = family;
+			ret.setup_id = setup_id;
+			ret.fpga_id = fpga.first;
+			ret.chip_serial = wing.handwritten_chip_serial;
+			return ret;
+		}
+	}
+	return std::nullopt;
+}
 
-			auto usb_host_entry = config["usb_host"];
-			if (usb_host_entry.IsDefined()) {
-				mHXCubeData.at(hxcube_id).usb_host = usb_host_entry.as<std::string>();
-			}
+} // anonymous namespace
 
-			auto usb_serial_entry = config["usb_serial"];
-			if (usb_serial_entry.IsDefined()) {
-				mHXCubeData.at(hxcube_id).usb_serial = usb_serial_entry.as<std::string>();
-			}
+bool UniqueBranchIdentifier::parse(std::string_view identifier, UniqueBranchIdentifier& ret)
+{
+	if (consume_literal(identifier, unique_branch_prefix(SetupFamily::hxcube))) {
+		ret.family = SetupFamily::hxcube;
+	} else if (consume_literal(identifier, unique_branch_prefix(SetupFamily::jboa))) {
+		ret.family = SetupFamily::jboa;
+	} else {
+		return false;
+	}
+	return consume_number(identifier, ret.setup_id) && consume_literal(identifier, "fpga") &&
+	       consume_number(identifier, ret.fpga_id) && consume_literal(identifier, "chip") &&
+	       consume_number(identifier, ret.chip_serial) && consume_literal(identifier, "_") &&
+	       consume_number(identifier, ret.setup_version) && identifier.empty();
+}
 
-			auto xilinx_hw_server_entry = config["xilinx_hw_server"];
-			if (xilinx_hw_server_entry.IsDefined()) {
-				mHXCubeData.at(hxcube_id).xilinx_hw_server =
-				    xilinx_hw_server_entry.as<std::string>();
-			}
-		}
-		// yaml node is from a jBOA setup
-		else if (config["jboa_id"].IsDefined()) {
-			auto jboa_id = config["jboa_id"].as<size_t>();
-			JboaSetupEntry entry;
-			entry.jboa_id = jboa_id;
-			add_jboa_setup_entry(jboa_id, entry);
-
-			auto fpga_entries = config["fpgas"];
-			if (fpga_entries.IsDefined()) {
-				for (const auto& entry : fpga_entries.as<std::vector<HXFPGAYAML>>()) {
-					mJboaData.at(jboa_id).fpgas[entry.coordinate] =
-					    dynamic_cast<HXCubeFPGAEntry const&>(entry);
-				}
-			}
+UniqueBranchIdentifier UniqueBranchIdentifier::from_string(std::string_view const identifier)
+{
+	UniqueBranchIdentifier ret;
+	if (!parse(identifier, ret)) {
+		throw std::runtime_error(
+		    "Found no match for unique branch identifier in '" + std::string(identifier) + "'");
+	}
+	return ret;
+}
 
-			auto aggregator_entries = config["aggregators"];
-			if (aggregator_entries.IsDefined()) {
-				for (const auto& entry : aggregator_entries.as<std::vector<JboaAggregatorYAML>>()) {
-					mJboaData.at(jboa_id).aggregators[entry.coordinate] =
-					    dynamic_cast<JboaAggregatorEntry const&>(entry);
-				}
-			}
+std::vector<UniqueBranchIdentifier> UniqueBranchIdentifier::from_strings(
+    std::vector<std::string> const& identifiers)
+{
+	std::vector<UniqueBranchIdentifier> ret;
+	ret.reserve(identifiers.size());
+	for (auto const& identifier : identifiers) {
+		ret.push_back(from_string(identifier));
+	}
+	return ret;
+}
 
-			auto xilinx_hw_server_entry = config["xilinx_hw_server"];
-			if (xilinx_hw_server_entry.IsDefined()) {
-				mJboaData.at(jboa_id).xilinx_hw_server = xilinx_hw_server_entry.as<std::string>();
-			}
+size_t UniqueBranchIdentifier::format(char* const buffer, size_t const size) const
+{
+	std::string_view const prefix = unique_branch_prefix(family);
+	if (prefix.empty()) {
+		return 0;
+	}
+	char* out = buffer;
+	char* const end = buffer + size;
+	auto const append_literal = [&out, end](std::string_view const literal) {
+		if (size_t(end - out) < literal.size()) {
+			return false;
 		}
-		// yaml node does not contain wafer or dls setup or hxcube setup or jboa setup
-		else {
-			log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
-			LOG4CXX_WARN(logger, "Found node entry neither from Wafer, DLS setup nor HX setup, ignore");
+		out = std::copy(literal.begin(), literal.end(), out);
+		return true;
+	};
+	auto const append_number = [&out, end](size_t const value) {
+		auto const result = std::to_chars(out, end, value);
+		if (result.ec != std::errc()) {
+			return false;
 		}
+		out = result.ptr;
+		return true;
+	};
+	if (append_literal(prefix) && append_number(setup_id) && append_literal("fpga") &&
+	    append_number(fpga_id) && append_literal("chip") && append_number(chip_serial) &&
+	    append_literal("_") && append_number(setup_version)) {
+		return out - buffer;
 	}
+	return 0;
 }
 
-namespace {
-/// Check that all HICANNs are in the vector and that they have the
-/// same settings
-bool can_merge_hicanns(const std::vector<HICANNYAML>& data)
+std::string UniqueBranchIdentifier::to_string() const
+{
+	std::array<char, max_size> buffer;
+	size_t const size = format(buffer.data(), buffer.size());
+	if (!size) {
+		throw std::invalid_argument("unique branch identifiers exist for hxcube and jboa setups only");
+	}
+	return std::string(buffer.data(), size);
+}
+
+std::vector<std::string> UniqueBranchIdentifier::to_strings(
+    std::vector<UniqueBranchIdentifier> const& ids)
+{
+	std::vector<std::string> ret;
+	ret.reserve(ids.size());
+	for (auto const& id : ids) {
+		ret.push_back(id.to_string());
+	}
+	return ret;
+}
+
+bool UniqueBranchIdentifier::operator==(UniqueBranchIdentifier const& other) const
+{
+	return family == other.family && setup_id == other.setup_id && fpga_id == other.fpga_id &&
+	       chip_serial == other.chip_serial && setup_version == other.setup_version;
+}
+
+bool UniqueBranchIdentifier::operator!=(UniqueBranchIdentifier const& other) const
+{
+	return !(*this == other);
+}
+
+bool FPGALocation::operator==(FPGALocation const& other) const
+{
+	return family == other.family && setup_id == other.setup_id && fpga_id == other.fpga_id;
+}
+
+bool FPGALocation::operator!=(FPGALocation const& other) const
+{
+	return !(*this == other);
+}
+
+std::string HXCubeSetupEntry::get_unique_branch_identifier(size_t chip_serial) const
+{
+	auto const id = find_chip_on_fpgas(SetupFamily::hxcube, hxcube_id, fpgas, chip_serial);
+	if (!id) {
+		throw std::runtime_error("No chip with serial " + std::to_string(chip_serial) + " found");
+	}
+	return id->to_string();
+}
+
+std::tuple<size_t, size_t, size_t, size_t> HXCubeSetupEntry::get_ids_from_unique_branch_identifier(
+    std::string identifier)
+{
+	UniqueBranchIdentifier id;
+	if (UniqueBranchIdentifier::parse(identifier, id) && id.family == SetupFamily::hxcube) {
+		return {id.setup_id, id.fpga_id, id.chip_serial, id.setup_version};
+	}
+	throw std::runtime_error("Found no match for hxcube ID in identifier.");
+}
+
+std::string JboaSetupEntry::get_unique_branch_identifier(size_t chip_serial) const
+{
+	auto const id = find_chip_on_fpgas(SetupFamily::jboa, jboa_id, fpgas, chip_serial);
+	if (!id) {
+		throw std::runtime_error("No chip with serial " + std::to_string(chip_serial) + " found");
+	}
+	return id->to_string();
+}
+
+std::tuple<size_t, size_t, size_t, size_t> JboaSetupEntry::get_ids_from_unique_branch_identifier(
+    std::string identifier)
+{
+	UniqueBranchIdentifier id;
+	if (UniqueBranchIdentifier::parse(identifier, id) && id.family == SetupFamily::jboa) {
+		return {id.setup_id, id.fpga_id, id.chip_serial, id.setup_version};
+	}
+	throw std::runtime_error("Found no match for jboa ID in identifier.");
+}
+
+database::database() : mIndexDefinitions(get_default_index_definitions()) {}
+
+database::database(database const& other) : database()
+{
+	*this = other;
+}
+
+database::database(database&& other) :
+    mLoadRecord(std::move(other.mLoadRecord)),
+    mPending(std::move(other.mPending)),
+    mWaferData(std::move(other.mWaferData)),
+    mDLSData(std::move(other.mDLSData)),
+    mHXCubeData(std::move(other.mHXCubeData)),
+    mJboaData(std::move(other.mJboaData)),
+    mIndexes(std::move(other.mIndexes)),
+    mIndexDefinitions(std::move(other.mIndexDefinitions))
+{
+	mLazy = other.mLazy.load();
+	other.clear();
+	other.mIndexDefinitions = get_default_index_definitions();
+}
+
+database& database::operator=(database&& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+	mLoadRecord = std::move(other.mLoadRecord);
+	mPending = std::move(other.mPending);
+	mWaferData = std::move(other.mWaferData);
+	mDLSData = std::move(other.mDLSData);
+	mHXCubeData = std::move(other.mHXCubeData);
+	mJboaData = std::move(other.mJboaData);
+	mIndexDefinitions = std::move(other.mIndexDefinitions);
+	mLazy = other.mLazy.load();
+	{
+		// indexes only hold copies of entry data, they remain valid
+		std::lock_guard<std::recursive_mutex> const lock(mMutex);
+		mIndexes = std::move(other.mIndexes);
+	}
+	other.clear();
+	other.mIndexDefinitions = get_default_index_definitions();
+	return *this;
+}
+
+database& database::operator=(database const& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+	auto const lock = other.lock_pending();
+	mLoadRecord = other.mLoadRecord;
+	mPending = other.mPending;
+	mWaferData = other.mWaferData;
+	mDLSData = other.mDLSData;
+	mHXCubeData = other.mHXCubeData;
+	mJboaData = other.mJboaData;
+	mIndexDefinitions = other.mIndexDefinitions;
+	mLazy = !mPending.empty();
+	invalidate_indexes();
+	return *this;
+}
+
+void database::clear()
+{
+	mPending.clear();
+	mLazy = false;
+	mLoadRecord = LoadRecord();
+	mWaferData.clear();
+	mDLSData.clear();
+	mHXCubeData.clear();
+	mJboaData.clear();
+	invalidate_indexes();
+}
+
+namespace {
+
+/// Decode a single YAML document (wafer, DLS, HX cube or jBOA setup) into db
+void load_document(database& db, YAML::Node& config)
+{
+	// yaml node is from a wafer
+	if (config["wafer"].IsDefined()) {
+
+		Wafer wafer(YAML::get_entry<size_t>(config, "wafer"));
+		// FIXME: use encode/decode schema (see FPGAYAML below)
+		WaferEntry entry;
+		entry.setup_type = YAML::get_entry<SetupType>(config, "setuptype");
+		if (entry.setup_type == SetupType::BSSWafer) {
+			entry.macu = YAML::get_entry<IPv4>(config, "macu");
+			entry.macu_version = YAML::get_entry<size_t>(config, "macuversion");
+		} else {
+			entry.macu = YAML::get_entry<IPv4>(config, "macu", IPv4());
+			entry.macu_version = YAML::get_entry<size_t>(config, "macuversion", 0);
+		}
+		db.add_wafer_entry(wafer, entry);
+
+		auto fpga_entries = config["fpgas"];
+		if (fpga_entries.IsDefined()) {
+			for (const auto& entry : fpga_entries.as<std::vector<FPGAYAML> >()) {
+				for (size_t i = 0; i < entry.count; ++i) {
+					auto const item = range_item(entry, i);
+					FPGAGlobal const fpga(FPGAOnWafer(item.coordinate), wafer);
+					db.add_fpga_entry(fpga, item);
+				}
+			}
+		}
+
+		auto reticle_entries = config["reticles"];
+		if (reticle_entries.IsDefined()) {
+			for (const auto& entry : reticle_entries.as<std::vector<ReticleYAML> >()) {
+				for (size_t i = 0; i < entry.count; ++i) {
+					auto const item = range_item(entry, i);
+					DNCGlobal const reticle(DNCOnWafer(Enum(item.coordinate)), wafer);
+					db.add_reticle_entry(reticle, item);
+				}
+			}
+		}
+
+		auto ananas_entries = config["ananas"];
+		if (ananas_entries.IsDefined()) {
+			for (const auto& entry : ananas_entries.as<std::vector<AnanasYAML> >()) {
+				AnanasGlobal const ananas(AnanasOnWafer(entry.coordinate), wafer);
+				db.add_ananas_entry(ananas, entry);
+			}
+		}
+
+		auto adc_entries = config["adcs"];
+		if (adc_entries.IsDefined()) {
+			for (const auto& entry : adc_entries.as<std::vector<ADCYAML> >()) {
+				FPGAGlobal const fpga(FPGAOnWafer(entry.fpga), wafer);
+				GlobalAnalog_t const coord(fpga, AnalogOnHICANN(entry.analog));
+				db.add_adc_entry(coord, entry);
+			}
+		}
+
+		YAML::Node hicanns_node = config["hicanns"];
+		if (!hicanns_node.IsDefined()) {
+			// No HICANNs -> ignore
+		} else if (hicanns_node.IsSequence()) {
+			auto hicann_entries = hicanns_node.as<std::vector<HICANNYAML> >();
+			for (const auto& entry : hicann_entries) {
+				HICANNGlobal const hicann(HICANNOnWafer(Enum(entry.coordinate)), wafer);
+				db.add_hicann_entry(hicann, entry);
+			}
+		} else if (hicanns_node.IsMap()) {
+			// kept as shorthand covering the FPGAs of this document
+			WaferEntry& wafer_entry = db.get_wafer_entry(wafer);
+			HICANNEntry const entry = hicanns_node.as<HICANNYAML>();
+			for (auto const& item : wafer_entry.fpgas) {
+				wafer_entry.set_hicanns(item.first, entry);
+			}
+		} else {
+			throw std::runtime_error("hicanns entry must be a squence or a map");
+		}
+
+	}
+
+	// yaml node is from a dls setup
+	else if (config["dls_setup"].IsDefined()) {
+
+		auto dls_setup = config["dls_setup"].as<std::string>();
+		DLSSetupEntry entry;
+		db.add_dls_entry(dls_setup, entry);
+
+		auto fpga_name_entry = config["fpga_name"];
+		if (fpga_name_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).fpga_name = fpga_name_entry.as<std::string>();
+		}
+
+		auto board_name_entry = config["board_name"];
+		if (board_name_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).board_name = board_name_entry.as<std::string>();
+		}
+
+		auto board_version_entry = config["board_version"];
+		if (board_version_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).board_version = board_version_entry.as<size_t>();
+		}
+
+		auto chip_id_entry = config["chip_id"];
+		if (chip_id_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).chip_id = chip_id_entry.as<size_t>();
+		}
+
+		auto chip_version_entry = config["chip_version"];
+		if (chip_version_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).chip_version = chip_version_entry.as<size_t>();
+		}
+
+		auto ntpwr_ip_entry = config["ntpwr_ip"];
+		if (ntpwr_ip_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).ntpwr_ip = ntpwr_ip_entry.as<std::string>();
+		}
+
+		auto ntpwr_slot_entry = config["ntpwr_slot"];
+		if (ntpwr_slot_entry.IsDefined()) {
+			db.get_dls_entry(dls_setup).ntpwr_slot = ntpwr_slot_entry.as<size_t>();
+		}
+	}
+	// yaml node is from a HXCube setup
+	else if (config["hxcube_id"].IsDefined()) {
+		auto hxcube_id = config["hxcube_id"].as<size_t>();
+		HXCubeSetupEntry entry;
+		entry.hxcube_id = hxcube_id;
+		db.add_hxcube_setup_entry(hxcube_id, entry);
+
+		auto fpga_entries = config["fpgas"];
+		if (fpga_entries.IsDefined()) {
+			for (const auto& entry : fpga_entries.as<std::vector<HXFPGAYAML> >()) {
+				for (size_t i = 0; i < entry.count; ++i) {
+					auto const item = range_item(entry, i);
+					db.get_hxcube_setup_entry(hxcube_id).fpgas[item.coordinate] =
+					    dynamic_cast<HXCubeFPGAEntry const&>(item);
+				}
+			}
+		}
+
+		auto usb_host_entry = config["usb_host"];
+		if (usb_host_entry.IsDefined()) {
+			db.get_hxcube_setup_entry(hxcube_id).usb_host = usb_host_entry.as<std::string>();
+		}
+
+		auto usb_serial_entry = config["usb_serial"];
+		if (usb_serial_entry.IsDefined()) {
+			db.get_hxcube_setup_entry(hxcube_id).usb_serial = usb_serial_entry.as<std::string>();
+		}
+
+		auto xilinx_hw_server_entry = config["xilinx_hw_server"];
+		if (xilinx_hw_server_entry.IsDefined()) {
+			db.get_hxcube_setup_entry(hxcube_id).xilinx_hw_server =
+			    xilinx_hw_server_entry.as<std::string>();
+		}
+	}
+	// yaml node is from a jBOA setup
+	else if (config["jboa_id"].IsDefined()) {
+		auto jboa_id = config["jboa_id"].as<size_t>();
+		JboaSetupEntry entry;
+		entry.jboa_id = jboa_id;
+		db.add_jboa_setup_entry(jboa_id, entry);
+
+		auto fpga_entries = config["fpgas"];
+		if (fpga_entries.IsDefined()) {
+			for (const auto& entry : fpga_entries.as<std::vector<HXFPGAYAML>>()) {
+				for (size_t i = 0; i < entry.count; ++i) {
+					auto const item = range_item(entry, i);
+					db.get_jboa_setup_entry(jboa_id).fpgas[item.coordinate] =
+					    dynamic_cast<HXCubeFPGAEntry const&>(item);
+				}
+			}
+		}
+
+		auto aggregator_entries = config["aggregators"];
+		if (aggregator_entries.IsDefined()) {
+			for (const auto& entry : aggregator_entries.as<std::vector<JboaAggregatorYAML>>()) {
+				db.get_jboa_setup_entry(jboa_id).aggregators[entry.coordinate] =
+				    dynamic_cast<JboaAggregatorEntry const&>(entry);
+			}
+		}
+
+		auto xilinx_hw_server_entry = config["xilinx_hw_server"];
+		if (xilinx_hw_server_entry.IsDefined()) {
+			db.get_jboa_setup_entry(jboa_id).xilinx_hw_server = xilinx_hw_server_entry.as<std::string>();
+		}
+	}
+	// yaml node does not contain wafer or dls setup or hxcube setup or jboa setup
+	else {
+		log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+		LOG4CXX_WARN(logger, "Found node entry neither from Wafer, DLS setup nor HX setup, ignore");
+	}
+}
+
+/// Flat representation of a single YAML document built from the events of the
+/// YAML parser. Nodes are stored in document order, each token refers to the
+/// token following the node (skipping all children of containers). Scalar values
+/// are stored in a shared text buffer.
+struct EventToken
+{
+	enum Kind : uint8_t
+	{
+		null,
+		scalar,
+		map,
+		sequence
+	};
+	Kind kind;
+	size_t line;
+	/// scalar: offset of value in text buffer
+	size_t offset;
+	/// scalar: length of value, sequence: number of elements, map: number of pairs
+	size_t size;
+	/// index of the token following this node
+	size_t next;
+};
+
+struct EventDocument
+{
+	std::vector<EventToken> tokens;
+	std::string text;
+};
+
+/// Event handler filling an EventDocument, the buffers are reused for all documents
+class EventDocumentBuilder : public YAML::EventHandler
+{
+public:
+	explicit EventDocumentBuilder(EventDocument& document) : m_document(document) {}
+
+	void OnDocumentStart(YAML::Mark const&) override
+	{
+		m_document.tokens.clear();
+		m_document.text.clear();
+		m_open.clear();
+		m_anchors.clear();
+	}
+
+	void OnDocumentEnd() override {}
+
+	void OnNull(YAML::Mark const& mark, YAML::anchor_t anchor) override
+	{
+		finish(push(EventToken::null, mark), anchor);
+	}
+
+	void OnAlias(YAML::Mark const&, YAML::anchor_t anchor) override
+	{
+		auto const it = m_anchors.find(anchor);
+		if (it == m_anchors.end()) {
+			throw std::runtime_error("unknown YAML anchor");
+		}
+		// copy tokens of the anchored node
+		auto& tokens = m_document.tokens;
+		size_t const begin = it->second.first;
+		size_t const end = it->second.second;
+		size_t const shift = tokens.size() - begin;
+		tokens.reserve(tokens.size() + end - begin);
+		for (size_t i = begin; i < end; ++i) {
+			tokens.push_back(tokens[i]);
+			tokens.back().next += shift;
+		}
+		if (!m_open.empty()) {
+			++tokens[m_open.back().first].size;
+		}
+	}
+
+	void OnScalar(
+	    YAML::Mark const& mark,
+	    std::string const&,
+	    YAML::anchor_t anchor,
+	    std::string const& value) override
+	{
+		size_t const index = push(EventToken::scalar, mark);
+		m_document.tokens[index].offset = m_document.text.size();
+		m_document.tokens[index].size = value.size();
+		m_document.text.append(value);
+		finish(index, anchor);
+	}
+
+	void OnSequenceStart(
+	    YAML::Mark const& mark,
+	    std::string const&,
+	    YAML::anchor_t anchor,
+	    YAML::EmitterStyle::value) override
+	{
+		m_open.emplace_back(push(EventToken::sequence, mark), anchor);
+	}
+
+	void OnSequenceEnd() override { close(); }
+
+	void OnMapStart(
+	    YAML::Mark const& mark,
+	    std::string const&,
+	    YAML::anchor_t anchor,
+	    YAML::EmitterStyle::value) override
+	{
+		m_open.emplace_back(push(EventToken::map, mark), anchor);
+	}
+
+	void OnMapEnd() override { close(); }
+
+private:
+	size_t push(EventToken::Kind kind, YAML::Mark const& mark)
+	{
+		m_document.tokens.push_back(
+		    {kind, static_cast<size_t>(mark.line + 1), 0, 0, m_document.tokens.size() + 1});
+		return m_document.tokens.size() - 1;
+	}
+
+	void finish(size_t index, YAML::anchor_t anchor)
+	{
+		auto& tokens = m_document.tokens;
+		tokens[index].next = tokens.size();
+		if (anchor) {
+			m_anchors[anchor] = {index, tokens.size()};
+		}
+		if (!m_open.empty()) {
+			++tokens[m_open.back().first].size;
+		}
+	}
+
+	void close()
+	{
+		auto const open = m_open.back();
+		m_open.pop_back();
+		if (m_document.tokens[open.first].kind == EventToken::map) {
+			// keys and values have been counted separately
+			m_document.tokens[open.first].size /= 2;
+		}
+		finish(open.first, open.second);
+	}
+
+	EventDocument& m_document;
+	/// currently open containers and their anchors
+	std::vector<std::pair<size_t, YAML::anchor_t>> m_open;
+	/// token range of anchored nodes
+	std::map<YAML::anchor_t, std::pair<size_t, size_t>> m_anchors;
+};
+
+/// Lightweight view on a node of an EventDocument, mimicking the parts of the
+/// YAML::Node interface used by the decoders below.
+class EventNode
+{
+public:
+	EventNode() : m_document(nullptr), m_index(0) {}
+	EventNode(EventDocument const& document, size_t index) : m_document(&document), m_index(index)
+	{}
+
+	bool IsDefined() const { return m_document != nullptr; }
+	bool IsNull() const { return token().kind == EventToken::null; }
+	bool IsScalar() const { return token().kind == EventToken::scalar; }
+	bool IsMap() const { return token().kind == EventToken::map; }
+	bool IsSequence() const { return token().kind == EventToken::sequence; }
+	size_t size() const { return IsScalar() ? 0 : token().size; }
+	size_t line() const { return token().line; }
+
+	std::string_view Scalar() const
+	{
+		return std::string_view(m_document->text).substr(token().offset, token().size);
+	}
+
+	/// Lookup value of key in a map, returns an undefined node if not found
+	EventNode operator[](std::string_view const key) const
+	{
+		if (!IsMap()) {
+			return EventNode();
+		}
+		auto const& tokens = m_document->tokens;
+		size_t index = m_index + 1;
+		for (size_t i = 0; i < token().size; ++i) {
+			EventNode const key_node(*m_document, index);
+			size_t const value = tokens[index].next;
+			if (key_node.IsScalar() && key_node.Scalar() == key) {
+				return EventNode(*m_document, value);
+			}
+			index = tokens[value].next;
+		}
+		return EventNode();
+	}
+
+	/// Call f for each element of a sequence
+	template <typename F>
+	void for_each(F&& f) const
+	{
+		size_t index = m_index + 1;
+		for (size_t i = 0; i < token().size; ++i) {
+			f(EventNode(*m_document, index));
+			index = m_document->tokens[index].next;
+		}
+	}
+
+	/// Call f(key, value) for each entry of a map
+	template <typename F>
+	void for_each_pair(F&& f) const
+	{
+		auto const& tokens = m_document->tokens;
+		size_t index = m_index + 1;
+		for (size_t i = 0; i < token().size; ++i) {
+			size_t const value = tokens[index].next;
+			f(EventNode(*m_document, index), EventNode(*m_document, value));
+			index = tokens[value].next;
+		}
+	}
+
+private:
+	EventToken const& token() const { return m_document->tokens[m_index]; }
+
+	EventDocument const* m_document;
+	size_t m_index;
+};
+
+[[noreturn]] void throw_event_error(EventNode const& node, std::string const& what)
+{
+	throw std::runtime_error("yaml-cpp: error at line " + std::to_string(node.line()) + ": " + what);
+}
+
+// Scalar conversions, following the rules of the corresponding YAML::convert specializations
+
+void decode_event(EventNode const& node, std::string& data)
+{
+	if (node.IsNull()) {
+		data = "null";
+	} else if (node.IsScalar()) {
+		data = node.Scalar();
+	} else {
+		throw_event_error(node, "bad conversion to string");
+	}
+}
+
+/// Parse unsigned integer, the base is determined by its prefix like in C.
+/// Returns false if value is no valid number or out of range.
+template <typename T>
+bool parse_unsigned(std::string_view const value, T& data)
+{
+	size_t pos = 0;
+	if (pos < value.size() && value[pos] == '+') {
+		++pos;
+	}
+	unsigned base = 10;
+	if (value.size() > pos + 1 && value[pos] == '0' && (value[pos + 1] == 'x' || value[pos + 1] == 'X')) {
+		base = 16;
+		pos += 2;
+	} else if (pos < value.size() && value[pos] == '0') {
+		base = 8;
+	}
+
+	T result = 0;
+	size_t const first_digit = pos;
+	for (; pos < value.size(); ++pos) {
+		char const c = value[pos];
+		unsigned digit;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			break;
+		}
+		if (digit >= base) {
+			break;
+		}
+		if (result > (std::numeric_limits<T>::max() - digit) / base) {
+			return false;
+		}
+		result = result * base + digit;
+	}
+	if (pos == first_digit) {
+		return false;
+	}
+	for (; pos < value.size(); ++pos) {
+		if (!std::isspace(static_cast<unsigned char>(value[pos]))) {
+			return false;
+		}
+	}
+	data = result;
+	return true;
+}
+
+template <typename T>
+std::enable_if_t<std::is_unsigned<T>::value && !std::is_same<T, bool>::value> decode_event(
+    EventNode const& node, T& data)
+{
+	if (!node.IsScalar() || !parse_unsigned(node.Scalar(), data)) {
+		throw_event_error(node, "bad conversion to integer");
+	}
+}
+
+void decode_event(EventNode const& node, bool& data)
+{
+	static std::array<std::pair<std::string_view, std::string_view>, 4> const names = {
+	    {{"y", "n"}, {"yes", "no"}, {"true", "false"}, {"on", "off"}}};
+
+	if (node.IsScalar()) {
+		std::string value(node.Scalar());
+		// accepted spellings are lowercase, uppercase or first letter uppercase only
+		bool const lower = std::none_of(value.begin(), value.end(), ::isupper);
+		bool const upper = std::none_of(value.begin(), value.end(), ::islower);
+		bool const title = !value.empty() && std::isupper(static_cast<unsigned char>(value[0])) &&
+		                   std::none_of(value.begin() + 1, value.end(), ::isupper);
+		if (lower || upper || title) {
+			boost::algorithm::to_lower(value);
+			for (auto const& name : names) {
+				if (value == name.first) {
+					data = true;
+					return;
+				} else if (value == name.second) {
+					data = false;
+					return;
+				}
+			}
+		}
+	}
+	throw_event_error(node, "bad conversion to bool");
+}
+
+void decode_event(EventNode const& node, IPv4& data)
+{
+	std::string value;
+	decode_event(node, value);
+	data = IPv4::from_string(value);
+}
+
+void decode_event(EventNode const& node, SetupType& data)
+{
+	std::string value;
+	decode_event(node, value);
+	boost::algorithm::to_lower(value);
+	auto it = std::find(SetupType_NAMES.begin(), SetupType_NAMES.end(), value);
+	if (it == SetupType_NAMES.end()) {
+		throw std::runtime_error("Unkown value for chip: " + value);
+	}
+	data = static_cast<SetupType>(std::distance(SetupType_NAMES.begin(), it));
+}
+
+template <typename T, size_t N>
+void decode_event(EventNode const& node, std::array<T, N>& data)
+{
+	if (!node.IsSequence() || node.size() != N) {
+		throw_event_error(node, "bad conversion to array");
+	}
+	size_t i = 0;
+	node.for_each([&](EventNode const& element) { decode_event(element, data[i++]); });
+}
+
+template <typename T>
+T as(EventNode const& node)
+{
+	T data;
+	decode_event(node, data);
+	return data;
+}
+
+/// Get value of required key in map
+template <typename T>
+T get_entry(EventNode const& node, std::string_view const name)
+{
+	EventNode const& key = node[name];
+	if (!key.IsDefined()) {
+		throw_event_error(node, "key not found: " + std::string(name));
+	}
+	return as<T>(key);
+}
+
+/// Get value of optional key in map
+template <typename T>
+T get_entry(EventNode const& node, std::string_view const name, T const default_value)
+{
+	EventNode const& key = node[name];
+	if (!key.IsDefined()) {
+		return default_value;
+	}
+	return as<T>(key);
+}
+
+/// Call f(index, value) for each entry of a map in a single pass, unknown and repeated
+/// keys are rejected
+template <size_t N, typename F>
+FieldSet<N> for_each_field(EventNode const& node, FieldTable<N> const& fields, F&& f)
+{
+	FieldSet<N> found;
+	node.for_each_pair([&](EventNode const& key, EventNode const& value) {
+		if (!key.IsScalar()) {
+			throw_event_error(key, "bad key");
+		}
+		size_t const index = fields.find(key.Scalar());
+		if (index == N) {
+			throw_event_error(key, "unknown key '" + std::string(key.Scalar()) + "'");
+		} else if (found[index]) {
+			throw_event_error(key, "duplicate key '" + std::string(key.Scalar()) + "'");
+		}
+		found.set(index);
+		f(index, value);
+	});
+	return found;
+}
+
+/// Throw if one of the required keys was not found
+template <size_t N>
+void require_fields(
+    EventNode const& node,
+    FieldTable<N> const& fields,
+    FieldSet<N> const& found,
+    std::initializer_list<size_t> const required)
+{
+	for (size_t const index : required) {
+		if (!found[index]) {
+			throw_event_error(node, "key not found: " + std::string(fields.key(index)));
+		}
+	}
+}
+
+/// Decode single coordinate or range "first-last" of a sequence entry, coordinates of
+/// ranges have to be below size
+void decode_coordinate(EventNode const& node, size_t const size, size_t& first, size_t& count)
+{
+	count = 1;
+	if (!node.IsScalar() || !parse_range(node.Scalar(), size, first, count)) {
+		first = as<size_t>(node);
+	}
+}
+
+// Decoders of sequence entries, following the corresponding YAML::convert specializations
+
+void decode_event(EventNode const& node, ADCYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of adc entry failed");
+	}
+	auto const& fields = adc_fields;
+	data.remote_ip = IPv4();
+	data.remote_port = TCPPort(0);
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["adc"]:
+				data.coord = as<std::string>(value);
+				break;
+			case fields["channel"]:
+				data.channel = ChannelOnADC(as<size_t>(value));
+				break;
+			case fields["trigger"]:
+				data.trigger = TriggerOnADC(as<size_t>(value));
+				break;
+			case fields["analog"]:
+				data.analog = as<size_t>(value);
+				break;
+			case fields["fpga"]:
+				data.fpga = as<size_t>(value);
+				break;
+			case fields["remote_ip"]:
+				data.remote_ip = as<IPv4>(value);
+				break;
+			case fields["remote_port"]:
+				data.remote_port = TCPPort(as<size_t>(value));
+				break;
+			case fields["dnc_on_fpga"]:
+				break;
+		}
+	});
+	require_fields(
+	    node, fields, found,
+	    {fields["adc"], fields["channel"], fields["trigger"], fields["analog"], fields["fpga"]});
+}
+
+void decode_event(EventNode const& node, FPGAYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of fpga entry failed");
+	}
+	auto const& fields = fpga_fields;
+	data.highspeed = true;
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["fpga"]:
+				decode_coordinate(value, FPGAOnWafer::size, data.coordinate, data.count);
+				break;
+			case fields["ip"]:
+				data.ip = IPv4::from_string(as<std::string>(value));
+				break;
+			case fields["highspeed"]:
+				data.highspeed = as<bool>(value);
+				break;
+		}
+	});
+	require_fields(node, fields, found, {fields["fpga"], fields["ip"]});
+}
+
+void decode_event(EventNode const& node, HXFPGAYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of fpga entry failed");
+	}
+	auto const& fields = hxfpga_fields;
+	data.fuse_dna.reset();
+	data.ci_test_node = false;
+	data.wing.reset();
+	HXCubeWingEntry wing;
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["fpga"]:
+				decode_coordinate(
+				    value, std::numeric_limits<size_t>::max(), data.coordinate, data.count);
+				break;
+			case fields["ip"]:
+				data.ip = IPv4::from_string(as<std::string>(value));
+				break;
+			case fields["fuse_dna"]:
+				data.fuse_dna = as<uint64_t>(value);
+				break;
+			case fields["ci_test_node"]:
+				data.ci_test_node = as<bool>(value);
+				break;
+			case fields["handwritten_chip_serial"]:
+				wing.handwritten_chip_serial = as<size_t>(value);
+				break;
+			case fields["chip_revision"]:
+				wing.chip_revision = as<size_t>(value);
+				break;
+			case fields["eeprom_chip_serial"]:
+				wing.eeprom_chip_serial = as<size_t>(value);
+				break;
+			case fields["synram_timing_pcconf"]:
+				wing.synram_timing_pcconf = as<std::array<std::array<uint16_t, 2>, 2>>(value);
+				break;
+			case fields["synram_timing_wconf"]:
+				wing.synram_timing_wconf = as<std::array<std::array<uint16_t, 2>, 2>>(value);
+				break;
+		}
+	});
+	require_fields(node, fields, found, {fields["fpga"], fields["ip"]});
+	bool const hand_serial = found[fields["handwritten_chip_serial"]];
+	bool const chip_rev = found[fields["chip_revision"]];
+	if (hand_serial || chip_rev) {
+		if (!hand_serial || !chip_rev) {
+			throw_event_error(
+			    node, "decoding failed, hand serial and chip revision need to be defined");
+		}
+		data.wing = wing;
+	} else if (
+	    found[fields["eeprom_chip_serial"]] || found[fields["synram_timing_pcconf"]] ||
+	    found[fields["synram_timing_wconf"]]) {
+		throw_event_error(node, "decoding failed, only optional entries found");
+	}
+	if (data.count > 1 && (data.fuse_dna || data.wing)) {
+		throw_event_error(node, "decoding failed, fpga ranges cannot have per fpga entries");
+	}
+	// consecutive addresses of all FPGAs of a range have to exist
+	ip_offset(data.ip, data.count - 1);
+}
+
+void decode_event(EventNode const& node, JboaAggregatorYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of aggregator entry failed");
+	}
+	auto const& fields = aggregator_fields;
+	data.ci_test_node = false;
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["aggregator"]:
+				data.coordinate = as<size_t>(value);
+				break;
+			case fields["ip"]:
+				data.ip = IPv4::from_string(as<std::string>(value));
+				break;
+			case fields["ci_test_node"]:
+				data.ci_test_node = as<bool>(value);
+				break;
+		}
+	});
+	require_fields(node, fields, found, {fields["aggregator"], fields["ip"]});
+}
+
+void decode_event(EventNode const& node, ReticleYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of reticle entry failed");
+	}
+	auto const& fields = reticle_fields;
+	data.to_be_powered = true;
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["reticle"]:
+				decode_coordinate(value, DNCOnWafer::size, data.coordinate, data.count);
+				break;
+			case fields["to_be_powered"]:
+				data.to_be_powered = as<bool>(value);
+				break;
+		}
+	});
+	require_fields(node, fields, found, {fields["reticle"]});
+}
+
+void decode_event(EventNode const& node, AnanasYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of ananas entry failed");
+	}
+	auto const& fields = ananas_fields;
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["ananas"]:
+				data.coordinate = as<size_t>(value);
+				break;
+			case fields["ip"]:
+				data.ip = IPv4::from_string(as<std::string>(value));
+				break;
+			case fields["baseport_data"]:
+				data.baseport_data = UDPPort(as<size_t>(value));
+				break;
+			case fields["baseport_reset"]:
+				data.baseport_reset = UDPPort(as<size_t>(value));
+				break;
+		}
+	});
+	require_fields(
+	    node, fields, found,
+	    {fields["ananas"], fields["ip"], fields["baseport_data"], fields["baseport_reset"]});
+}
+
+void decode_event(EventNode const& node, HICANNYAML& data)
+{
+	if (!node.IsMap()) {
+		throw_event_error(node, "decoding of hicann entry failed");
+	}
+	auto const& fields = hicann_fields;
+	data.coordinate = 0;
+	data.label.clear();
+	auto const found = for_each_field(node, fields, [&](size_t const field, EventNode const& value) {
+		switch (field) {
+			case fields["hicann"]:
+				data.coordinate = as<size_t>(value);
+				break;
+			case fields["version"]:
+				data.version = as<size_t>(value);
+				break;
+			case fields["label"]:
+				data.label = as<std::string>(value);
+				break;
+		}
+	});
+	require_fields(node, fields, found, {fields["version"]});
+}
+
+/// Call f for each decoded element of a sequence
+template <typename T, typename F>
+void for_each_entry(EventNode const& node, F&& f)
+{
+	if (!node.IsSequence()) {
+		throw_event_error(node, "bad conversion to sequence");
+	}
+	node.for_each([&](EventNode const& element) { f(as<T>(element)); });
+}
+
+/// Decode a single document provided by the event parser into db, equivalent to
+/// the YAML::Node based variant above
+void load_document(database& db, EventNode const& config)
+{
+	if (config.IsScalar()) {
+		throw_event_error(config, "document has to be a map");
+	}
+
+	// yaml node is from a wafer
+	if (config["wafer"].IsDefined()) {
+		Wafer wafer(get_entry<size_t>(config, "wafer"));
+		WaferEntry entry;
+		entry.setup_type = get_entry<SetupType>(config, "setuptype");
+		if (entry.setup_type == SetupType::BSSWafer) {
+			entry.macu = get_entry<IPv4>(config, "macu");
+			entry.macu_version = get_entry<size_t>(config, "macuversion");
+		} else {
+			entry.macu = get_entry<IPv4>(config, "macu", IPv4());
+			entry.macu_version = get_entry<size_t>(config, "macuversion", 0);
+		}
+		db.add_wafer_entry(wafer, entry);
+
+		auto fpga_entries = config["fpgas"];
+		if (fpga_entries.IsDefined()) {
+			for_each_entry<FPGAYAML>(fpga_entries, [&](FPGAYAML const& entry) {
+				for (size_t i = 0; i < entry.count; ++i) {
+					auto const item = range_item(entry, i);
+					db.add_fpga_entry(FPGAGlobal(FPGAOnWafer(item.coordinate), wafer), item);
+				}
+			});
+		}
+
+		auto reticle_entries = config["reticles"];
+		if (reticle_entries.IsDefined()) {
+			for_each_entry<ReticleYAML>(reticle_entries, [&](ReticleYAML const& entry) {
+				for (size_t i = 0; i < entry.count; ++i) {
+					auto const item = range_item(entry, i);
+					db.add_reticle_entry(DNCGlobal(DNCOnWafer(Enum(item.coordinate)), wafer), item);
+				}
+			});
+		}
+
+		auto ananas_entries = config["ananas"];
+		if (ananas_entries.IsDefined()) {
+			for_each_entry<AnanasYAML>(ananas_entries, [&](AnanasYAML const& entry) {
+				db.add_ananas_entry(AnanasGlobal(AnanasOnWafer(entry.coordinate), wafer), entry);
+			});
+		}
+
+		auto adc_entries = config["adcs"];
+		if (adc_entries.IsDefined()) {
+			for_each_entry<ADCYAML>(adc_entries, [&](ADCYAML const& entry) {
+				FPGAGlobal const fpga(FPGAOnWafer(entry.fpga), wafer);
+				db.add_adc_entry(GlobalAnalog_t(fpga, AnalogOnHICANN(entry.analog)), entry);
+			});
+		}
+
+		auto hicanns_node = config["hicanns"];
+		if (!hicanns_node.IsDefined()) {
+			// No HICANNs -> ignore
+		} else if (hicanns_node.IsSequence()) {
+			for_each_entry<HICANNYAML>(hicanns_node, [&](HICANNYAML const& entry) {
+				db.add_hicann_entry(HICANNGlobal(HICANNOnWafer(Enum(entry.coordinate)), wafer), entry);
+			});
+		} else if (hicanns_node.IsMap()) {
+			WaferEntry& wafer_entry = db.get_wafer_entry(wafer);
+			HICANNEntry const entry = as<HICANNYAML>(hicanns_node);
+			for (auto const& item : wafer_entry.fpgas) {
+				wafer_entry.set_hicanns(item.first, entry);
+			}
+		} else {
+			throw std::runtime_error("hicanns entry must be a squence or a map");
+		}
+	}
+
+	// yaml node is from a dls setup
+	else if (config["dls_setup"].IsDefined()) {
+		auto dls_setup = get_entry<std::string>(config, "dls_setup");
+		db.add_dls_entry(dls_setup, DLSSetupEntry());
+		DLSSetupEntry& entry = db.get_dls_entry(dls_setup);
+
+		auto fpga_name_entry = config["fpga_name"];
+		if (fpga_name_entry.IsDefined()) {
+			entry.fpga_name = as<std::string>(fpga_name_entry);
+		}
+
+		auto board_name_entry = config["board_name"];
+		if (board_name_entry.IsDefined()) {
+			entry.board_name = as<std::string>(board_name_entry);
+		}
+
+		auto board_version_entry = config["board_version"];
+		if (board_version_entry.IsDefined()) {
+			entry.board_version = as<size_t>(board_version_entry);
+		}
+
+		auto chip_id_entry = config["chip_id"];
+		if (chip_id_entry.IsDefined()) {
+			entry.chip_id = as<size_t>(chip_id_entry);
+		}
+
+		auto chip_version_entry = config["chip_version"];
+		if (chip_version_entry.IsDefined()) {
+			entry.chip_version = as<size_t>(chip_version_entry);
+		}
+
+		auto ntpwr_ip_entry = config["ntpwr_ip"];
+		if (ntpwr_ip_entry.IsDefined()) {
+			entry.ntpwr_ip = as<std::string>(ntpwr_ip_entry);
+		}
+
+		auto ntpwr_slot_entry = config["ntpwr_slot"];
+		if (ntpwr_slot_entry.IsDefined()) {
+			entry.ntpwr_slot = as<size_t>(ntpwr_slot_entry);
+		}
+	}
+	// yaml node is from a HXCube setup
+	else if (config["hxcube_id"].IsDefined()) {
+		auto hxcube_id = get_entry<size_t>(config, "hxcube_id");
+		HXCubeSetupEntry setup;
+		setup.hxcube_id = hxcube_id;
+		db.add_hxcube_setup_entry(hxcube_id, setup);
+		HXCubeSetupEntry& entry = db.get_hxcube_setup_entry(hxcube_id);
+
+		auto fpga_entries = config["fpgas"];
+		if (fpga_entries.IsDefined()) {
+			for_each_entry<HXFPGAYAML>(fpga_entries, [&](HXFPGAYAML const& fpga) {
+				for (size_t i = 0; i < fpga.count; ++i) {
+					auto const item = range_item(fpga, i);
+					entry.fpgas[item.coordinate] = static_cast<HXCubeFPGAEntry const&>(item);
+				}
+			});
+		}
+
+		auto usb_host_entry = config["usb_host"];
+		if (usb_host_entry.IsDefined()) {
+			entry.usb_host = as<std::string>(usb_host_entry);
+		}
+
+		auto usb_serial_entry = config["usb_serial"];
+		if (usb_serial_entry.IsDefined()) {
+			entry.usb_serial = as<std::string>(usb_serial_entry);
+		}
+
+		auto xilinx_hw_server_entry = config["xilinx_hw_server"];
+		if (xilinx_hw_server_entry.IsDefined()) {
+			entry.xilinx_hw_server = as<std::string>(xilinx_hw_server_entry);
+		}
+	}
+	// yaml node is from a jBOA setup
+	else if (config["jboa_id"].IsDefined()) {
+		auto jboa_id = get_entry<size_t>(config, "jboa_id");
+		JboaSetupEntry setup;
+		setup.jboa_id = jboa_id;
+		db.add_jboa_setup_entry(jboa_id, setup);
+		JboaSetupEntry& entry = db.get_jboa_setup_entry(jboa_id);
+
+		auto fpga_entries = config["fpgas"];
+		if (fpga_entries.IsDefined()) {
+			for_each_entry<HXFPGAYAML>(fpga_entries, [&](HXFPGAYAML const& fpga) {
+				for (size_t i = 0; i < fpga.count; ++i) {
+					auto const item = range_item(fpga, i);
+					entry.fpgas[item.coordinate] = static_cast<HXCubeFPGAEntry const&>(item);
+				}
+			});
+		}
+
+		auto aggregator_entries = config["aggregators"];
+		if (aggregator_entries.IsDefined()) {
+			for_each_entry<JboaAggregatorYAML>(
+			    aggregator_entries, [&](JboaAggregatorYAML const& aggregator) {
+				    entry.aggregators[aggregator.coordinate] =
+				        static_cast<JboaAggregatorEntry const&>(aggregator);
+			    });
+		}
+
+		auto xilinx_hw_server_entry = config["xilinx_hw_server"];
+		if (xilinx_hw_server_entry.IsDefined()) {
+			entry.xilinx_hw_server = as<std::string>(xilinx_hw_server_entry);
+		}
+	}
+	// yaml node does not contain wafer or dls setup or hxcube setup or jboa setup
+	else {
+		log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+		LOG4CXX_WARN(logger, "Found node entry neither from Wafer, DLS setup nor HX setup, ignore");
+	}
+}
+
+/// YAML key identifying documents of family
+char const* get_family_key(SetupFamily const family)
+{
+	switch (family) {
+		case SetupFamily::wafer:
+			return "wafer";
+		case SetupFamily::dls_setup:
+			return "dls_setup";
+		case SetupFamily::hxcube:
+			return "hxcube_id";
+		case SetupFamily::jboa:
+			return "jboa_id";
+	}
+	throw std::logic_error("unknown setup family");
+}
+
+/// Check if a path of list_fragments is named like the fragments of dump_fragments,
+/// <family key>_<id>.yaml
+bool is_fragment_path(std::string const& path)
+{
+	std::string const name = path.substr(path.rfind('/') + 1);
+	for (auto const family :
+	     {SetupFamily::wafer, SetupFamily::dls_setup, SetupFamily::hxcube, SetupFamily::jboa}) {
+		std::string const prefix = std::string(get_family_key(family)) + "_";
+		if (name.size() > prefix.size() + 5 && name.compare(0, prefix.size(), prefix) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/// Sorted paths of the fragment files (*.yaml, not hidden) in directory
+std::vector<std::string> list_fragments(std::string const& directory)
+{
+	DIR* dir = opendir(directory.c_str());
+	if (dir == nullptr) {
+		throw std::runtime_error("cannot open hwdb directory " + directory);
+	}
+	std::vector<std::string> paths;
+	while (dirent const* entry = readdir(dir)) {
+		std::string_view const name(entry->d_name);
+		if (name.empty() || name[0] == '.' || name.size() <= 5 ||
+		    name.compare(name.size() - 5, 5, ".yaml") != 0) {
+			continue;
+		}
+		std::string const path = directory + "/" + std::string(name);
+		struct stat st;
+		if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+			paths.push_back(path);
+		}
+	}
+	closedir(dir);
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+/// Determine family and id of a single document from its text, without parsing
+/// it. Only top level keys at the start of a line with a simple scalar value are
+/// considered. Returns false if the family could not be determined reliably.
+bool scan_document_key(std::string_view const document, SetupFamily& family, std::string& id)
+{
+	// discriminating keys in the order they are checked for in load_document
+	static std::array<std::pair<std::string_view, SetupFamily>, 4> const keys = {
+	    {{"wafer", SetupFamily::wafer},
+	     {"dls_setup", SetupFamily::dls_setup},
+	     {"hxcube_id", SetupFamily::hxcube},
+	     {"jboa_id", SetupFamily::jboa}}};
+	std::array<std::optional<std::string_view>, 4> values;
+	bool first_line = true;
+	bool value_may_continue = false;
+
+	for (size_t pos = 0; pos < document.size();) {
+		size_t const eol = std::min(document.find('\n', pos), document.size());
+		std::string_view const line = document.substr(pos, eol - pos);
+		pos = eol + 1;
+
+		bool const indented = !line.empty() && (line[0] == ' ' || line[0] == '\t');
+		bool const blank = line.find_first_not_of(" \t\r") == std::string_view::npos;
+		if (value_may_continue && indented && !blank &&
+		    line[line.find_first_not_of(" \t")] != '#') {
+			// multi-line scalar
+			return false;
+		}
+		if (indented || blank) {
+			continue;
+		}
+		value_may_continue = false;
+		if (line.compare(0, 3, "---") == 0 || line.compare(0, 3, "...") == 0) {
+			if (!first_line) {
+				// more than one document
+				return false;
+			}
+			continue;
+		}
+		first_line = false;
+
+		for (size_t i = 0; i < keys.size(); ++i) {
+			std::string_view const key = keys[i].first;
+			if (line.compare(0, key.size(), key) != 0) {
+				continue;
+			}
+			size_t const colon = line.find_first_not_of(" \t", key.size());
+			if (colon == std::string_view::npos || line[colon] != ':' ||
+			    (colon + 1 < line.size() && !std::isspace(static_cast<unsigned char>(line[colon + 1])))) {
+				continue;
+			}
+			if (!values[i]) {
+				values[i] = line.substr(colon + 1);
+				value_may_continue = true;
+			}
+		}
+	}
+
+	size_t const index =
+	    std::find_if(values.begin(), values.end(), [](auto const& v) { return v.has_value(); }) -
+	    values.begin();
+	if (index == values.size()) {
+		return false;
+	}
+	family = keys[index].second;
+
+	std::string_view value = *values[index];
+	size_t const begin = value.find_first_not_of(" \t");
+	if (begin == std::string_view::npos) {
+		return false;
+	}
+	value = value.substr(begin);
+	std::string_view rest;
+	if (value[0] == '\'') {
+		id.clear();
+		size_t i = 1;
+		for (; i < value.size(); ++i) {
+			if (value[i] == '\'') {
+				if (i + 1 < value.size() && value[i + 1] == '\'') {
+					++i;
+				} else {
+					break;
+				}
+			}
+			id.push_back(value[i]);
+		}
+		if (i >= value.size()) {
+			return false;
+		}
+		rest = value.substr(i + 1);
+	} else if (value[0] == '"') {
+		size_t const end = value.find('"', 1);
+		if (end == std::string_view::npos || value.substr(0, end).find('\\') != std::string_view::npos) {
+			return false;
+		}
+		id = value.substr(1, end - 1);
+		rest = value.substr(end + 1);
+	} else {
+		// plain scalar, anything with special meaning is left to the parser
+		if (std::string_view("&*!|>[]{}@`%#,?:-").find(value[0]) != std::string_view::npos) {
+			return false;
+		}
+		size_t end = value.find(" #");
+		if (end == std::string_view::npos) {
+			end = value.find("\t#");
+		}
+		value = value.substr(0, end);
+		id = value.substr(0, value.find_last_not_of(" \t\r") + 1);
+		if (id == "~" || id == "null" || id == "Null" || id == "NULL") {
+			return false;
+		}
+	}
+	size_t const rest_begin = rest.find_first_not_of(" \t\r");
+	if (rest_begin != std::string_view::npos && rest[rest_begin] != '#') {
+		return false;
+	}
+
+	if (family != SetupFamily::dls_setup) {
+		size_t numerical_id;
+		if (!parse_unsigned(id, numerical_id)) {
+			return false;
+		}
+		id = std::to_string(numerical_id);
+	}
+	return true;
+}
+
+/// Split YAML file content into chunks at document start markers ('---' at the
+/// beginning of a line), each chunk holding a single document. Returns the whole
+/// content as a single chunk if it contains directives, which apply to all
+/// following documents.
+std::vector<std::string_view> split_documents(std::string_view const content)
+{
+	std::vector<size_t> starts = {0};
+	for (size_t pos = 0; pos < content.size();) {
+		size_t const eol = std::min(content.find('\n', pos), content.size());
+		if (content[pos] == '%')
+			return {content};
+		if (content.compare(pos, 3, "---") == 0 &&
+		    (pos + 3 == eol || std::isspace(static_cast<unsigned char>(content[pos + 3]))) &&
+		    pos != 0)
+			starts.push_back(pos);
+		pos = eol + 1;
+	}
+
+	std::vector<std::string_view> documents;
+	documents.reserve(starts.size());
+	for (size_t i = 0; i < starts.size(); ++i) {
+		size_t const end = (i + 1 < starts.size()) ? starts[i + 1] : content.size();
+		documents.push_back(content.substr(starts[i], end - starts[i]));
+	}
+	return documents;
+}
+
+/// Decode all YAML documents in text into db
+void decode_documents(database& db, std::string_view const text, LoadOptions::Parser const parser)
+{
+	detail::MemoryStreambuf buffer(text);
+	std::istream stream(&buffer);
+	if (parser == LoadOptions::Parser::event) {
+		YAML::Parser yaml_parser(stream);
+		EventDocument document;
+		EventDocumentBuilder builder(document);
+		while (yaml_parser.HandleNextDocument(builder)) {
+			load_document(db, EventNode(document, 0));
+		}
+	} else {
+		for (YAML::Node& config : YAML::LoadAll(stream)) {
+			load_document(db, config);
+		}
+	}
+}
+
+/// Worker threads shared by all loads of the process, started on first use.
+/// Callers of run take part in their batch, so batches complete even if all
+/// workers are busy with other batches, e.g. of concurrent or asynchronous loads.
+class WorkerPool
+{
+public:
+	static WorkerPool& instance()
+	{
+		static WorkerPool pool;
+		return pool;
+	}
+
+	/// Run task(i) for all i < count, the first exception of a task is rethrown
+	/// after all started tasks have finished
+	template <typename Task>
+	void run(size_t const count, Task const& task)
+	{
+		auto const batch = std::make_shared<Batch>(count);
+		// helpers starting after the batch was completed find no index left and
+		// therefore never call the task, which lives on this stack only
+		std::function<void(size_t)> const function = std::cref(task);
+		batch->task = &function;
+		try {
+			// the calling thread is one of the workers of the batch
+			for (size_t i = 0; i + 1 < std::min(m_threads.size() + 1, count); ++i) {
+				submit([batch]() { batch->work(); });
+			}
+		} catch (std::bad_alloc const&) {
+			// fewer helpers, the submitted ones are waited for below
+		}
+		batch->work();
+		std::unique_lock<std::mutex> lock(batch->mutex);
+		batch->done.wait(lock, [&batch]() { return batch->active == 0; });
+		if (batch->error) {
+			std::rethrow_exception(batch->error);
+		}
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> const lock(m_mutex);
+			m_stop = true;
+		}
+		m_wakeup.notify_all();
+		for (auto& thread : m_threads) {
+			thread.join();
+		}
+	}
+
+private:
+	struct Batch
+	{
+		explicit Batch(size_t const count) : count(count) {}
+
+		void work()
+		{
+			{
+				std::lock_guard<std::mutex> const lock(mutex);
+				++active;
+			}
+			try {
+				for (size_t i = next++; i < count; i = next++) {
+					(*task)(i);
+				}
+			} catch (...) {
+				// skip remaining tasks
+				next = count;
+				std::lock_guard<std::mutex> const lock(mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+			std::lock_guard<std::mutex> const lock(mutex);
+			if (--active == 0) {
+				done.notify_all();
+			}
+		}
+
+		size_t const count;
+		std::atomic<size_t> next{0};
+		std::function<void(size_t)> const* task = nullptr;
+		std::mutex mutex;
+		std::condition_variable done;
+		size_t active = 0;
+		std::exception_ptr error;
+	};
+
+	WorkerPool()
+	{
+		size_t const num_threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+		try {
+			for (size_t i = 0; i < num_threads; ++i) {
+				m_threads.emplace_back([this]() { serve(); });
+			}
+		} catch (std::system_error const&) {
+			// fewer workers if threads cannot be started, callers do the work themselves
+		}
+	}
+
+	void submit(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> const lock(m_mutex);
+			m_jobs.push_back(std::move(job));
+		}
+		m_wakeup.notify_one();
+	}
+
+	void serve()
+	{
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wakeup.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+				if (m_stop) {
+					return;
+				}
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+			job();
+		}
+	}
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeup;
+	std::deque<std::function<void()> > m_jobs;
+	bool m_stop = false;
+};
+
+/// Run task(i) for all i < count on the shared worker threads
+template <typename Task>
+void run_parallel(size_t const count, Task const& task)
+{
+	if (count <= 1) {
+		for (size_t i = 0; i < count; ++i) {
+			task(i);
+		}
+		return;
+	}
+	WorkerPool::instance().run(count, task);
+}
+
+/// Setups defined in db
+std::vector<ReloadSummary::Setup> get_setups(database const& db)
+{
+	std::vector<ReloadSummary::Setup> setups;
+	db.for_each_wafer_coordinate([&setups](Wafer const wafer) {
+		setups.emplace_back(SetupFamily::wafer, std::to_string(wafer.value()));
+	});
+	db.for_each_dls_setup_id([&setups](std::string const& dls_setup) {
+		setups.emplace_back(SetupFamily::dls_setup, dls_setup);
+	});
+	db.for_each_hxcube_id([&setups](size_t const hxcube_id) {
+		setups.emplace_back(SetupFamily::hxcube, std::to_string(hxcube_id));
+	});
+	db.for_each_jboa_id([&setups](size_t const jboa_id) {
+		setups.emplace_back(SetupFamily::jboa, std::to_string(jboa_id));
+	});
+	return setups;
+}
+
+/// Map the file at path, or all fragment files if path is a directory
+std::shared_ptr<void const> map_path(
+    std::string const& path, std::vector<std::pair<std::string, std::string_view> >& fragments)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+		auto const files =
+		    std::make_shared<std::vector<std::unique_ptr<detail::MappedFile const> > >();
+		for (auto const& fragment_path : list_fragments(path)) {
+			files->push_back(std::make_unique<detail::MappedFile const>(fragment_path));
+			fragments.emplace_back(fragment_path, files->back()->data());
+		}
+		return files;
+	}
+
+	auto const file = std::make_shared<detail::MappedFile const>(path);
+	fragments.emplace_back(path, file->data());
+	return file;
+}
+
+/// Throw if a setup is defined in documents of different fragments
+void check_fragment_conflicts(
+    std::vector<std::pair<std::string, std::string_view> > const& fragments,
+    std::vector<size_t> const& document_fragments,
+    std::vector<std::vector<ReloadSummary::Setup> > const& document_setups)
+{
+	if (fragments.size() < 2)
+		return;
+	std::map<ReloadSummary::Setup, size_t> origins;
+	for (size_t i = 0; i < document_setups.size(); ++i) {
+		size_t const fragment = document_fragments[i];
+		for (auto const& setup : document_setups[i]) {
+			auto const [it, inserted] = origins.emplace(setup, fragment);
+			if (!inserted && it->second != fragment) {
+				throw std::runtime_error(
+				    "conflicting definitions of " + std::string(get_family_key(setup.first)) +
+				    " " + setup.second + " in " + fragments[it->second].first + " and " +
+				    fragments[fragment].first);
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+bool ReloadSummary::empty() const
+{
+	return added.empty() && changed.empty() && removed.empty();
+}
+
+void LoadFilter::add(SetupFamily const family)
+{
+	m_selection[family].clear();
+}
+
+void LoadFilter::add(SetupFamily const family, std::string const& id)
+{
+	std::string normalized_id = id;
+	if (family != SetupFamily::dls_setup) {
+		size_t numerical_id;
+		if (!parse_unsigned(id, numerical_id)) {
+			throw std::invalid_argument("id of setup has to be a number: " + id);
+		}
+		normalized_id = std::to_string(numerical_id);
+	}
+
+	auto const it = m_selection.find(family);
+	if (it == m_selection.end()) {
+		m_selection[family].insert(normalized_id);
+	} else if (!it->second.empty()) {
+		// otherwise whole family is already selected
+		it->second.insert(normalized_id);
+	}
+}
+
+void LoadFilter::add(SetupFamily const family, size_t const id)
+{
+	if (family == SetupFamily::dls_setup) {
+		throw std::invalid_argument("id of DLS setup has to be a string");
+	}
+	add(family, std::to_string(id));
+}
+
+bool LoadFilter::contains(SetupFamily const family, std::string const& id) const
+{
+	if (m_selection.empty()) {
+		return true;
+	}
+	auto const it = m_selection.find(family);
+	return it != m_selection.end() && (it->second.empty() || it->second.count(id));
+}
+
+bool LoadFilter::empty() const
+{
+	return m_selection.empty();
+}
+
+void database::load(std::string const path)
+{
+	load(path, LoadOptions());
+}
+
+std::future<void> database::load_async(std::string const path)
+{
+	return load_async(path, LoadOptions());
+}
+
+std::future<void> database::load_async(std::string const path, LoadOptions const& options)
+{
+	return std::async(std::launch::async, [this, path, options] { load(path, options); });
+}
+
+void database::load(std::string const path, LoadOptions const& options)
+{
+	check_empty();
+
+	// fast path: use an up-to-date binary snapshot of the YAML file if available
+	if (options.use_snapshot && load_snapshot(path)) {
+		erase_unselected(*this, options.filter);
+		mLoadRecord.options = options;
+		invalidate_indexes();
+		return;
+	}
+
+	std::vector<std::pair<std::string, std::string_view> > fragments;
+	auto const file = map_path(path, fragments);
+	load_fragments(fragments, options);
+}
+
+void database::load_from_buffer(std::string_view const buffer)
+{
+	load_from_buffer(buffer, LoadOptions());
+}
+
+void database::load_from_buffer(std::string_view const buffer, LoadOptions const& options)
+{
+	check_empty();
+	load_content(buffer, options);
+}
+
+void database::load_from_fd(int const fd)
+{
+	load_from_fd(fd, LoadOptions());
+}
+
+void database::load_from_fd(int const fd, LoadOptions const& options)
+{
+	check_empty();
+	auto const file = std::make_shared<detail::MappedFile const>(fd);
+	load_content(file->data(), options);
+}
+
+void database::check_empty() const
+{
+	if (!(mWaferData.empty() && mDLSData.empty() && mHXCubeData.empty() && mJboaData.empty() &&
+	      mPending.empty()))
+		throw std::runtime_error("database has to be empty before loading new file");
+}
+
+void database::erase_unselected(database& db, LoadFilter const& filter)
+{
+	if (filter.empty())
+		return;
+	for (auto it = db.mWaferData.begin(); it != db.mWaferData.end();) {
+		bool const selected = filter.contains(SetupFamily::wafer, std::to_string(it->first.value()));
+		it = selected ? std::next(it) : db.mWaferData.erase(it);
+	}
+	for (auto it = db.mDLSData.begin(); it != db.mDLSData.end();) {
+		bool const selected = filter.contains(SetupFamily::dls_setup, it->first);
+		it = selected ? std::next(it) : db.mDLSData.erase(it);
+	}
+	for (auto it = db.mHXCubeData.begin(); it != db.mHXCubeData.end();) {
+		bool const selected = filter.contains(SetupFamily::hxcube, std::to_string(it->first));
+		it = selected ? std::next(it) : db.mHXCubeData.erase(it);
+	}
+	for (auto it = db.mJboaData.begin(); it != db.mJboaData.end();) {
+		bool const selected = filter.contains(SetupFamily::jboa, std::to_string(it->first));
+		it = selected ? std::next(it) : db.mJboaData.erase(it);
+	}
+}
+
+void database::load_content(std::string_view const content, LoadOptions const& options)
+{
+	load_fragments({{std::string(), content}}, options);
+}
+
+void database::load_fragments(
+    std::vector<std::pair<std::string, std::string_view> > const& fragments,
+    LoadOptions const& options)
+{
+	invalidate_indexes();
+	auto const& filter = options.filter;
+
+	// The documents are independent of each other, each one is decoded into a
+	// separate database by a pool of worker threads. In lazy mode, documents with
+	// known family and id are only recorded.
+	std::vector<std::string_view> documents;
+	std::vector<size_t> document_fragments;
+	for (size_t fragment = 0; fragment < fragments.size(); ++fragment) {
+		for (auto const document : split_documents(fragments[fragment].second)) {
+			documents.push_back(document);
+			document_fragments.push_back(fragment);
+		}
+	}
+	std::vector<database> results(documents.size());
+	std::vector<std::optional<std::pair<SetupFamily, std::string>>> pending(documents.size());
+	std::vector<uint64_t> hashes(documents.size());
+	std::vector<std::exception_ptr> errors(documents.size());
+
+	run_parallel(documents.size(), [&](size_t const i) {
+		hashes[i] = detail::fnv1a(documents[i].data(), documents[i].size());
+		SetupFamily family;
+		std::string id;
+		if ((!filter.empty() || options.lazy) && scan_document_key(documents[i], family, id)) {
+			// skip unselected documents without decoding them
+			if (!filter.contains(family, id))
+				return;
+			if (options.lazy) {
+				pending[i] = std::make_pair(family, id);
+				return;
+			}
+		}
+		try {
+			decode_documents(results[i], documents[i], options.parser);
+			// documents whose family could not be determined beforehand
+			erase_unselected(results[i], filter);
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+	});
+
+	// report the error of the first failing document, nothing is loaded in this case
+	for (auto const& error : errors) {
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	// A setup may only be defined in a single fragment, within a fragment later
+	// documents replace earlier ones.
+	std::vector<std::vector<ReloadSummary::Setup> > document_setups(documents.size());
+	for (size_t i = 0; i < documents.size(); ++i) {
+		document_setups[i] = pending[i] ? std::vector<ReloadSummary::Setup>{*pending[i]}
+		                                : get_setups(results[i]);
+	}
+	check_fragment_conflicts(fragments, document_fragments, document_setups);
+
+	// Pending documents are copied, the loaded file or buffer may change or vanish
+	// before they are decoded. Reserved upfront so that the views stay valid.
+	size_t pending_size = 0;
+	for (size_t i = 0; i < documents.size(); ++i) {
+		if (pending[i])
+			pending_size += documents[i].size();
+	}
+	auto const pending_text = std::make_shared<std::string>();
+	pending_text->reserve(pending_size);
+	for (size_t i = 0; i < documents.size(); ++i) {
+		if (pending[i]) {
+			size_t const offset = pending_text->size();
+			pending_text->append(documents[i]);
+			documents[i] = std::string_view(pending_text->data() + offset, documents[i].size());
+		}
+	}
+
+	// merge in file order, later documents replace earlier ones with the same id
+	mPending.source = pending_text;
+	mPending.parser = options.parser;
+	for (size_t i = 0; i < documents.size(); ++i) {
+		if (pending[i]) {
+			std::string const& id = pending[i]->second;
+			switch (pending[i]->first) {
+				case SetupFamily::wafer: {
+					Wafer const wafer(std::stoull(id));
+					mWaferData.erase(wafer);
+					mPending.wafers[wafer] = documents[i];
+					break;
+				}
+				case SetupFamily::dls_setup:
+					mDLSData.erase(id);
+					mPending.dls_setups[id] = documents[i];
+					break;
+				case SetupFamily::hxcube:
+					mHXCubeData.erase(std::stoull(id));
+					mPending.hxcube_setups[std::stoull(id)] = documents[i];
+					break;
+				case SetupFamily::jboa:
+					mJboaData.erase(std::stoull(id));
+					mPending.jboa_setups[std::stoull(id)] = documents[i];
+					break;
+			}
+			continue;
+		}
+
+		auto& result = results[i];
+		for (auto& item : result.mWaferData) {
+			mPending.wafers.erase(item.first);
+			mWaferData.insert_or_assign(item.first, std::move(item.second));
+		}
+		for (auto& item : result.mDLSData) {
+			mPending.dls_setups.erase(item.first);
+			mDLSData.insert_or_assign(item.first, std::move(item.second));
+		}
+		for (auto& item : result.mHXCubeData) {
+			mPending.hxcube_setups.erase(item.first);
+			mHXCubeData.insert_or_assign(item.first, std::move(item.second));
+		}
+		for (auto& item : result.mJboaData) {
+			mPending.jboa_setups.erase(item.first);
+			mJboaData.insert_or_assign(item.first, std::move(item.second));
+		}
+	}
+	if (mPending.empty())
+		mPending.source.reset();
+	mLazy = !mPending.empty();
+
+	mLoadRecord.options = options;
+	mLoadRecord.complete = true;
+	mLoadRecord.documents.clear();
+	for (size_t i = 0; i < documents.size(); ++i) {
+		mLoadRecord.documents.push_back({hashes[i], std::move(document_setups[i])});
+	}
+}
+
+ReloadSummary database::reload(std::string const path)
+{
+	invalidate_indexes();
+	materialize();
+	LoadOptions options = mLoadRecord.options;
+	options.lazy = false;
+	auto const& filter = options.filter;
+
+	std::vector<std::pair<std::string, std::string_view> > fragments;
+	auto const owner = map_path(path, fragments);
+	std::vector<std::string_view> documents;
+	std::vector<size_t> document_fragments;
+	for (size_t fragment = 0; fragment < fragments.size(); ++fragment) {
+		for (auto const document : split_documents(fragments[fragment].second)) {
+			documents.push_back(document);
+			document_fragments.push_back(fragment);
+		}
+	}
+	std::vector<uint64_t> hashes(documents.size());
+	run_parallel(documents.size(), [&](size_t const i) {
+		hashes[i] = detail::fnv1a(documents[i].data(), documents[i].size());
+	});
+
+	// documents with unchanged text define the same setups as before
+	std::multimap<uint64_t, size_t> previous;
+	for (size_t i = 0; i < mLoadRecord.documents.size(); ++i) {
+		previous.emplace(mLoadRecord.documents[i].hash, i);
+	}
+	std::vector<std::optional<size_t> > unchanged(documents.size());
+	for (size_t i = 0; i < documents.size(); ++i) {
+		auto const it = previous.find(hashes[i]);
+		if (it != previous.end()) {
+			unchanged[i] = it->second;
+			previous.erase(it);
+		}
+	}
+
+	std::vector<database> results(documents.size());
+	std::vector<std::exception_ptr> errors(documents.size());
+	auto const decode = [&](size_t const i) {
+		SetupFamily family;
+		std::string id;
+		if (!filter.empty() && scan_document_key(documents[i], family, id) &&
+		    !filter.contains(family, id))
+			return;
+		try {
+			decode_documents(results[i], documents[i], options.parser);
+			erase_unselected(results[i], filter);
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+	};
+	auto const rethrow = [&errors]() {
+		for (auto const& error : errors) {
+			if (error)
+				std::rethrow_exception(error);
+		}
+	};
+
+	std::vector<size_t> changed;
+	for (size_t i = 0; i < documents.size(); ++i) {
+		if (!unchanged[i])
+			changed.push_back(i);
+	}
+	run_parallel(changed.size(), [&](size_t const i) { decode(changed[i]); });
+	rethrow();
+
+	std::vector<std::vector<ReloadSummary::Setup> > document_setups(documents.size());
+	for (size_t i = 0; i < documents.size(); ++i) {
+		document_setups[i] =
+		    unchanged[i] ? mLoadRecord.documents[*unchanged[i]].setups : get_setups(results[i]);
+	}
+	check_fragment_conflicts(fragments, document_fragments, document_setups);
+
+	// The last document defining a setup determines its value. A setup is affected
+	// if that document changed, which includes setups added or removed.
+	std::map<ReloadSummary::Setup, uint64_t> previous_winners;
+	for (auto const& document : mLoadRecord.documents) {
+		for (auto const& setup : document.setups) {
+			previous_winners[setup] = document.hash;
+		}
+	}
+	std::map<ReloadSummary::Setup, size_t> winners;
+	for (size_t i = 0; i < documents.size(); ++i) {
+		for (auto const& setup : document_setups[i]) {
+			winners[setup] = i;
+		}
+	}
+	std::set<ReloadSummary::Setup> affected;
+	if (!mLoadRecord.complete) {
+		for (auto const& setup : get_setups(*this)) {
+			affected.insert(setup);
+		}
+	}
+	for (auto const& [setup, hash] : previous_winners) {
+		auto const it = winners.find(setup);
+		if (it == winners.end() || hashes[it->second] != hash)
+			affected.insert(setup);
+	}
+	for (auto const& [setup, document] : winners) {
+		auto const it = previous_winners.find(setup);
+		if (!mLoadRecord.complete || it == previous_winners.end() || it->second != hashes[document])
+			affected.insert(setup);
+	}
+
+	// unchanged documents still have to be decoded if their setups are affected
+	std::vector<size_t> redecode;
+	for (auto const& [setup, document] : winners) {
+		if (unchanged[document] && affected.count(setup))
+			redecode.push_back(document);
+	}
+	std::sort(redecode.begin(), redecode.end());
+	redecode.erase(std::unique(redecode.begin(), redecode.end()), redecode.end());
+	run_parallel(redecode.size(), [&](size_t const i) { decode(redecode[i]); });
+	rethrow();
+
+	// replace affected setups by the values of their last defining document
+	ReloadSummary summary;
+	for (auto const& setup : affected) {
+		auto const& [family, id] = setup;
+		auto const winner = winners.find(setup);
+		database* const result = (winner != winners.end()) ? &results[winner->second] : nullptr;
+		bool existed = false;
+		bool exists = false;
+		switch (family) {
+			case SetupFamily::wafer: {
+				Wafer const wafer(std::stoull(id));
+				existed = mWaferData.erase(wafer);
+				if (result && result->mWaferData.count(wafer)) {
+					mWaferData[wafer] = std::move(result->mWaferData.at(wafer));
+					exists = true;
+				}
+				break;
+			}
+			case SetupFamily::dls_setup:
+				existed = mDLSData.erase(id);
+				if (result && result->mDLSData.count(id)) {
+					mDLSData[id] = std::move(result->mDLSData.at(id));
+					exists = true;
+				}
+				break;
+			case SetupFamily::hxcube:
+				existed = mHXCubeData.erase(std::stoull(id));
+				if (result && result->mHXCubeData.count(std::stoull(id))) {
+					mHXCubeData[std::stoull(id)] = std::move(result->mHXCubeData.at(std::stoull(id)));
+					exists = true;
+				}
+				break;
+			case SetupFamily::jboa:
+				existed = mJboaData.erase(std::stoull(id));
+				if (result && result->mJboaData.count(std::stoull(id))) {
+					mJboaData[std::stoull(id)] = std::move(result->mJboaData.at(std::stoull(id)));
+					exists = true;
+				}
+				break;
+		}
+		if (existed && exists) {
+			summary.changed.push_back(setup);
+		} else if (exists) {
+			summary.added.push_back(setup);
+		} else if (existed) {
+			summary.removed.push_back(setup);
+		}
+	}
+
+	mLoadRecord.complete = true;
+	mLoadRecord.documents.clear();
+	for (size_t i = 0; i < documents.size(); ++i) {
+		mLoadRecord.documents.push_back({hashes[i], std::move(document_setups[i])});
+	}
+	return summary;
+}
+
+void database::PendingDocuments::clear()
+{
+	source.reset();
+	parser = LoadOptions::Parser::node;
+	wafers.clear();
+	dls_setups.clear();
+	hxcube_setups.clear();
+	jboa_setups.clear();
+}
+
+bool database::PendingDocuments::empty() const
+{
+	return wafers.empty() && dls_setups.empty() && hxcube_setups.empty() && jboa_setups.empty();
+}
+
+namespace {
+/// Entry decoded from the pending document of a setup, the whole document is decoded
+/// while only its key was scanned when loading.
+template <typename Map, typename Key>
+typename Map::mapped_type take_decoded(
+    Map& decoded, Key const& key, SetupFamily const family, std::string const& id)
+{
+	auto const it = decoded.find(key);
+	if (it == decoded.end()) {
+		throw std::runtime_error(
+		    "lazily loaded hwdb document of " + std::string(get_family_key(family)) + " " + id +
+		    " does not define it");
+	}
+	return std::move(it->second);
+}
+} // anonymous namespace
+
+void database::materialize_wafer(Wafer const wafer) const
+{
+	auto const it = mPending.wafers.find(wafer);
+	if (it == mPending.wafers.end())
+		return;
+	database result;
+	decode_documents(result, it->second, mPending.parser);
+	auto entry =
+	    take_decoded(result.mWaferData, wafer, SetupFamily::wafer, std::to_string(wafer.value()));
+	mWaferData.insert_or_assign(wafer, std::move(entry));
+	mPending.wafers.erase(it);
+}
+
+void database::materialize_dls_setup(std::string const& dls_setup) const
+{
+	auto const it = mPending.dls_setups.find(dls_setup);
+	if (it == mPending.dls_setups.end())
+		return;
+	database result;
+	decode_documents(result, it->second, mPending.parser);
+	auto entry = take_decoded(result.mDLSData, dls_setup, SetupFamily::dls_setup, dls_setup);
+	mDLSData.insert_or_assign(dls_setup, std::move(entry));
+	mPending.dls_setups.erase(it);
+}
+
+void database::materialize_hxcube_setup(size_t const hxcube_id) const
+{
+	auto const it = mPending.hxcube_setups.find(hxcube_id);
+	if (it == mPending.hxcube_setups.end())
+		return;
+	database result;
+	decode_documents(result, it->second, mPending.parser);
+	auto entry = take_decoded(
+	    result.mHXCubeData, hxcube_id, SetupFamily::hxcube, std::to_string(hxcube_id));
+	mHXCubeData.insert_or_assign(hxcube_id, std::move(entry));
+	mPending.hxcube_setups.erase(it);
+}
+
+void database::materialize_jboa_setup(size_t const jboa_id) const
+{
+	auto const it = mPending.jboa_setups.find(jboa_id);
+	if (it == mPending.jboa_setups.end())
+		return;
+	database result;
+	decode_documents(result, it->second, mPending.parser);
+	auto entry =
+	    take_decoded(result.mJboaData, jboa_id, SetupFamily::jboa, std::to_string(jboa_id));
+	mJboaData.insert_or_assign(jboa_id, std::move(entry));
+	mPending.jboa_setups.erase(it);
+}
+
+std::unique_lock<std::recursive_mutex> database::lock_pending() const
+{
+	if (!mLazy) {
+		// nothing is modified by const accessors anymore
+		return std::unique_lock<std::recursive_mutex>();
+	}
+	return std::unique_lock<std::recursive_mutex>(mMutex);
+}
+
+void database::materialize() const
+{
+	auto const lock = lock_pending();
+	// keys refer into the pending maps, their documents are erased after use
+	while (!mPending.wafers.empty())
+		materialize_wafer(mPending.wafers.begin()->first);
+	while (!mPending.dls_setups.empty())
+		materialize_dls_setup(mPending.dls_setups.begin()->first);
+	while (!mPending.hxcube_setups.empty())
+		materialize_hxcube_setup(mPending.hxcube_setups.begin()->first);
+	while (!mPending.jboa_setups.empty())
+		materialize_jboa_setup(mPending.jboa_setups.begin()->first);
+	mPending.source.reset();
+	// last modification, accessors seeing the flag cleared do not lock
+	mLazy = false;
+}
+
+namespace {
+/// Check that all HICANNs are in the vector and that they have the
+/// same settings
+bool can_merge_hicanns(const std::vector<HICANNYAML>& data)
 {
 	if (data.size() != HICANNOnWafer::enum_type::size) {
 		return false;
@@ -724,317 +3310,457 @@ bool can_merge_hicanns(const std::vector<HICANNYAML>& data)
 
 /// Better error messages while decoding nodes are upstream, but not in the
 /// currently released version: see https://github.com/jbeder/yaml-cpp/issues/200
-void database::dump(std::ostream& out) const
+namespace {
+
+// Serialize entries entry-by-entry to maintain a nice order.
+// There is an unresolved issue about this
+// https://github.com/jbeder/yaml-cpp/issues/169
+// so this might getting nicer in future
+
+void dump_wafer_entry(std::ostream& out, Wafer const wafer, WaferEntry const& data)
 {
-	// Serialize entries entry-by-entry to maintain a nice order.
-	// There is an unresolved issue about this
-	// https://github.com/jbeder/yaml-cpp/issues/169
-	// so this might getting nicer in future
-	// First dump the wafer entries
-	for (const auto& item : mWaferData) {
-		const Wafer wafer = item.first;
-		const WaferEntry& data = item.second;
+	out << "---\n";
 
-		out << "---\n";
+	{
+		YAML::Node config;
+		config["wafer"] = wafer.value();
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["wafer"] = wafer.value();
-			out << config << '\n';
+	{
+		YAML::Node config;
+		config["setuptype"] = data.setup_type;
+		out << config << '\n';
+	}
+
+	{
+		YAML::Node config;
+		config["macu"] = data.macu;
+		config["macuversion"] = data.macu_version;
+		out << config << '\n';
+	}
+
+	if (!data.fpgas.empty()) {
+		YAML::Node config;
+		std::vector<FPGAYAML> fpga_data;
+		for (auto& it : data.fpgas) {
+			FPGAYAML entry(it.second);
+			entry.coordinate = it.first.toFPGAOnWafer().toEnum().value();
+			append_range_item(fpga_data, entry);
 		}
+		config["fpgas"] = fpga_data;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["setuptype"] = data.setup_type;
-			out << config << '\n';
+	if (!data.reticles.empty()) {
+		YAML::Node config;
+		std::vector<ReticleYAML> fpga_data;
+		for (auto& it : data.reticles) {
+			ReticleYAML entry(it.second);
+			entry.coordinate = it.first.toDNCOnWafer().toEnum().value();
+			append_range_item(fpga_data, entry);
 		}
+		config["reticles"] = fpga_data;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["macu"] = data.macu;
-			config["macuversion"] = data.macu_version;
-			out << config << '\n';
-		}
-
-		if (!data.fpgas.empty()) {
-			YAML::Node config;
-			std::vector<FPGAYAML> fpga_data;
-			for (auto& it : data.fpgas) {
-				FPGAYAML entry(it.second);
-				entry.coordinate = it.first.toFPGAOnWafer().toEnum().value();
-				fpga_data.push_back(entry);
-			}
-			config["fpgas"] = fpga_data;
-			out << config << '\n';
+	if (!data.ananas.empty()) {
+		YAML::Node config;
+		std::vector<AnanasYAML> ananas_data;
+		for (auto& it : data.ananas) {
+			AnanasYAML entry(it.second);
+			entry.coordinate = it.first.toAnanasOnWafer().toEnum().value();
+			ananas_data.push_back(entry);
 		}
+		config["ananas"] = ananas_data;
+		out << config << '\n';
+	}
 
-		if (!data.reticles.empty()) {
-			YAML::Node config;
-			std::vector<ReticleYAML> fpga_data;
-			for (auto& it : data.reticles) {
-				ReticleYAML entry(it.second);
-				entry.coordinate = it.first.toDNCOnWafer().toEnum().value();
-				fpga_data.push_back(entry);
-			}
-			config["reticles"] = fpga_data;
-			out << config << '\n';
+	if (!data.adcs.empty()) {
+		YAML::Node config;
+		std::vector<ADCYAML> adc_data;
+		for (auto& it : data.adcs) {
+			ADCYAML entry(it.second);
+			entry.fpga = it.first.first.toFPGAOnWafer().toEnum().value();
+			entry.analog = it.first.second;
+			adc_data.push_back(entry);
 		}
+		config["adcs"] = adc_data;
+		out << config << '\n';
+	}
 
-		if (!data.ananas.empty()) {
-			YAML::Node config;
-			std::vector<AnanasYAML> ananas_data;
-			for (auto& it : data.ananas) {
-				AnanasYAML entry(it.second);
-				entry.coordinate = it.first.toAnanasOnWafer().toEnum().value();
-				ananas_data.push_back(entry);
-			}
-			config["ananas"] = ananas_data;
-			out << config << '\n';
-		}
-
-		if (!data.adcs.empty()) {
-			YAML::Node config;
-			std::vector<ADCYAML> adc_data;
-			for (auto& it : data.adcs) {
-				ADCYAML entry(it.second);
-				entry.fpga = it.first.first.toFPGAOnWafer().toEnum().value();
-				entry.analog = it.first.second;
-				adc_data.push_back(entry);
-			}
-			config["adcs"] = adc_data;
-			out << config << '\n';
+	// the shorthand has to cover exactly the FPGAs of the document
+	HICANNEntry const* shared =
+	    data.fpgas.empty() ? nullptr : data.find_shared_hicann_entry(data.fpgas.begin()->first);
+	for (auto fpga : iter_all<FPGAOnWafer>()) {
+		FPGAGlobal const fpga_global(fpga, wafer);
+		if (bool(data.find_shared_hicann_entry(fpga_global)) != bool(data.fpgas.count(fpga_global))) {
+			shared = nullptr;
 		}
+	}
 
-		if (!data.hicanns.empty()) {
-			YAML::Node config;
-			std::vector<HICANNYAML> hicann_data;
-			for (auto it : data.hicanns) {
-				HICANNYAML entry(it.second);
-				entry.coordinate = it.first.toHICANNOnWafer().toEnum();
-				hicann_data.push_back(entry);
-			}
+	if (shared) {
+		YAML::Node config;
+		YAML::Node hicanns;
+		hicanns["version"] = shared->version;
+		if (!shared->label.empty()) {
+			hicanns["label"] = shared->label;
+		}
+		config["hicanns"] = hicanns;
+		out << config << '\n';
+	} else {
+		std::vector<HICANNYAML> hicann_data;
+		data.for_each_hicann([&hicann_data](HICANNGlobal const hicann, HICANNEntry const& it) {
+			HICANNYAML entry(it);
+			entry.coordinate = hicann.toHICANNOnWafer().toEnum();
+			hicann_data.push_back(entry);
+		});
+		if (hicann_data.empty()) {
+			return;
+		}
 
-			/// Check if we can merge all HICANNs
-			if (can_merge_hicanns(hicann_data)) {
-				YAML::Node hicanns;
-				hicanns["version"] = hicann_data[0].version;
-				if (!hicann_data[0].label.empty()) {
-					hicanns["label"] = hicann_data[0].label;
-				}
-				config["hicanns"] = hicanns;
-			} else {
-				config["hicanns"] = hicann_data;
+		/// Check if we can merge all HICANNs
+		YAML::Node config;
+		if (can_merge_hicanns(hicann_data)) {
+			YAML::Node hicanns;
+			hicanns["version"] = hicann_data[0].version;
+			if (!hicann_data[0].label.empty()) {
+				hicanns["label"] = hicann_data[0].label;
 			}
-			out << config << '\n';
+			config["hicanns"] = hicanns;
+		} else {
+			config["hicanns"] = hicann_data;
 		}
+		out << config << '\n';
 	}
+}
 
-	// Also dump the dls setups
-	for (const auto& item : mDLSData) {
-		const std::string dls_entry = item.first;
-		const DLSSetupEntry& data = item.second;
+void dump_dls_entry(std::ostream& out, std::string const& dls_entry, DLSSetupEntry const& data)
+{
+	out << "---\n";
 
-		out << "---\n";
+	{
+		YAML::Node config;
+		config["dls_setup"] = dls_entry;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["dls_setup"] = dls_entry;
-			out << config << '\n';
-		}
+	{
+		YAML::Node config;
+		config["fpga_name"] = data.fpga_name;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["fpga_name"] = data.fpga_name;
-			out << config << '\n';
-		}
+	{
+		YAML::Node config;
+		config["board_name"] = data.board_name;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["board_name"] = data.board_name;
-			out << config << '\n';
-		}
+	{
+		YAML::Node config;
+		config["board_version"] = data.board_version;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["board_version"] = data.board_version;
-			out << config << '\n';
-		}
+	{
+		YAML::Node config;
+		config["chip_id"] = data.chip_id;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["chip_id"] = data.chip_id;
-			out << config << '\n';
-		}
+	{
+		YAML::Node config;
+		config["chip_version"] = data.chip_version;
+		out << config << '\n';
+	}
 
-		{
-			YAML::Node config;
-			config["chip_version"] = data.chip_version;
-			out << config << '\n';
-		}
+	if (data.ntpwr_ip != " ") {
+		YAML::Node config;
+		config["ntpwr_ip"] = data.ntpwr_ip;
+		out << config << '\n';
+	}
 
-		if (data.ntpwr_ip != " ") {
-			YAML::Node config;
-			config["ntpwr_ip"] = data.ntpwr_ip;
-			out << config << '\n';
-		}
+	if (data.ntpwr_slot != 0) {
+		YAML::Node config;
+		config["ntpwr_slot"] = data.ntpwr_slot;
+		out << config << '\n';
+	}
+}
+
+void dump_hxcube_setup_entry(
+    std::ostream& out, size_t const hxcube_id, HXCubeSetupEntry const& data)
+{
+	out << "---\n";
 
-		if (data.ntpwr_slot != 0) {
-			YAML::Node config;
-			config["ntpwr_slot"] = data.ntpwr_slot;
-			out << config << '\n';
+	{
+		YAML::Node config;
+		config["hxcube_id"] = hxcube_id;
+		out << config << '\n';
+	}
+
+	if (!data.fpgas.empty()) {
+		YAML::Node config;
+		std::vector<HXFPGAYAML> fpga_data;
+		for (auto& it : data.fpgas) {
+			HXFPGAYAML entry(it.second);
+			entry.coordinate = it.first;
+			append_range_item(fpga_data, entry);
 		}
+		config["fpgas"] = fpga_data;
+		out << config << '\n';
+	}
 
+	if (data.usb_host != "") {
+		YAML::Node config;
+		config["usb_host"] = data.usb_host;
+		out << config << '\n';
 	}
 
-	for (const auto& item : mHXCubeData) {
-		const size_t hxcube_id = item.first;
-		const HXCubeSetupEntry& data = item.second;
+	if (data.usb_serial != "") {
+		YAML::Node config;
+		config["usb_serial"] = data.usb_serial;
+		out << config << '\n';
+	}
 
-		out << "---\n";
+	if (data.xilinx_hw_server) {
+		YAML::Node config;
+		config["xilinx_hw_server"] = data.xilinx_hw_server.value();
+		out << config << '\n';
+	}
+}
 
-		{
-			YAML::Node config;
-			config["hxcube_id"] = hxcube_id;
-			out << config << '\n';
-		}
-
-		if (!data.fpgas.empty()) {
-			YAML::Node config;
-			std::vector<HXFPGAYAML> fpga_data;
-			for (auto& it : data.fpgas) {
-				HXFPGAYAML entry(it.second);
-				entry.coordinate = it.first;
-				fpga_data.push_back(entry);
-			}
-			config["fpgas"] = fpga_data;
-			out << config << '\n';
-		}
+void dump_jboa_setup_entry(std::ostream& out, size_t const jboa_id, JboaSetupEntry const& data)
+{
+	out << "---\n";
 
-		if (data.usb_host != "") {
-			YAML::Node config;
-			config["usb_host"] = data.usb_host;
-			out << config << '\n';
-		}
+	{
+		YAML::Node config;
+		config["jboa_id"] = jboa_id;
+		out << config << '\n';
+	}
 
-		if (data.usb_serial != "") {
-			YAML::Node config;
-			config["usb_serial"] = data.usb_serial;
-			out << config << '\n';
+	if (!data.fpgas.empty()) {
+		YAML::Node config;
+		std::vector<HXFPGAYAML> fpga_data;
+		for (auto& it : data.fpgas) {
+			HXFPGAYAML entry(it.second);
+			entry.coordinate = it.first;
+			append_range_item(fpga_data, entry);
 		}
+		config["fpgas"] = fpga_data;
+		out << config << '\n';
+	}
 
-		if (data.xilinx_hw_server) {
-			YAML::Node config;
-			config["xilinx_hw_server"] = data.xilinx_hw_server.value();
-			out << config << '\n';
+	if (!data.aggregators.empty()) {
+		YAML::Node config;
+		std::vector<JboaAggregatorYAML> aggregator_data;
+		for (auto& it : data.aggregators) {
+			JboaAggregatorYAML entry(it.second);
+			entry.coordinate = it.first;
+			aggregator_data.push_back(entry);
 		}
+		config["aggregators"] = aggregator_data;
+		out << config << '\n';
 	}
 
-	for (const auto& item : mJboaData) {
-		const size_t jboa_id = item.first;
-		const JboaSetupEntry& data = item.second;
+	if (data.xilinx_hw_server) {
+		YAML::Node config;
+		config["xilinx_hw_server"] = data.xilinx_hw_server.value();
+		out << config << '\n';
+	}
+}
 
-		out << "---\n";
+} // anonymous namespace
 
-		{
-			YAML::Node config;
-			config["jboa_id"] = jboa_id;
-			out << config << '\n';
-		}
-
-		if (!data.fpgas.empty()) {
-			YAML::Node config;
-			std::vector<HXFPGAYAML> fpga_data;
-			for (auto& it : data.fpgas) {
-				HXFPGAYAML entry(it.second);
-				entry.coordinate = it.first;
-				fpga_data.push_back(entry);
-			}
-			config["fpgas"] = fpga_data;
-			out << config << '\n';
+void database::dump_fragments(std::string const& directory) const
+{
+	materialize();
+	if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST) {
+		throw std::runtime_error("cannot create hwdb directory " + directory);
+	}
+	// other yaml files would be loaded along with the fragments but must not be removed
+	for (auto const& path : list_fragments(directory)) {
+		if (!is_fragment_path(path)) {
+			throw std::runtime_error("cannot dump hwdb fragments next to other yaml file " + path);
 		}
+	}
 
-		if (!data.aggregators.empty()) {
-			YAML::Node config;
-			std::vector<JboaAggregatorYAML> aggregator_data;
-			for (auto& it : data.aggregators) {
-				JboaAggregatorYAML entry(it.second);
-				entry.coordinate = it.first;
-				aggregator_data.push_back(entry);
+	std::set<std::string> written;
+	auto const write_fragment = [&directory, &written](
+	                                SetupFamily const family, std::string const& id,
+	                                auto const& dump_entry) {
+		if (id.empty() || id.find('/') != std::string::npos || id[0] == '.') {
+			throw std::runtime_error("cannot use id '" + id + "' as hwdb fragment file name");
+		}
+		std::string const path =
+		    directory + "/" + get_family_key(family) + "_" + id + ".yaml";
+		std::string const tmp_path = directory + "/." + get_family_key(family) + "_" + id + ".tmp";
+		{
+			std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
+			dump_entry(out);
+			if (!out) {
+				throw std::runtime_error("cannot write hwdb fragment " + tmp_path);
 			}
-			config["aggregators"] = aggregator_data;
-			out << config << '\n';
 		}
+		if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+			std::remove(tmp_path.c_str());
+			throw std::runtime_error("cannot write hwdb fragment " + path);
+		}
+		written.insert(path);
+	};
+
+	for (auto const& item : mWaferData) {
+		write_fragment(SetupFamily::wafer, std::to_string(item.first.value()), [&](std::ostream& out) {
+			dump_wafer_entry(out, item.first, item.second);
+		});
+	}
+	for (auto const& item : mDLSData) {
+		write_fragment(SetupFamily::dls_setup, item.first, [&](std::ostream& out) {
+			dump_dls_entry(out, item.first, item.second);
+		});
+	}
+	for (auto const& item : mHXCubeData) {
+		write_fragment(SetupFamily::hxcube, std::to_string(item.first), [&](std::ostream& out) {
+			dump_hxcube_setup_entry(out, item.first, item.second);
+		});
+	}
+	for (auto const& item : mJboaData) {
+		write_fragment(SetupFamily::jboa, std::to_string(item.first), [&](std::ostream& out) {
+			dump_jboa_setup_entry(out, item.first, item.second);
+		});
+	}
 
-		if (data.xilinx_hw_server) {
-			YAML::Node config;
-			config["xilinx_hw_server"] = data.xilinx_hw_server.value();
-			out << config << '\n';
+	// fragments of removed setups would be loaded as well
+	for (auto const& path : list_fragments(directory)) {
+		if (!written.count(path) && std::remove(path.c_str()) != 0) {
+			throw std::runtime_error("cannot remove stale hwdb fragment " + path);
 		}
 	}
 }
 
+void database::dump(std::ostream& out) const
+{
+	materialize();
+	// First dump the wafer entries
+	for (const auto& item : mWaferData) {
+		dump_wafer_entry(out, item.first, item.second);
+	}
+
+	// Also dump the dls setups
+	for (const auto& item : mDLSData) {
+		dump_dls_entry(out, item.first, item.second);
+	}
+
+	for (const auto& item : mHXCubeData) {
+		dump_hxcube_setup_entry(out, item.first, item.second);
+	}
+
+	for (const auto& item : mJboaData) {
+		dump_jboa_setup_entry(out, item.first, item.second);
+	}
+}
+
 void database::add_wafer_entry(Wafer const wafer, WaferEntry const entry) {
+	invalidate_indexes();
+	mPending.wafers.erase(wafer);
 	mWaferData[wafer] = entry;
 }
 
 bool database::remove_wafer_entry(Wafer const wafer) {
-	return mWaferData.erase(wafer);
+	invalidate_indexes();
+	bool const pending = mPending.wafers.erase(wafer);
+	return mWaferData.erase(wafer) || pending;
 }
 
 bool database::has_wafer_entry(Wafer const wafer) const {
-	return mWaferData.count(wafer);
+	return find_wafer_entry(wafer) != nullptr;
+}
+
+WaferEntry const* database::find_wafer_entry(Wafer const wafer) const {
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
+	auto const it = mWaferData.find(wafer);
+	return it == mWaferData.end() ? nullptr : &it->second;
 }
 
 WaferEntry& database::get_wafer_entry(Wafer const wafer) {
+	invalidate_indexes();
+	// also used for reading, e.g. by the python bindings
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
 	return mWaferData.at(wafer);
 }
 
 WaferEntry const& database::get_wafer_entry(Wafer const wafer) const {
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
 	return mWaferData.at(wafer);
 }
 
 std::vector<halco::hicann::v2::Wafer> database::get_wafer_coordinates() const
 {
+	auto const lock = lock_pending();
 	std::vector<halco::hicann::v2::Wafer> ret;
-	for (auto it : mWaferData) {
-		ret.push_back(it.first);
-	}
+	ret.reserve(mWaferData.size() + mPending.wafers.size());
+	for_each_wafer_coordinate([&ret](Wafer const wafer) { ret.push_back(wafer); });
 	return ret;
 }
 
 void database::add_fpga_entry(FPGAGlobal const fpga, FPGAEntry const entry) {
+	invalidate_indexes();
+	materialize_wafer(fpga.toWafer());
 	mWaferData.at(fpga.toWafer()).fpgas[fpga] = entry;
 }
 
 bool database::remove_fpga_entry(FPGAGlobal const fpga) {
-	bool ok = mWaferData.at(fpga.toWafer()).fpgas.erase(fpga);
+	invalidate_indexes();
+	materialize_wafer(fpga.toWafer());
+	WaferEntry& wafer = mWaferData.at(fpga.toWafer());
+	bool ok = wafer.fpgas.erase(fpga);
 	if (ok) {
-		for (auto hicann : fpga.toHICANNGlobal()) {
-			remove_hicann_entry(hicann);
-		}
+		wafer.remove_hicanns(fpga);
 	}
 	return ok;
 }
 
 bool database::has_fpga_entry(FPGAGlobal const fpga) const {
-	if (has_wafer_entry(fpga.toWafer())) {
-		return mWaferData.at(fpga.toWafer()).fpgas.count(fpga);
+	return find_fpga_entry(fpga) != nullptr;
+}
+
+FPGAEntry const* database::find_fpga_entry(FPGAGlobal const fpga) const {
+	WaferEntry const* const wafer = find_wafer_entry(fpga.toWafer());
+	if (!wafer) {
+		return nullptr;
 	}
-	return false;
+	auto const it = wafer->fpgas.find(fpga);
+	return it == wafer->fpgas.end() ? nullptr : &it->second;
 }
 
 FPGAEntry const& database::get_fpga_entry(FPGAGlobal const fpga) const {
+	auto const lock = lock_pending();
+	materialize_wafer(fpga.toWafer());
 	return mWaferData.at(fpga.toWafer()).fpgas.at(fpga);
 }
 
 FPGAEntryMap database::get_fpga_entries(Wafer const wafer) const {
+	return view_fpga_entries(wafer);
+}
+
+FPGAEntryMap const& database::view_fpga_entries(Wafer const wafer) const {
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
 	return mWaferData.at(wafer).fpgas;
 }
 void database::add_reticle_entry(DNCGlobal const reticle, ReticleEntry const entry) {
+	invalidate_indexes();
+	materialize_wafer(reticle.toWafer());
 	mWaferData.at(reticle.toWafer()).reticles[reticle] = entry;
 }
 
 bool database::remove_reticle_entry(DNCGlobal const reticle) {
+	invalidate_indexes();
+	materialize_wafer(reticle.toWafer());
 	bool ok = mWaferData.at(reticle.toWafer()).reticles.erase(reticle);
 	if (ok) {
 		for (auto hicann : reticle.toFPGAGlobal().toHICANNGlobal()) {
@@ -1045,212 +3771,539 @@ bool database::remove_reticle_entry(DNCGlobal const reticle) {
 }
 
 bool database::has_reticle_entry(DNCGlobal const reticle) const {
-	if (has_wafer_entry(reticle.toWafer())) {
-		return mWaferData.at(reticle.toWafer()).reticles.count(reticle);
+	return find_reticle_entry(reticle) != nullptr;
+}
+
+ReticleEntry const* database::find_reticle_entry(DNCGlobal const reticle) const {
+	WaferEntry const* const wafer = find_wafer_entry(reticle.toWafer());
+	if (!wafer) {
+		return nullptr;
 	}
-	return false;
+	auto const it = wafer->reticles.find(reticle);
+	return it == wafer->reticles.end() ? nullptr : &it->second;
 }
 
 ReticleEntry const& database::get_reticle_entry(DNCGlobal const reticle) const {
+	auto const lock = lock_pending();
+	materialize_wafer(reticle.toWafer());
 	return mWaferData.at(reticle.toWafer()).reticles.at(reticle);
 }
 
 ReticleEntryMap database::get_reticle_entries(Wafer const wafer) const {
+	return view_reticle_entries(wafer);
+}
+
+ReticleEntryMap const& database::view_reticle_entries(Wafer const wafer) const {
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
 	return mWaferData.at(wafer).reticles;
 }
 
 void database::add_ananas_entry(AnanasGlobal const ananas, AnanasEntry const entry)
 {
+	invalidate_indexes();
+	materialize_wafer(ananas.toWafer());
 	mWaferData.at(ananas.toWafer()).ananas[ananas] = entry;
 }
 
 bool database::remove_ananas_entry(AnanasGlobal const ananas)
 {
+	invalidate_indexes();
+	materialize_wafer(ananas.toWafer());
 	return mWaferData.at(ananas.toWafer()).ananas.erase(ananas);
 }
 
 bool database::has_ananas_entry(AnanasGlobal const ananas) const
 {
-	if (has_wafer_entry(ananas.toWafer())) {
-		return mWaferData.at(ananas.toWafer()).ananas.count(ananas);
+	return find_ananas_entry(ananas) != nullptr;
+}
+
+AnanasEntry const* database::find_ananas_entry(AnanasGlobal const ananas) const
+{
+	WaferEntry const* const wafer = find_wafer_entry(ananas.toWafer());
+	if (!wafer) {
+		return nullptr;
 	}
-	return false;
+	auto const it = wafer->ananas.find(ananas);
+	return it == wafer->ananas.end() ? nullptr : &it->second;
 }
 
 AnanasEntry const& database::get_ananas_entry(AnanasGlobal const ananas) const
 {
+	auto const lock = lock_pending();
+	materialize_wafer(ananas.toWafer());
 	return mWaferData.at(ananas.toWafer()).ananas.at(ananas);
 }
 
 AnanasEntryMap database::get_ananas_entries(Wafer const wafer) const
 {
+	return view_ananas_entries(wafer);
+}
+
+AnanasEntryMap const& database::view_ananas_entries(Wafer const wafer) const
+{
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
 	return mWaferData.at(wafer).ananas;
 }
 
 void database::add_hicann_entry(HICANNGlobal const hicann, HICANNEntry const entry) {
+	invalidate_indexes();
+	materialize_wafer(hicann.toWafer());
 	WaferEntry& wafer = mWaferData.at(hicann.toWafer());
 	wafer.fpgas.at(hicann.toFPGAGlobal());
-	wafer.hicanns[hicann] = entry;
+	wafer.set_hicann(hicann, entry);
 }
 
 bool database::remove_hicann_entry(HICANNGlobal const hicann) {
-	return mWaferData.at(hicann.toWafer()).hicanns.erase(hicann);
+	invalidate_indexes();
+	materialize_wafer(hicann.toWafer());
+	return mWaferData.at(hicann.toWafer()).remove_hicann(hicann);
 }
 
 bool database::has_hicann_entry(HICANNGlobal const hicann) const {
-	if (has_wafer_entry(hicann.toWafer())) {
-		return mWaferData.at(hicann.toWafer()).hicanns.count(hicann);
-	}
-	return false;
+	return find_hicann_entry(hicann) != nullptr;
+}
+
+HICANNEntry const* database::find_hicann_entry(HICANNGlobal const hicann) const {
+	WaferEntry const* const wafer = find_wafer_entry(hicann.toWafer());
+	return wafer ? wafer->find_hicann(hicann) : nullptr;
 }
 
 HICANNEntry const& database::get_hicann_entry(HICANNGlobal const hicann) const {
-	return mWaferData.at(hicann.toWafer()).hicanns.at(hicann);
+	auto const lock = lock_pending();
+	materialize_wafer(hicann.toWafer());
+	return mWaferData.at(hicann.toWafer()).get_hicann(hicann);
 }
 
 HICANNEntryMap database::get_hicann_entries(Wafer const wafer) const {
-	return mWaferData.at(wafer).hicanns;
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
+	return mWaferData.at(wafer).get_hicanns();
 }
 
 HICANNEntryMap database::get_hicann_entries(FPGAGlobal const fpga) const {
-	HICANNEntryMap ret_map;
-	for (auto hicann : iter_all<HICANNOnDNC>()) {
-		//FIXME replace dnc coordinate with reticle, will make this much less ugly
-		auto dnconwafer = gridLookupDNCGlobal(FPGAGlobal(fpga), DNCOnFPGA(Enum(0))).toDNCOnWafer();
-		auto hicannglobal = HICANNGlobal(hicann.toHICANNOnWafer(dnconwafer), Wafer(fpga.toWafer()));
-		if (has_hicann_entry(hicannglobal)) {
-			ret_map[hicannglobal] = mWaferData.at(hicannglobal.toWafer()).hicanns.at(hicannglobal);
-		}
+	return get_hicann_entries(gridLookupDNCGlobal(fpga, DNCOnFPGA(Enum(0))));
+}
+
+HICANNEntryMap database::get_hicann_entries(DNCGlobal const reticle) const {
+	WaferEntry const* const wafer = find_wafer_entry(reticle.toWafer());
+	if (!wafer) {
+		return HICANNEntryMap();
 	}
-	return ret_map;
+	return wafer->get_hicanns(reticle);
 }
 
 void database::add_adc_entry(GlobalAnalog_t const analog, ADCEntry const entry) {
+	invalidate_indexes();
+	materialize_wafer(analog.first.toWafer());
 	mWaferData.at(analog.first.toWafer()).adcs[analog] = entry;
 }
 
 bool database::remove_adc_entry(GlobalAnalog_t const analog) {
+	invalidate_indexes();
+	materialize_wafer(analog.first.toWafer());
 	return mWaferData.at(analog.first.toWafer()).adcs.erase(analog);
 }
 
 bool database::has_adc_entry(GlobalAnalog_t const analog) const {
-	return mWaferData.at(analog.first.toWafer()).adcs.count(analog);
+	return find_adc_entry(analog) != nullptr;
+}
+
+ADCEntry const* database::find_adc_entry(GlobalAnalog_t const analog) const {
+	WaferEntry const* const wafer = find_wafer_entry(analog.first.toWafer());
+	if (!wafer) {
+		return nullptr;
+	}
+	auto const it = wafer->adcs.find(analog);
+	return it == wafer->adcs.end() ? nullptr : &it->second;
 }
 
 ADCEntry const& database::get_adc_entry(GlobalAnalog_t const analog) const {
+	auto const lock = lock_pending();
+	materialize_wafer(analog.first.toWafer());
 	return mWaferData.at(analog.first.toWafer()).adcs.at(analog);
 }
 
 ADCEntryMap database::get_adc_entries(Wafer const wafer) const {
+	return view_adc_entries(wafer);
+}
+
+ADCEntryMap const& database::view_adc_entries(Wafer const wafer) const {
+	auto const lock = lock_pending();
+	materialize_wafer(wafer);
 	return mWaferData.at(wafer).adcs;
 }
 
 ADCEntryMap database::get_adc_entries(FPGAGlobal const fpga) const {
-	ADCEntryMap ret_map;
-	for (auto analog : iter_all<AnalogOnHICANN>()) {
-		if (mWaferData.at(fpga.toWafer()).adcs.count(GlobalAnalog_t(fpga, analog)) > 0) {
-			ret_map[GlobalAnalog_t(fpga, analog)] = mWaferData.at(fpga.toWafer()).adcs.at(GlobalAnalog_t(fpga, analog));
-		}
-	}
-	return ret_map;
+	return get_wafer_entry(fpga.toWafer()).get_adcs(fpga);
 }
 
 void database::add_dls_entry(std::string const dls_setup, DLSSetupEntry const entry) {
+	invalidate_indexes();
+	mPending.dls_setups.erase(dls_setup);
 	mDLSData[dls_setup] = entry;
 }
 
 bool database::remove_dls_entry(std::string const dls_setup) {
-	return mDLSData.erase(dls_setup);
+	invalidate_indexes();
+	bool const pending = mPending.dls_setups.erase(dls_setup);
+	return mDLSData.erase(dls_setup) || pending;
 }
 
 bool database::has_dls_entry(std::string const dls_setup) const {
-	return mDLSData.count(dls_setup);
+	return find_dls_entry(dls_setup) != nullptr;
+}
+
+DLSSetupEntry const* database::find_dls_entry(std::string const& dls_setup) const {
+	auto const lock = lock_pending();
+	materialize_dls_setup(dls_setup);
+	auto const it = mDLSData.find(dls_setup);
+	return it == mDLSData.end() ? nullptr : &it->second;
 }
 
 DLSSetupEntry& database::get_dls_entry(std::string const dls_setup) {
+	invalidate_indexes();
+	// also used for reading, e.g. by the python bindings
+	auto const lock = lock_pending();
+	materialize_dls_setup(dls_setup);
 	return mDLSData.at(dls_setup);
 }
 
 DLSSetupEntry const& database::get_dls_entry(std::string const dls_setup) const {
+	auto const lock = lock_pending();
+	materialize_dls_setup(dls_setup);
 	return mDLSData.at(dls_setup);
 }
 
 std::vector<std::string> database::get_dls_setup_ids() const
 {
+	auto const lock = lock_pending();
 	std::vector<std::string> ret;
-	for (auto it : mDLSData) {
-		ret.push_back(it.first);
-	}
+	ret.reserve(mDLSData.size() + mPending.dls_setups.size());
+	for_each_dls_setup_id([&ret](std::string const& dls_setup) { ret.push_back(dls_setup); });
 	return ret;
 }
 
 void database::add_hxcube_setup_entry(size_t const hxcube_id, HXCubeSetupEntry const entry)
 {
+	invalidate_indexes();
+	mPending.hxcube_setups.erase(hxcube_id);
 	mHXCubeData[hxcube_id] = entry;
 }
 
 bool database::remove_hxcube_setup_entry(size_t const hxcube_id)
 {
-	return mHXCubeData.erase(hxcube_id);
+	invalidate_indexes();
+	bool const pending = mPending.hxcube_setups.erase(hxcube_id);
+	return mHXCubeData.erase(hxcube_id) || pending;
 }
 
 bool database::has_hxcube_setup_entry(size_t const hxcube_id) const
 {
-	return mHXCubeData.count(hxcube_id);
+	return find_hxcube_setup_entry(hxcube_id) != nullptr;
+}
+
+HXCubeSetupEntry const* database::find_hxcube_setup_entry(size_t const hxcube_id) const
+{
+	auto const lock = lock_pending();
+	materialize_hxcube_setup(hxcube_id);
+	auto const it = mHXCubeData.find(hxcube_id);
+	return it == mHXCubeData.end() ? nullptr : &it->second;
 }
 
 HXCubeSetupEntry& database::get_hxcube_setup_entry(size_t const hxcube_id)
 {
+	invalidate_indexes();
+	// also used for reading, e.g. by the python bindings
+	auto const lock = lock_pending();
+	materialize_hxcube_setup(hxcube_id);
 	return mHXCubeData.at(hxcube_id);
 }
 
 HXCubeSetupEntry const& database::get_hxcube_setup_entry(size_t const hxcube_id) const
 {
+	auto const lock = lock_pending();
+	materialize_hxcube_setup(hxcube_id);
 	return mHXCubeData.at(hxcube_id);
 }
 
 std::vector<size_t> database::get_hxcube_ids() const {
+	auto const lock = lock_pending();
 	std::vector<size_t> ret;
-	for (auto it : mHXCubeData) {
-		ret.push_back(it.first);
-	}
+	ret.reserve(mHXCubeData.size() + mPending.hxcube_setups.size());
+	for_each_hxcube_id([&ret](size_t const hxcube_id) { ret.push_back(hxcube_id); });
 	return ret;
 }
 
 void database::add_jboa_setup_entry(size_t const jboa_id, JboaSetupEntry const entry)
 {
+	invalidate_indexes();
+	mPending.jboa_setups.erase(jboa_id);
 	mJboaData[jboa_id] = entry;
 }
 
 bool database::remove_jboa_setup_entry(size_t const jboa_id)
 {
-	return mJboaData.erase(jboa_id);
+	invalidate_indexes();
+	bool const pending = mPending.jboa_setups.erase(jboa_id);
+	return mJboaData.erase(jboa_id) || pending;
 }
 
 bool database::has_jboa_setup_entry(size_t const jboa_id) const
 {
-	return mJboaData.count(jboa_id);
+	return find_jboa_setup_entry(jboa_id) != nullptr;
+}
+
+JboaSetupEntry const* database::find_jboa_setup_entry(size_t const jboa_id) const
+{
+	auto const lock = lock_pending();
+	materialize_jboa_setup(jboa_id);
+	auto const it = mJboaData.find(jboa_id);
+	return it == mJboaData.end() ? nullptr : &it->second;
 }
 
 JboaSetupEntry& database::get_jboa_setup_entry(size_t const jboa_id)
 {
+	invalidate_indexes();
+	// also used for reading, e.g. by the python bindings
+	auto const lock = lock_pending();
+	materialize_jboa_setup(jboa_id);
 	return mJboaData.at(jboa_id);
 }
 
 JboaSetupEntry const& database::get_jboa_setup_entry(size_t const jboa_id) const
 {
+	auto const lock = lock_pending();
+	materialize_jboa_setup(jboa_id);
 	return mJboaData.at(jboa_id);
 }
 
 std::vector<size_t> database::get_jboa_ids() const
 {
+	auto const lock = lock_pending();
 	std::vector<size_t> ret;
-	for (auto it : mJboaData) {
-		ret.push_back(it.first);
-	}
+	ret.reserve(mJboaData.size() + mPending.jboa_setups.size());
+	for_each_jboa_id([&ret](size_t const jboa_id) { ret.push_back(jboa_id); });
 	return ret;
 }
 
+std::vector<NetworkEndpoint> database::find_endpoints(IPv4 const& ip) const
+{
+	return get_indexes()->find_endpoints(ip);
+}
+
+std::vector<NetworkEndpoint> database::find_endpoints(IPv4 const& ip, uint16_t const port) const
+{
+	return get_indexes()->find_endpoints(ip, port);
+}
+
+std::vector<NetworkEndpoint> database::find_endpoints_in_subnet(
+    IPv4 const& network, size_t const prefix_length) const
+{
+	return get_indexes()->find_endpoints_in_subnet(network, prefix_length);
+}
+
+std::optional<UniqueBranchIdentifier> database::find_chip(size_t const chip_serial) const
+{
+	UniqueBranchIdentifier const* const id = get_indexes()->find_chip(chip_serial);
+	return id ? std::optional<UniqueBranchIdentifier>(*id) : std::nullopt;
+}
+
+std::string database::get_unique_branch_identifier(size_t const chip_serial) const
+{
+	return get_indexes()->get_unique_branch_identifier(chip_serial);
+}
+
+std::vector<std::string> database::get_unique_branch_identifiers(
+    std::vector<size_t> const& chip_serials) const
+{
+	return get_indexes()->get_unique_branch_identifiers(chip_serials);
+}
+
+std::vector<std::string> database::get_adc_serials() const
+{
+	return get_indexes()->get_adc_serials();
+}
+
+std::vector<ADCChannel> database::get_adc_channels(std::string const& adc) const
+{
+	std::vector<ADCChannel> const* const channels = get_indexes()->find_adc_channels(adc);
+	return channels ? *channels : std::vector<ADCChannel>();
+}
+
+std::vector<ADCConflict> database::get_adc_conflicts() const
+{
+	return get_indexes()->get_adc_conflicts();
+}
+
+std::optional<FPGALocation> database::find_fpga_by_fuse_dna(uint64_t const fuse_dna) const
+{
+	FPGALocation const* const fpga = get_indexes()->find_fpga_by_fuse_dna(fuse_dna);
+	return fpga ? std::optional<FPGALocation>(*fpga) : std::nullopt;
+}
+
+std::optional<FPGALocation> database::find_fpga_by_dna_port(uint64_t const dna_port) const
+{
+	FPGALocation const* const fpga = get_indexes()->find_fpga_by_dna_port(dna_port);
+	return fpga ? std::optional<FPGALocation>(*fpga) : std::nullopt;
+}
+
+std::vector<std::optional<FPGALocation> > database::find_fpgas_by_dna_port(
+    std::vector<uint64_t> const& dna_ports) const
+{
+	return get_indexes()->find_fpgas_by_dna_port(dna_ports);
+}
+
+std::shared_ptr<detail::Indexes const> database::get_indexes() const
+{
+	std::lock_guard<std::recursive_mutex> const lock(mMutex);
+	if (!mIndexes) {
+		materialize();
+		auto indexes = std::make_shared<detail::Indexes>();
+		for (auto const& item : mIndexDefinitions) {
+			indexes->add_secondary_index(item.first, *item.second);
+		}
+		for (auto const& item : mWaferData) {
+			indexes->add_wafer(item.first, item.second);
+		}
+		for (auto const& item : mHXCubeData) {
+			indexes->add_hxcube_setup(item.first, item.second);
+		}
+		for (auto const& item : mJboaData) {
+			indexes->add_jboa_setup(item.first, item.second);
+		}
+		indexes->finish();
+		mIndexes = std::move(indexes);
+	}
+	return mIndexes;
+}
+
+void database::invalidate_indexes()
+{
+	std::lock_guard<std::recursive_mutex> const lock(mMutex);
+	mIndexes.reset();
+}
+
+template <typename Entity>
+void database::add_index_definition(
+    IndexDefinitions& definitions,
+    std::string const& name,
+    IndexExtractor<Entity> extractor,
+    IndexKind const kind)
+{
+	if (!extractor) {
+		throw std::invalid_argument("index " + name + " without extractor");
+	}
+	definitions[std::make_pair(std::type_index(typeid(Entity)), name)] =
+	    std::make_shared<detail::SecondaryIndex<Entity> const>(name, std::move(extractor), kind);
+}
+
+template <typename Entity>
+void database::add_index(
+    std::string const& name, IndexExtractor<Entity> extractor, IndexKind const kind)
+{
+	add_index_definition<Entity>(mIndexDefinitions, name, std::move(extractor), kind);
+	invalidate_indexes();
+}
+
+template <typename Entity>
+bool database::remove_index(std::string const& name)
+{
+	if (!mIndexDefinitions.erase(std::make_pair(std::type_index(typeid(Entity)), name))) {
+		return false;
+	}
+	invalidate_indexes();
+	return true;
+}
+
+template <typename Entity>
+bool database::has_index(std::string const& name) const
+{
+	return mIndexDefinitions.count(std::make_pair(std::type_index(typeid(Entity)), name));
+}
+
+template <typename Entity>
+std::vector<typename IndexedEntity<Entity>::coordinate_type> database::find_by_index(
+    std::string const& name, IndexKey const& key) const
+{
+	return get_indexes()->get_secondary_index<Entity>(name).find(key);
+}
+
+template <typename Entity>
+std::vector<typename IndexedEntity<Entity>::coordinate_type> database::find_by_index_range(
+    std::string const& name, IndexKey const& lower, IndexKey const& upper) const
+{
+	return get_indexes()->get_secondary_index<Entity>(name).find_range(lower, upper);
+}
+
+#define HWDB4CPP_INSTANTIATE_INDEX(Entity)                                                         \
+	template void database::add_index<Entity>(                                                     \
+	    std::string const&, IndexExtractor<Entity>, IndexKind const);                              \
+	template bool database::remove_index<Entity>(std::string const&);                              \
+	template bool database::has_index<Entity>(std::string const&) const;                           \
+	template std::vector<IndexedEntity<Entity>::coordinate_type> database::find_by_index<Entity>(  \
+	    std::string const&, IndexKey const&) const;                                                \
+	template std::vector<IndexedEntity<Entity>::coordinate_type>                                   \
+	database::find_by_index_range<Entity>(std::string const&, IndexKey const&, IndexKey const&)    \
+	    const;
+
+HWDB4CPP_INSTANTIATE_INDEX(WaferEntry)
+HWDB4CPP_INSTANTIATE_INDEX(FPGAEntry)
+HWDB4CPP_INSTANTIATE_INDEX(ReticleEntry)
+HWDB4CPP_INSTANTIATE_INDEX(AnanasEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HICANNEntry)
+HWDB4CPP_INSTANTIATE_INDEX(ADCEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HXCubeSetupEntry)
+HWDB4CPP_INSTANTIATE_INDEX(JboaSetupEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HXCubeFPGAEntry)
+HWDB4CPP_INSTANTIATE_INDEX(HXCubeWingEntry)
+HWDB4CPP_INSTANTIATE_INDEX(JboaAggregatorEntry)
+#undef HWDB4CPP_INSTANTIATE_INDEX
+
+database::IndexDefinitions const& database::get_default_index_definitions()
+{
+	static IndexDefinitions const definitions = [] {
+		IndexDefinitions ret;
+		add_index_definition<WaferEntry>(ret, "setup_type", [](WaferEntry const& entry) {
+			return IndexKey(static_cast<int64_t>(entry.setup_type));
+		});
+		add_index_definition<ReticleEntry>(ret, "to_be_powered", [](ReticleEntry const& entry) {
+			return IndexKey(entry.to_be_powered);
+		});
+		add_index_definition<HICANNEntry>(
+		    ret, "version",
+		    [](HICANNEntry const& entry) { return IndexKey(static_cast<int64_t>(entry.version)); },
+		    IndexKind::ordered);
+		add_index_definition<HXCubeSetupEntry>(
+		    ret, "usb_host",
+		    [](HXCubeSetupEntry const& entry) { return IndexKey(entry.usb_host); });
+		add_index_definition<HXCubeSetupEntry>(
+		    ret, "xilinx_hw_server",
+		    [](HXCubeSetupEntry const& entry) -> std::optional<IndexKey> {
+			    return entry.xilinx_hw_server;
+		    });
+		add_index_definition<JboaSetupEntry>(
+		    ret, "xilinx_hw_server", [](JboaSetupEntry const& entry) -> std::optional<IndexKey> {
+			    return entry.xilinx_hw_server;
+		    });
+		add_index_definition<HXCubeFPGAEntry>(
+		    ret, "ci_test_node",
+		    [](HXCubeFPGAEntry const& entry) { return IndexKey(entry.ci_test_node); });
+		add_index_definition<HXCubeWingEntry>(
+		    ret, "chip_revision",
+		    [](HXCubeWingEntry const& entry) {
+			    return IndexKey(static_cast<int64_t>(entry.chip_revision));
+		    },
+		    IndexKind::ordered);
+		add_index_definition<JboaAggregatorEntry>(
+		    ret, "ci_test_node",
+		    [](JboaAggregatorEntry const& entry) { return IndexKey(entry.ci_test_node); });
+		return ret;
+	}();
+	return definitions;
+}
+
 std::string const& database::get_default_path()
 {
 	return default_path;
@@ -1259,18 +4312,29 @@ std::string const& database::get_default_path()
 std::string database::get_yaml_entries(
     std::string const& path, std::string const& node, std::string const& query)
 {
+	detail::MappedFile const file(path);
 	std::stringstream ss;
-	for (YAML::Node const& config : YAML::LoadAllFromFile(path)) {
-		std::string id;
-		if (config[node].IsDefined()) {
-			id = YAML::get_entry<std::string>(config, node);
-		} else {
+	for (std::string_view const document : split_documents(file.data())) {
+		// documents without the node as plain text cannot contain it
+		if (document.find(node) == std::string_view::npos &&
+		    document.find('\\') == std::string_view::npos) {
 			continue;
 		}
 
-		if (id == query) {
-			// if query matches, append to output
-			ss << config;
+		detail::MemoryStreambuf buffer(document);
+		std::istream stream(&buffer);
+		for (YAML::Node const& config : YAML::LoadAll(stream)) {
+			std::string id;
+			if (config[node].IsDefined()) {
+				id = YAML::get_entry<std::string>(config, node);
+			} else {
+				continue;
+			}
+
+			if (id == query) {
+				// if query matches, append to output
+				ss << config;
+			}
 		}
 	}
 	return ss.str();
@@ -1,12 +1,25 @@
 #pragma once
 
+#include <bitset>
 #include <map>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 #ifndef PYPLUSPLUS
 #include <array>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string_view>
+#include <typeindex>
+#include <variant>
 #endif
 
+#include "dense_map.h"
 #include "genpybind.h"
 #include "halco/common/misc_types.h"
 #include "halco/hicann/v2/coordinates.h"
@@ -61,6 +74,15 @@ namespace hwdb4cpp GENPYBIND_TAG_HWDB {
 ///  - reticle: Coordinate of the Reticle (DNCOnWafer)
 ///  - to_be_powered: boolean flag if reticle is allowed to be powered
 ///
+/// Range entries. FPGA, reticle and HX cube FPGA sequence entries can describe
+/// consecutive coordinates at once by giving the coordinate as decimal range
+/// "first-last", e.g. "fpga: 0-11". All settings apply to each coordinate in
+/// the range, the ip is the one of the first coordinate and is incremented by
+/// one for each following coordinate. HX cube FPGA ranges cannot carry wing or
+/// fuse_dna entries. Later entries replace earlier ones of the same coordinate,
+/// which allows to override single items of a range. dump() writes ranges for
+/// all runs of entries matching this pattern.
+///
 /// HICANN sequence entries. Each entry describes an HICANN available in the
 /// system. Each is a mapping containing the following entries:
 ///  - hicann: Coordinate of the HICANN
@@ -71,6 +93,9 @@ namespace hwdb4cpp GENPYBIND_TAG_HWDB {
 /// are connected, the HICANN sequence can be replaced by a map. In this case
 /// all HICANNs on all specified FPGAs will be available. The mapping contains:
 ///  - version: HICANN version
+///  - label: String, describing the HICANNs (optional)
+/// The shorthand is kept as single shared entry in WaferEntry, covering the
+/// FPGAs given in the same document.
 ///
 /// The DLS setups have a map entry with the keys:
 ///  - fpga_name: Individual FPGA id as string
@@ -100,6 +125,8 @@ namespace hwdb4cpp GENPYBIND_TAG_HWDB {
 /// HX cube FPGA member functions:
 ///  - get_dna_port: calculates the FPGA-internal DNA_PORT sequence (which can be
 ///                  read out from the fabric logic) from the FUSE_DNA
+///  - dna_port_from_fuse_dna, dna_ports_from_fuse_dnas: the same for given (lists of)
+///                  FUSE_DNA values
 ///
 /// HX cube setups have a map entry with the keys:
 ///  - hxcube_id: wafer id = hxcube_id + 60, defining FPGA IP range
@@ -163,13 +190,73 @@ struct ADCEntry
 	halco::hicann::v2::TCPPort remote_port;
 };
 
+// The per-wafer tables are indexed by the on-wafer enum of their coordinates
+template <>
+struct DenseIndex<halco::hicann::v2::FPGAGlobal>
+{
+	static constexpr size_t size = halco::hicann::v2::FPGAOnWafer::size;
+	static size_t index(halco::hicann::v2::FPGAGlobal const fpga)
+	{
+		return fpga.toFPGAOnWafer().toEnum().value();
+	}
+};
+
+template <>
+struct DenseIndex<halco::hicann::v2::DNCGlobal>
+{
+	static constexpr size_t size = halco::hicann::v2::DNCOnWafer::size;
+	static size_t index(halco::hicann::v2::DNCGlobal const reticle)
+	{
+		return reticle.toDNCOnWafer().toEnum().value();
+	}
+};
+
+template <>
+struct DenseIndex<halco::hicann::v2::AnanasGlobal>
+{
+	static constexpr size_t size = halco::hicann::v2::AnanasOnWafer::size;
+	static size_t index(halco::hicann::v2::AnanasGlobal const ananas)
+	{
+		return ananas.toAnanasOnWafer().toEnum().value();
+	}
+};
+
+template <>
+struct DenseIndex<halco::hicann::v2::HICANNGlobal>
+{
+	static constexpr size_t size = halco::hicann::v2::HICANNOnWafer::size;
+	static size_t index(halco::hicann::v2::HICANNGlobal const hicann)
+	{
+		return hicann.toHICANNOnWafer().toEnum().value();
+	}
+};
+
 typedef std::pair< halco::hicann::v2::FPGAGlobal, halco::hicann::v2::AnalogOnHICANN> GlobalAnalog_t;
 typedef std::map< GlobalAnalog_t, ADCEntry> ADCEntryMap;
-typedef std::map< halco::hicann::v2::FPGAGlobal, FPGAEntry> FPGAEntryMap;
-typedef std::map< halco::hicann::v2::DNCGlobal, ReticleEntry> ReticleEntryMap;
-typedef std::map<halco::hicann::v2::AnanasGlobal, AnanasEntry> AnanasEntryMap;
-typedef std::map< halco::hicann::v2::HICANNGlobal, HICANNEntry> HICANNEntryMap;
+/// Tables of a single wafer, see DenseMap
+typedef DenseMap<halco::hicann::v2::FPGAGlobal, FPGAEntry> FPGAEntryMap;
+typedef DenseMap<halco::hicann::v2::DNCGlobal, ReticleEntry> ReticleEntryMap;
+typedef DenseMap<halco::hicann::v2::AnanasGlobal, AnanasEntry> AnanasEntryMap;
+typedef DenseMap<halco::hicann::v2::HICANNGlobal, HICANNEntry> HICANNEntryMap;
+
+/// Analog output wired to an ADC, see database::get_adc_channels
+struct ADCChannel
+{
+	GlobalAnalog_t analog;
+	halco::hicann::v2::ChannelOnADC channel;
+	halco::hicann::v2::TriggerOnADC trigger;
+};
 
+/// Two analog outputs wired to the same channel of an ADC
+struct ADCConflict
+{
+	std::string adc;
+	ADCChannel first;
+	ADCChannel second;
+};
+
+/// HICANNs are no public member since they may be kept as full wafer shorthand,
+/// they are accessed through the HICANN member functions instead.
 struct WaferEntry
 {
 	halco::hicann::v2::SetupType setup_type;
@@ -177,9 +264,72 @@ struct WaferEntry
 	FPGAEntryMap fpgas;
 	ReticleEntryMap reticles;
 	AnanasEntryMap ananas;
-	HICANNEntryMap hicanns;
 	halco::hicann::v2::IPv4 macu;
 	size_t macu_version;
+
+	/// Check if HICANN is available, resolving the full wafer shorthand
+	bool has_hicann(halco::hicann::v2::HICANNGlobal const hicann) const SYMBOL_VISIBLE;
+	/// Get HICANN, nullptr if HICANN isn't available
+	HICANNEntry const* find_hicann(halco::hicann::v2::HICANNGlobal const hicann) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Get HICANN (throws if HICANN isn't available)
+	HICANNEntry const& get_hicann(halco::hicann::v2::HICANNGlobal const hicann) const
+	    SYMBOL_VISIBLE;
+	/// Get all available HICANNs, the full wafer shorthand is resolved into
+	/// individual entries
+	HICANNEntryMap get_hicanns() const SYMBOL_VISIBLE;
+	/// Get the available HICANNs of a reticle
+	HICANNEntryMap get_hicanns(halco::hicann::v2::DNCGlobal const reticle) const SYMBOL_VISIBLE;
+	/// Get the ADCs of an FPGA, they form a contiguous range of adcs
+	ADCEntryMap get_adcs(halco::hicann::v2::FPGAGlobal const fpga) const SYMBOL_VISIBLE;
+
+	/// Make HICANN available, the full wafer shorthand is expanded unless entry
+	/// equals its shared entry
+	void set_hicann(halco::hicann::v2::HICANNGlobal const hicann, HICANNEntry const& entry)
+	    SYMBOL_VISIBLE;
+	/// Make all HICANNs behind fpga available, they are kept as full wafer
+	/// shorthand as long as no HICANN is set individually and entries agree
+	void set_hicanns(halco::hicann::v2::FPGAGlobal const fpga, HICANNEntry const& entry)
+	    SYMBOL_VISIBLE;
+	/// Remove HICANN, returns false if it wasn't available
+	bool remove_hicann(halco::hicann::v2::HICANNGlobal const hicann) SYMBOL_VISIBLE;
+	/// Remove all HICANNs behind fpga
+	void remove_hicanns(halco::hicann::v2::FPGAGlobal const fpga) SYMBOL_VISIBLE;
+	/// Entry shared by all HICANNs behind fpga if they are covered by the full
+	/// wafer shorthand, nullptr otherwise
+	HICANNEntry const* find_shared_hicann_entry(halco::hicann::v2::FPGAGlobal const fpga) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Replace the full wafer shorthand by individual entries
+	void expand_hicanns() SYMBOL_VISIBLE;
+
+	/// Call f(HICANNGlobal, HICANNEntry const&) for each available HICANN in
+	/// coordinate order, the full wafer shorthand is resolved without copies
+	template <typename F>
+	void for_each_hicann(F&& f) const
+	{
+		if (mSharedHICANNs.none()) {
+			for (auto const& item : mHICANNs) {
+				f(item.first, item.second);
+			}
+			return;
+		}
+		for (size_t i = 0; i < halco::hicann::v2::HICANNOnWafer::size; ++i) {
+			halco::hicann::v2::HICANNGlobal const hicann(
+			    halco::hicann::v2::HICANNOnWafer(halco::common::Enum(i)), mSharedHICANNsWafer);
+			if (mSharedHICANNs.test(hicann.toFPGAGlobal().toFPGAOnWafer().toEnum().value())) {
+				f(hicann, mSharedHICANNsEntry);
+			}
+		}
+	}
+
+private:
+	/// Individually set HICANNs, empty while the full wafer shorthand is used
+	HICANNEntryMap mHICANNs;
+	/// Full wafer shorthand: FPGAs whose HICANNs are all available and share
+	/// mSharedHICANNsEntry. Fixed when set, later changes of fpgas don't affect it.
+	std::bitset<halco::hicann::v2::FPGAOnWafer::size> mSharedHICANNs;
+	halco::hicann::v2::Wafer mSharedHICANNsWafer;
+	HICANNEntry mSharedHICANNsEntry;
 };
 
 struct GENPYBIND(visible) DLSSetupEntry
@@ -223,6 +373,10 @@ struct GENPYBIND(visible) HXCubeFPGAEntry
 	bool ci_test_node;
 
 	uint64_t get_dna_port() const SYMBOL_VISIBLE;
+
+	static uint64_t dna_port_from_fuse_dna(uint64_t fuse_dna) SYMBOL_VISIBLE;
+	static std::vector<uint64_t> dna_ports_from_fuse_dnas(std::vector<uint64_t> const& fuse_dnas)
+	    SYMBOL_VISIBLE;
 };
 
 struct GENPYBIND(visible) HXCubeSetupEntry
@@ -278,24 +432,408 @@ struct GENPYBIND(visible) JboaSetupEntry
 	static std::tuple<size_t, size_t, size_t, size_t> get_ids_from_unique_branch_identifier(
 	    std::string identifier) SYMBOL_VISIBLE;
 };
+
+/// Owner of a network endpoint, determines the meaning of the NetworkEndpoint fields
+enum class GENPYBIND(visible) EndpointOwner
+{
+	/// FPGA of a wafer, index is the FPGAOnWafer
+	fpga,
+	/// UDP data port of an Ananas slice, index is the AnanasOnWafer, sub_index the
+	/// AnanasSliceOnAnanas
+	ananas_data,
+	/// UDP reset port of an Ananas slice, see ananas_data
+	ananas_reset,
+	/// TCP remote endpoint of an ADC, index is the FPGAOnWafer, sub_index the
+	/// AnalogOnHICANN
+	adc,
+	/// MACU of a wafer
+	macu,
+	/// FPGA of a HX cube setup, index is the FPGA id
+	hxcube_fpga,
+	/// FPGA of a jBOA setup, index is the FPGA id
+	jboa_fpga,
+	/// aggregator of a jBOA setup, index is the aggregator id
+	jboa_aggregator
+};
+
+/// Network address (and port) of an entry, see database::find_endpoints
+struct GENPYBIND(visible) NetworkEndpoint
+{
+	halco::common::IPv4 ip;
+	/// UDP or TCP port, 0 for endpoints given by their address only
+	uint16_t port;
+	EndpointOwner owner;
+	/// Wafer coordinate, hxcube_id or jboa_id of the setup
+	size_t setup;
+	size_t index;
+	size_t sub_index;
+
+	/// Coordinates of owners on a wafer (throw if the owner is not of that kind)
+	halco::hicann::v2::Wafer get_wafer() const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// FPGA of fpga and adc endpoints
+	halco::hicann::v2::FPGAGlobal get_fpga() const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Ananas of ananas_data and ananas_reset endpoints
+	halco::hicann::v2::AnanasGlobal get_ananas() const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	GlobalAnalog_t get_analog() const GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool operator==(NetworkEndpoint const& other) const SYMBOL_VISIBLE;
+	bool operator!=(NetworkEndpoint const& other) const SYMBOL_VISIBLE;
+};
+
+namespace detail {
+class Indexes;
+} // namespace detail
 #endif
 /* ******************************************************************** */
 
 
+/// Setup families in the database, each YAML document belongs to the family
+/// given by its discriminating key
+enum class GENPYBIND(visible) SetupFamily
+{
+	/// document with key "wafer"
+	wafer,
+	/// document with key "dls_setup"
+	dls_setup,
+	/// document with key "hxcube_id"
+	hxcube,
+	/// document with key "jboa_id"
+	jboa
+};
+
+#ifndef PYPLUSPLUS
+/// Components of the unique branch identifier of a chip, "hxcube9fpga0chip12_1" for
+/// HX cube and "jboa7fpga12chip13_1" for jBOA setups.
+struct GENPYBIND(visible) UniqueBranchIdentifier
+{
+	/// hxcube or jboa
+	SetupFamily family = SetupFamily::hxcube;
+	size_t setup_id = 0;
+	size_t fpga_id = 0;
+	/// handwritten serial of the chip
+	size_t chip_serial = 0;
+	/// not yet in hwdb (Issue #3641), always 1 for identifiers of database entries
+	size_t setup_version = 1;
+
+	/// Upper bound of the length of a formatted identifier
+	static constexpr size_t max_size = 96;
+
+	/// Parse identifier without allocating, returns false if it is malformed
+	static bool parse(std::string_view identifier, UniqueBranchIdentifier& ret)
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// @throws std::runtime_error if identifier is malformed
+	static UniqueBranchIdentifier from_string(std::string_view identifier) SYMBOL_VISIBLE;
+	/// Batch variant of from_string
+	/// @throws std::runtime_error naming the first malformed identifier
+	static std::vector<UniqueBranchIdentifier> from_strings(
+	    std::vector<std::string> const& identifiers) SYMBOL_VISIBLE;
+
+	/// Write identifier to buffer without allocating, no terminating null character is
+	/// written. Returns the length of the identifier, 0 if buffer is too small or the
+	/// family is neither hxcube nor jboa.
+	size_t format(char* buffer, size_t size) const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// @throws std::invalid_argument if the family is neither hxcube nor jboa
+	std::string to_string() const SYMBOL_VISIBLE;
+	/// Batch variant of to_string
+	static std::vector<std::string> to_strings(std::vector<UniqueBranchIdentifier> const& ids)
+	    SYMBOL_VISIBLE;
+
+	bool operator==(UniqueBranchIdentifier const& other) const SYMBOL_VISIBLE;
+	bool operator!=(UniqueBranchIdentifier const& other) const SYMBOL_VISIBLE;
+};
+
+/// FPGA of a HX cube or jBOA setup, see database::find_fpga_by_fuse_dna
+struct GENPYBIND(visible) FPGALocation
+{
+	/// hxcube or jboa
+	SetupFamily family;
+	size_t setup_id;
+	size_t fpga_id;
+
+	bool operator==(FPGALocation const& other) const SYMBOL_VISIBLE;
+	bool operator!=(FPGALocation const& other) const SYMBOL_VISIBLE;
+};
+
+/// Value of an entry field in a secondary index, see database::add_index.
+/// Integers are indexed as int64_t, keys of different types never compare equal.
+typedef std::variant<bool, int64_t, std::string> IndexKey;
+
+/// Lookup structure of a secondary index
+enum class IndexKind
+{
+	/// equality lookups only
+	hash,
+	/// equality and range lookups
+	ordered
+};
+
+/// Entry types which can be indexed by database::add_index, coordinate_type
+/// identifies an entry in the results of lookups
+template <typename Entity>
+struct IndexedEntity;
+
+template <>
+struct IndexedEntity<WaferEntry>
+{
+	typedef halco::hicann::v2::Wafer coordinate_type;
+};
+
+template <>
+struct IndexedEntity<FPGAEntry>
+{
+	typedef halco::hicann::v2::FPGAGlobal coordinate_type;
+};
+
+template <>
+struct IndexedEntity<ReticleEntry>
+{
+	typedef halco::hicann::v2::DNCGlobal coordinate_type;
+};
+
+template <>
+struct IndexedEntity<AnanasEntry>
+{
+	typedef halco::hicann::v2::AnanasGlobal coordinate_type;
+};
+
+/// HICANNs of the full wafer shorthand are indexed individually
+template <>
+struct IndexedEntity<HICANNEntry>
+{
+	typedef halco::hicann::v2::HICANNGlobal coordinate_type;
+};
+
+template <>
+struct IndexedEntity<ADCEntry>
+{
+	typedef GlobalAnalog_t coordinate_type;
+};
+
+/// hxcube_id
+template <>
+struct IndexedEntity<HXCubeSetupEntry>
+{
+	typedef size_t coordinate_type;
+};
+
+/// jboa_id
+template <>
+struct IndexedEntity<JboaSetupEntry>
+{
+	typedef size_t coordinate_type;
+};
+
+/// FPGAs of HX cube and jBOA setups
+template <>
+struct IndexedEntity<HXCubeFPGAEntry>
+{
+	typedef FPGALocation coordinate_type;
+};
+
+/// Wings of HX cube and jBOA FPGAs
+template <>
+struct IndexedEntity<HXCubeWingEntry>
+{
+	typedef FPGALocation coordinate_type;
+};
+
+/// jboa_id and aggregator id
+template <>
+struct IndexedEntity<JboaAggregatorEntry>
+{
+	typedef std::pair<size_t, size_t> coordinate_type;
+};
+
+namespace detail {
+class SecondaryIndexBase;
+} // namespace detail
+#endif
+
+/// Selection of the setups to be loaded by database::load. Documents of setups not
+/// selected are skipped after reading only their discriminating key.
+/// An empty filter selects everything.
+class GENPYBIND(visible) LoadFilter
+{
+public:
+	/// Select all setups of a family
+	void add(SetupFamily family) SYMBOL_VISIBLE;
+	/// Select a single setup of a family by the value of its discriminating key
+	/// (throws if the id of a numerical family is no number)
+	void add(SetupFamily family, std::string const& id) SYMBOL_VISIBLE;
+	/// Select a single setup of a numerical family (wafer, hxcube, jboa)
+	void add(SetupFamily family, size_t id) SYMBOL_VISIBLE;
+
+	/// Check if setup is selected
+	bool contains(SetupFamily family, std::string const& id) const SYMBOL_VISIBLE;
+	/// Check if filter selects everything
+	bool empty() const SYMBOL_VISIBLE;
+
+private:
+	/// selected ids per family, numerical ids in decimal, an empty set selects
+	/// the whole family
+	std::map<SetupFamily, std::set<std::string> > m_selection;
+};
+
+/// Options for loading the YAML database file
+struct GENPYBIND(visible) LoadOptions
+{
+	/// Parser used for decoding the YAML documents
+	enum class Parser
+	{
+		/// decode from the YAML::Node tree of each document
+		node,
+		/// decode directly from the event stream of the YAML parser, the node
+		/// tree is never built
+		event
+	};
+
+	Parser parser = Parser::node;
+
+	/// use an up-to-date binary snapshot of the YAML file if available
+	bool use_snapshot = true;
+
+	/// setups to be loaded
+	LoadFilter filter;
+
+	/// Defer decoding of setup documents to the first access of the respective entry.
+	/// Enumeration of ids does not decode entries. Const accessors of a lazily loaded
+	/// database serialize on a lock until materialize() was called, so that they remain
+	/// safe for concurrent use. The text of undecoded documents is kept in memory, the
+	/// loaded file may be modified or removed afterwards.
+	bool lazy = false;
+};
+
+/// Setups affected by database::reload
+struct GENPYBIND(visible) ReloadSummary
+{
+	typedef std::pair<SetupFamily, std::string> Setup;
+
+	/// setups which were not loaded before
+	std::vector<Setup> added;
+	/// setups whose documents differ from the previous load
+	std::vector<Setup> changed;
+	/// setups which are not defined anymore
+	std::vector<Setup> removed;
+
+	bool empty() const SYMBOL_VISIBLE;
+};
+
+#ifndef PYPLUSPLUS
+class frozen_database;
+#endif
+
 /// This class provides an interface to the low-level database.
 class GENPYBIND(visible) database
 {
 public:
 
+	database() SYMBOL_VISIBLE;
+	database(database const& other) SYMBOL_VISIBLE;
+	database& operator=(database const& other) SYMBOL_VISIBLE;
+#ifndef PYPLUSPLUS
+	/// Moves take over the entries of other without copying them, other is left empty
+	/// with the default indexes registered
+	database(database&& other) GENPYBIND(hidden) SYMBOL_VISIBLE;
+	database& operator=(database&& other) GENPYBIND(hidden) SYMBOL_VISIBLE;
+#endif
+
 	/// clear object
 	void clear() SYMBOL_VISIBLE;
 
 	/// load database from file
+	/// If an up-to-date binary snapshot of the file exists (see dump_snapshot), it is
+	/// loaded instead of parsing the YAML file.
 	void load(std::string const path) SYMBOL_VISIBLE;
 
+	/// load database from file using the given options
+	/// If path is a directory, its fragment files (*.yaml, not hidden) are loaded
+	/// instead, see dump_fragments. A setup defined in more than one fragment is an
+	/// error. Snapshots are not used for directories.
+	void load(std::string const path, LoadOptions const& options) SYMBOL_VISIBLE;
+
+#ifndef PYPLUSPLUS
+	/// load database from file in a background thread, see load()
+	/// The database must neither be used nor destroyed until the returned future is
+	/// ready, errors of the load are rethrown by its get(). As for all std::async
+	/// results, destroying the future waits for the load to finish.
+	std::future<void> load_async(std::string const path) GENPYBIND(hidden) SYMBOL_VISIBLE;
+	std::future<void> load_async(std::string const path, LoadOptions const& options)
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+#endif
+
+#ifndef PYPLUSPLUS
+	/// load database from YAML contents in memory
+	/// The buffer is only referenced during the call, except for lazy loads which copy it.
+	void load_from_buffer(std::string_view const buffer) GENPYBIND(hidden) SYMBOL_VISIBLE;
+	void load_from_buffer(std::string_view const buffer, LoadOptions const& options)
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+#endif
+
+#ifndef PYPLUSPLUS
+	/// load database compiled into the hwdb4cpp_embedded library at build time
+	/// No file is read and no YAML is parsed, the entries are decoded from a binary
+	/// snapshot of the YAML database the library was built from. Only available when
+	/// linking against hwdb4cpp_embedded in addition to hwdb4cpp, which is built when
+	/// configured with --hwdb-embedded-yaml.
+	void load_embedded() GENPYBIND(hidden) SYMBOL_VISIBLE;
+#endif
+
+	/// load database from an open file descriptor, e.g. a pipe
+	/// The descriptor is read until its end and not closed.
+	void load_from_fd(int const fd) SYMBOL_VISIBLE;
+	void load_from_fd(int const fd, LoadOptions const& options) SYMBOL_VISIBLE;
+
+	/// Update database to the current contents of path (file or directory).
+	/// Only documents whose contents differ from the previous load (or reload) are
+	/// decoded, setups of unchanged documents are kept as they are, including
+	/// modifications made since. Options of the previous load are used again, lazy
+	/// loads are materialized first. If the database was not loaded from YAML before
+	/// (e.g. from a snapshot), all setups are decoded and reported as changed. Nothing
+	/// is modified if decoding fails.
+	/// @return setups added, changed or removed by the reload
+	ReloadSummary reload(std::string const path) SYMBOL_VISIBLE;
+
+	/// Decode all entries deferred by a lazy load.
+	/// Const accessors do not need to lock anymore afterwards.
+	void materialize() const SYMBOL_VISIBLE;
+
+#ifndef PYPLUSPLUS
+	/// Read-only copy of the database for consumers which only query after loading,
+	/// see frozen_database. Lazy loads are materialized first.
+	frozen_database freeze() const& SYMBOL_VISIBLE;
+	/// Move all entries into a frozen_database, the database is empty afterwards.
+	frozen_database freeze() && GENPYBIND(hidden) SYMBOL_VISIBLE;
+#endif
+
+	/// Write binary snapshot of the YAML file next to it. The file is decoded anew, so the
+	/// snapshot always holds its full content, regardless of the filter of a previous load
+	/// or later modifications of any database. The snapshot records size, modification
+	/// time and hash of the YAML file and is ignored by load if it does not match the YAML
+	/// file anymore.
+	/// @param path path to yaml database file the snapshot corresponds to
+	static void dump_snapshot(std::string const& path) SYMBOL_VISIBLE;
+
+	/// Write binary snapshot of the YAML file at path to out instead
+	static void dump_snapshot(std::string const& path, std::ostream& out)
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	/// get path of the binary snapshot belonging to a yaml database file
+	static std::string get_snapshot_path(std::string const& path) SYMBOL_VISIBLE;
+
+	/// Check if an intact binary snapshot matching the yaml database file exists
+	static bool has_valid_snapshot(std::string const& path) SYMBOL_VISIBLE;
+
 	/// dump database
 	void dump(std::ostream& out) const GENPYBIND(hidden) SYMBOL_VISIBLE;
 
+	/// Dump database as one fragment file per setup into directory, e.g.
+	/// hxcube_id_6.yaml, which is created if missing. The directory is dedicated to
+	/// the database: fragments of the same name are replaced and fragments of other
+	/// setups are removed afterwards, so that loading the directory yields exactly this
+	/// database. Throws without writing anything if the directory holds *.yaml files
+	/// (not hidden) not named like fragments, other files are left untouched.
+	void dump_fragments(std::string const& directory) const SYMBOL_VISIBLE;
+
 	/// get default_path member
 	static std::string const& get_default_path() SYMBOL_VISIBLE;
 
@@ -311,6 +849,58 @@ public:
 
 	// FIXME: add const getters everywhere?
 
+#ifndef PYPLUSPLUS
+	/// Enumerate setup ids in ascending order without allocations, including entries
+	/// of a lazy load not decoded yet. f is called with each id and must not modify
+	/// the database.
+	template <typename F>
+	void for_each_wafer_coordinate(F&& f) const GENPYBIND(hidden);
+	template <typename F>
+	void for_each_dls_setup_id(F&& f) const GENPYBIND(hidden);
+	template <typename F>
+	void for_each_hxcube_id(F&& f) const GENPYBIND(hidden);
+	template <typename F>
+	void for_each_jboa_id(F&& f) const GENPYBIND(hidden);
+
+	/// Call f(HICANNGlobal, HICANNEntry const&) for all HICANNs on a Wafer
+	/// (throws if wafer isn't found), see WaferEntry::for_each_hicann
+	template <typename F>
+	void for_each_hicann_entry(halco::hicann::v2::Wafer const wafer, F&& f) const
+	    GENPYBIND(hidden);
+
+	/// Views of the tables of a Wafer (throws if wafer isn't found), the references
+	/// stay valid until the wafer entry is modified or removed
+	FPGAEntryMap const& view_fpga_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ReticleEntryMap const& view_reticle_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	AnanasEntryMap const& view_ananas_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ADCEntryMap const& view_adc_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	/// Non-throwing lookups, nullptr if the entry doesn't exist. The pointers stay
+	/// valid until the entry is modified or removed.
+	WaferEntry const* find_wafer_entry(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	FPGAEntry const* find_fpga_entry(halco::hicann::v2::FPGAGlobal const fpga) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ReticleEntry const* find_reticle_entry(halco::hicann::v2::DNCGlobal const reticle) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	AnanasEntry const* find_ananas_entry(halco::hicann::v2::AnanasGlobal const ananas) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	HICANNEntry const* find_hicann_entry(halco::hicann::v2::HICANNGlobal const hicann) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ADCEntry const* find_adc_entry(GlobalAnalog_t const analog) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	DLSSetupEntry const* find_dls_entry(std::string const& dls_setup) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	HXCubeSetupEntry const* find_hxcube_setup_entry(size_t const hxcube_id) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	JboaSetupEntry const* find_jboa_setup_entry(size_t const jboa_id) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+#endif
+
 	/// Insert (and replace) a new wafer entry into the database
 	void add_wafer_entry(halco::hicann::v2::Wafer const wafer, WaferEntry const entry)
 	    GENPYBIND(hidden) SYMBOL_VISIBLE;
@@ -374,7 +964,9 @@ public:
 	    GENPYBIND(hidden) SYMBOL_VISIBLE;
 
 	/// Insert (and replace) a HICANN into the database.
-	/// The corresponding FPGAEntry has to exist.
+	/// The corresponding FPGAEntry has to exist. Wafers using the full wafer
+	/// shorthand are expanded into individual entries unless entry is equal
+	/// to the shared one.
 	void add_hicann_entry(halco::hicann::v2::HICANNGlobal const hicann, HICANNEntry const entry)
 	    GENPYBIND(hidden) SYMBOL_VISIBLE;
 	bool remove_hicann_entry(halco::hicann::v2::HICANNGlobal const hicann)
@@ -391,6 +983,9 @@ public:
 	/// Get all entries for all HICANNs on a FPGAGlobal
 	HICANNEntryMap get_hicann_entries(halco::hicann::v2::FPGAGlobal const fpga) const
 	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Get all entries for all HICANNs on a Reticle
+	HICANNEntryMap get_hicann_entries(halco::hicann::v2::DNCGlobal const reticle) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
 
 	/// Insert (and replace) an ADC  into the database.
 	/// The corresponding Wafer has to exist.
@@ -408,6 +1003,16 @@ public:
 	/// Get all entries for all ADCs on a FPGAGlobal
 	ADCEntryMap get_adc_entries(halco::hicann::v2::FPGAGlobal const fpga) const
 	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Get the serials (ADCEntry::coord) of all ADCs of all wafers without duplicates,
+	/// in order of their first entry
+	std::vector<std::string> get_adc_serials() const SYMBOL_VISIBLE;
+	/// Get all analog outputs wired to the ADC, ordered by analog output, empty if
+	/// there is no such ADC. The ADC index is built by the first query after loading
+	/// or modifying the database, lookups take constant time.
+	std::vector<ADCChannel> get_adc_channels(std::string const& adc) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Get all pairs of analog outputs wired to the same channel of an ADC
+	std::vector<ADCConflict> get_adc_conflicts() const GENPYBIND(hidden) SYMBOL_VISIBLE;
 
 	/// Insert (and replace) a new dls entry into the database
 	void add_dls_entry(std::string const dls_setup, DLSSetupEntry const entry) SYMBOL_VISIBLE;
@@ -446,6 +1051,89 @@ public:
 	/// Get all HICANN-X cube setup entry ids
 	std::vector<size_t> get_jboa_ids() const SYMBOL_VISIBLE;
 
+	/// Get the endpoints with the given address, ordered by port.
+	/// Indexed are the addresses of FPGAs, Ananas slices (data and reset port),
+	/// ADC remote endpoints, MACUs, HX cube and jBOA FPGAs and jBOA aggregators,
+	/// except for unspecified (0.0.0.0) ones. The index is built by the first query
+	/// after loading or modifying the database and materializes lazy loads.
+	std::vector<NetworkEndpoint> find_endpoints(halco::common::IPv4 const& ip) const
+	    SYMBOL_VISIBLE;
+	/// Get the endpoints with the given address and UDP or TCP port
+	std::vector<NetworkEndpoint> find_endpoints(
+	    halco::common::IPv4 const& ip, uint16_t const port) const SYMBOL_VISIBLE;
+	/// Get the endpoints in the subnet given in CIDR notation, ordered by address and
+	/// port (throws if prefix_length exceeds 32)
+	std::vector<NetworkEndpoint> find_endpoints_in_subnet(
+	    halco::common::IPv4 const& network, size_t const prefix_length) const SYMBOL_VISIBLE;
+
+	/// Find the HX cube or jBOA FPGA a chip is connected to by its handwritten or,
+	/// if no chip has that handwritten serial, its EEPROM serial. If several chips
+	/// match, the one of the lowest HX cube, then jBOA, setup and FPGA id is returned.
+	/// Uses the same index as find_endpoints, lookups take constant time.
+	std::optional<UniqueBranchIdentifier> find_chip(size_t const chip_serial) const
+	    SYMBOL_VISIBLE;
+	/// Unique branch identifier of the chip, see find_chip
+	/// @throws std::runtime_error if there is no chip with that serial
+	std::string get_unique_branch_identifier(size_t const chip_serial) const SYMBOL_VISIBLE;
+	/// Batch variant of get_unique_branch_identifier
+	std::vector<std::string> get_unique_branch_identifiers(
+	    std::vector<size_t> const& chip_serials) const SYMBOL_VISIBLE;
+
+	/// Find the HX cube or jBOA FPGA with the given FUSE_DNA or DNA_PORT value.
+	/// DNA_PORT values are computed once when the index is built. If several FPGAs
+	/// match, the one of the lowest HX cube, then jBOA, setup and FPGA id is returned.
+	std::optional<FPGALocation> find_fpga_by_fuse_dna(uint64_t const fuse_dna) const
+	    SYMBOL_VISIBLE;
+	std::optional<FPGALocation> find_fpga_by_dna_port(uint64_t const dna_port) const
+	    SYMBOL_VISIBLE;
+	/// Batch variant of find_fpga_by_dna_port, e.g. for all devices of a JTAG chain
+	std::vector<std::optional<FPGALocation> > find_fpgas_by_dna_port(
+	    std::vector<uint64_t> const& dna_ports) const SYMBOL_VISIBLE;
+
+	/// Extracts the indexed field of an entry, entries without a value are not indexed
+	template <typename Entity>
+	using IndexExtractor = std::function<std::optional<IndexKey>(Entity const&)>;
+
+	/// Register a secondary index over a field of all entries of type Entity, e.g.
+	///   db.add_index<HXCubeSetupEntry>("usb_serial", [](HXCubeSetupEntry const& e) {
+	///       return IndexKey(e.usb_serial); });
+	/// Names are per entry type, an index of the same name is replaced. Like the
+	/// indexes of find_endpoints, secondary indexes are built by the first query after
+	/// loading or modifying the database and lookups do not scan any entries.
+	/// Registered indexes are kept by clear() and copied along with the database.
+	/// The default indexes are
+	///  - WaferEntry: setup_type (hash)
+	///  - ReticleEntry: to_be_powered (hash)
+	///  - HICANNEntry: version (ordered)
+	///  - HXCubeSetupEntry: usb_host, xilinx_hw_server (hash)
+	///  - JboaSetupEntry: xilinx_hw_server (hash)
+	///  - HXCubeFPGAEntry: ci_test_node (hash)
+	///  - HXCubeWingEntry: chip_revision (ordered)
+	///  - JboaAggregatorEntry: ci_test_node (hash)
+	template <typename Entity>
+	void add_index(
+	    std::string const& name,
+	    IndexExtractor<Entity> extractor,
+	    IndexKind const kind = IndexKind::hash) GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Remove a secondary index, returns false if there is no such index
+	template <typename Entity>
+	bool remove_index(std::string const& name) GENPYBIND(hidden) SYMBOL_VISIBLE;
+	template <typename Entity>
+	bool has_index(std::string const& name) const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Get the coordinates of all entries whose field equals key, in coordinate order
+	/// @throws std::out_of_range if there is no such index
+	template <typename Entity>
+	std::vector<typename IndexedEntity<Entity>::coordinate_type> find_by_index(
+	    std::string const& name, IndexKey const& key) const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	/// Get the coordinates of all entries whose field lies in [lower, upper], ordered
+	/// by field value and coordinate
+	/// @throws std::out_of_range if there is no such index
+	/// @throws std::invalid_argument if the index is not ordered
+	template <typename Entity>
+	std::vector<typename IndexedEntity<Entity>::coordinate_type> find_by_index_range(
+	    std::string const& name, IndexKey const& lower, IndexKey const& upper) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
 private:
 	// used by yaml-cpp => FIXME: change to add_{fpga,hicann,adc}_entry
 	void add_fpga(halco::hicann::v2::FPGAGlobal const, const FPGAEntry& data);
@@ -454,13 +1142,284 @@ private:
 	void add_hicann(halco::hicann::v2::HICANNGlobal const, const HICANNEntry& data);
 	void add_adc(GlobalAnalog_t const, const ADCEntry& data);
 
-	std::map<halco::hicann::v2::Wafer, WaferEntry> mWaferData;
-	std::map<std::string, DLSSetupEntry> mDLSData;
-	std::map<size_t, HXCubeSetupEntry> mHXCubeData;
-	std::map<size_t, JboaSetupEntry> mJboaData;
+	/// try to load binary snapshot of path, returns false if it is missing or outdated
+	bool load_snapshot(std::string const& path);
+
+	/// decode snapshot image, returns false if it is incompatible or corrupt
+	/// @param name name of the snapshot in log messages
+	bool read_snapshot(std::string_view const snapshot, std::string const& name);
+
+	/// load snapshot image compiled into hwdb4cpp_embedded, see load_embedded
+	void load_embedded_snapshot(std::string_view const snapshot) SYMBOL_VISIBLE;
+
+	/// throw if the database is not empty before loading
+	void check_empty() const;
+
+	/// decode YAML documents in content, lazy loads copy pending documents
+	void load_content(std::string_view const content, LoadOptions const& options);
+
+	/// decode YAML documents of named fragments, lazy loads copy pending documents
+	void load_fragments(
+	    std::vector<std::pair<std::string, std::string_view> > const& fragments,
+	    LoadOptions const& options);
+
+	/// remove entries not selected by filter
+	static void erase_unselected(database& db, LoadFilter const& filter);
+
+	/// call f with the keys of both sorted maps in ascending order
+	template <typename Data, typename Pending, typename F>
+	static void for_each_key(Data const& data, Pending const& pending, F& f);
+
+	/// indexes of all entries, built on first use after a modification
+	std::shared_ptr<detail::Indexes const> get_indexes() const;
+	/// drop indexes, has to be called by all modifications of entries
+	void invalidate_indexes();
+
+	/// Registered secondary indexes by entry type and name, unbuilt prototypes
+	typedef std::map<
+	    std::pair<std::type_index, std::string>,
+	    std::shared_ptr<detail::SecondaryIndexBase const> >
+	    IndexDefinitions;
+	template <typename Entity>
+	static void add_index_definition(
+	    IndexDefinitions& definitions,
+	    std::string const& name,
+	    IndexExtractor<Entity> extractor,
+	    IndexKind const kind = IndexKind::hash);
+	/// default secondary indexes, see add_index, created once and shared by all databases
+	static IndexDefinitions const& get_default_index_definitions();
+
+	/// Lock to be held by const accessors of the containers while documents are pending,
+	/// materialization modifies them. Unlocked once all documents were decoded.
+	std::unique_lock<std::recursive_mutex> lock_pending() const;
+
+	/// decode deferred document of entry if there is one, requires lock_pending
+	void materialize_wafer(halco::hicann::v2::Wafer const wafer) const;
+	void materialize_dls_setup(std::string const& dls_setup) const;
+	void materialize_hxcube_setup(size_t const hxcube_id) const;
+	void materialize_jboa_setup(size_t const jboa_id) const;
+
+	/// Document of the previous load
+	struct LoadedDocument
+	{
+		/// hash of the document text
+		uint64_t hash;
+		/// setups defined by the document
+		std::vector<ReloadSummary::Setup> setups;
+	};
+
+	/// Record of the previous load, used by reload
+	struct LoadRecord
+	{
+		LoadOptions options;
+		/// all documents are recorded, false for snapshots or manually filled databases
+		bool complete = false;
+		std::vector<LoadedDocument> documents;
+	};
+
+	LoadRecord mLoadRecord;
+
+	/// Documents of a lazy load not decoded yet, views into a copy of their text
+	struct PendingDocuments
+	{
+		/// keeps the copied document text alive
+		std::shared_ptr<void const> source;
+		LoadOptions::Parser parser = LoadOptions::Parser::node;
+		std::map<halco::hicann::v2::Wafer, std::string_view> wafers;
+		std::map<std::string, std::string_view> dls_setups;
+		std::map<size_t, std::string_view> hxcube_setups;
+		std::map<size_t, std::string_view> jboa_setups;
+
+		bool empty() const;
+		void clear();
+	};
+
+	mutable PendingDocuments mPending;
+
+	mutable std::map<halco::hicann::v2::Wafer, WaferEntry> mWaferData;
+	mutable std::map<std::string, DLSSetupEntry> mDLSData;
+	mutable std::map<size_t, HXCubeSetupEntry> mHXCubeData;
+	mutable std::map<size_t, JboaSetupEntry> mJboaData;
+
+	/// Guards materialization of pending documents and the indexes, allows concurrent
+	/// queries of a loaded database. Recursive since const accessors build on each other.
+	mutable std::recursive_mutex mMutex;
+	/// documents are pending, see lock_pending
+	mutable std::atomic<bool> mLazy{false};
+	mutable std::shared_ptr<detail::Indexes const> mIndexes;
+	IndexDefinitions mIndexDefinitions;
 
 	static std::string const default_path;
 #endif
 };
 
+#ifndef PYPLUSPLUS
+template <typename Data, typename Pending, typename F>
+void database::for_each_key(Data const& data, Pending const& pending, F& f)
+{
+	auto it = data.begin();
+	auto pending_it = pending.begin();
+	while (it != data.end() || pending_it != pending.end()) {
+		if (pending_it == pending.end() || (it != data.end() && it->first < pending_it->first)) {
+			f(it->first);
+			++it;
+		} else {
+			f(pending_it->first);
+			++pending_it;
+		}
+	}
+}
+
+template <typename F>
+void database::for_each_wafer_coordinate(F&& f) const
+{
+	auto const lock = lock_pending();
+	for_each_key(mWaferData, mPending.wafers, f);
+}
+
+template <typename F>
+void database::for_each_dls_setup_id(F&& f) const
+{
+	auto const lock = lock_pending();
+	for_each_key(mDLSData, mPending.dls_setups, f);
+}
+
+template <typename F>
+void database::for_each_hxcube_id(F&& f) const
+{
+	auto const lock = lock_pending();
+	for_each_key(mHXCubeData, mPending.hxcube_setups, f);
+}
+
+template <typename F>
+void database::for_each_jboa_id(F&& f) const
+{
+	auto const lock = lock_pending();
+	for_each_key(mJboaData, mPending.jboa_setups, f);
+}
+
+template <typename F>
+void database::for_each_hicann_entry(halco::hicann::v2::Wafer const wafer, F&& f) const
+{
+	get_wafer_entry(wafer).for_each_hicann(f);
+}
+#endif
+
+#ifndef PYPLUSPLUS
+/// Immutable database created by database::freeze.
+/// All setups are stored in contiguous tables sorted by their id, lookups are
+/// binary searches and iteration is linear. Nothing is modified after creation,
+/// so a frozen_database can be used from any number of threads without locking.
+/// Copies share the tables. The getters behave like their database counterparts.
+class GENPYBIND(visible) frozen_database
+{
+public:
+	bool has_wafer_entry(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	WaferEntry const& get_wafer_entry(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	std::vector<halco::hicann::v2::Wafer> get_wafer_coordinates() const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool has_fpga_entry(halco::hicann::v2::FPGAGlobal const fpga) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	FPGAEntry const& get_fpga_entry(halco::hicann::v2::FPGAGlobal const fpga) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	FPGAEntryMap get_fpga_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool has_reticle_entry(halco::hicann::v2::DNCGlobal const reticle) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ReticleEntry const& get_reticle_entry(halco::hicann::v2::DNCGlobal const reticle) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ReticleEntryMap get_reticle_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool has_ananas_entry(halco::hicann::v2::AnanasGlobal const ananas) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	AnanasEntry const& get_ananas_entry(halco::hicann::v2::AnanasGlobal const ananas) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	AnanasEntryMap get_ananas_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool has_hicann_entry(halco::hicann::v2::HICANNGlobal const hicann) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	HICANNEntry const& get_hicann_entry(halco::hicann::v2::HICANNGlobal const hicann) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	HICANNEntryMap get_hicann_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	HICANNEntryMap get_hicann_entries(halco::hicann::v2::FPGAGlobal const fpga) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	HICANNEntryMap get_hicann_entries(halco::hicann::v2::DNCGlobal const reticle) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool has_adc_entry(GlobalAnalog_t const analog) const GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ADCEntry const& get_adc_entry(GlobalAnalog_t const analog) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ADCEntryMap get_adc_entries(halco::hicann::v2::Wafer const wafer) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	ADCEntryMap get_adc_entries(halco::hicann::v2::FPGAGlobal const fpga) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	std::vector<std::string> get_adc_serials() const SYMBOL_VISIBLE;
+	std::vector<ADCChannel> get_adc_channels(std::string const& adc) const
+	    GENPYBIND(hidden) SYMBOL_VISIBLE;
+	std::vector<ADCConflict> get_adc_conflicts() const GENPYBIND(hidden) SYMBOL_VISIBLE;
+
+	bool has_dls_entry(std::string const dls_setup) const SYMBOL_VISIBLE;
+	DLSSetupEntry const& get_dls_entry(std::string const dls_setup) const SYMBOL_VISIBLE;
+	std::vector<std::string> get_dls_setup_ids() const SYMBOL_VISIBLE;
+
+	bool has_hxcube_setup_entry(size_t const hxcube_id) const SYMBOL_VISIBLE;
+	HXCubeSetupEntry const& get_hxcube_setup_entry(size_t const hxcube_id) const SYMBOL_VISIBLE;
+	std::vector<size_t> get_hxcube_ids() const SYMBOL_VISIBLE;
+
+	bool has_jboa_setup_entry(size_t const jboa_id) const SYMBOL_VISIBLE;
+	JboaSetupEntry const& get_jboa_setup_entry(size_t const jboa_id) const SYMBOL_VISIBLE;
+	std::vector<size_t> get_jboa_ids() const SYMBOL_VISIBLE;
+
+	/// see database::find_endpoints
+	std::vector<NetworkEndpoint> find_endpoints(halco::common::IPv4 const& ip) const
+	    SYMBOL_VISIBLE;
+	std::vector<NetworkEndpoint> find_endpoints(
+	    halco::common::IPv4 const& ip, uint16_t const port) const SYMBOL_VISIBLE;
+	std::vector<NetworkEndpoint> find_endpoints_in_subnet(
+	    halco::common::IPv4 const& network, size_t const prefix_length) const SYMBOL_VISIBLE;
+
+	/// see database::find_chip
+	std::optional<UniqueBranchIdentifier> find_chip(size_t const chip_serial) const
+	    SYMBOL_VISIBLE;
+	std::string get_unique_branch_identifier(size_t const chip_serial) const SYMBOL_VISIBLE;
+	std::vector<std::string> get_unique_branch_identifiers(
+	    std::vector<size_t> const& chip_serials) const SYMBOL_VISIBLE;
+	/// see database::find_fpga_by_fuse_dna
+	std::optional<FPGALocation> find_fpga_by_fuse_dna(uint64_t const fuse_dna) const
+	    SYMBOL_VISIBLE;
+	std::optional<FPGALocation> find_fpga_by_dna_port(uint64_t const dna_port) const
+	    SYMBOL_VISIBLE;
+	std::vector<std::optional<FPGALocation> > find_fpgas_by_dna_port(
+	    std::vector<uint64_t> const& dna_ports) const SYMBOL_VISIBLE;
+
+	/// see database::add_index, the indexes registered when freezing are available
+	template <typename Entity>
+	bool has_index(std::string const& name) const SYMBOL_VISIBLE;
+	template <typename Entity>
+	std::vector<typename IndexedEntity<Entity>::coordinate_type> find_by_index(
+	    std::string const& name, IndexKey const& key) const SYMBOL_VISIBLE;
+	template <typename Entity>
+	std::vector<typename IndexedEntity<Entity>::coordinate_type> find_by_index_range(
+	    std::string const& name, IndexKey const& lower, IndexKey const& upper) const
+	    SYMBOL_VISIBLE;
+
+private:
+	friend class database;
+
+	struct Tables;
+	explicit frozen_database(std::shared_ptr<Tables const> tables);
+
+	WaferEntry const* find_wafer(halco::hicann::v2::Wafer const wafer) const;
+
+	std::shared_ptr<Tables const> m_tables;
+};
+#endif
+
 } // namespace hwdb4cpp
@@ -0,0 +1,489 @@
+#include "indexes.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+using namespace halco::common;
+using namespace halco::hicann::v2;
+
+namespace hwdb4cpp {
+
+namespace {
+
+uint32_t address(IPv4 const& ip)
+{
+	return (uint32_t(ip[0]) << 24) | (uint32_t(ip[1]) << 16) | (uint32_t(ip[2]) << 8) |
+	       uint32_t(ip[3]);
+}
+
+auto sort_key(NetworkEndpoint const& endpoint)
+{
+	return std::make_tuple(
+	    address(endpoint.ip), endpoint.port, endpoint.owner, endpoint.setup, endpoint.index,
+	    endpoint.sub_index);
+}
+
+/// endpoints between the addresses first and last (inclusive)
+std::vector<NetworkEndpoint> address_range(
+    std::vector<NetworkEndpoint> const& endpoints, uint32_t const first, uint32_t const last)
+{
+	auto const begin = std::lower_bound(
+	    endpoints.begin(), endpoints.end(), first,
+	    [](NetworkEndpoint const& item, uint32_t const value) { return address(item.ip) < value; });
+	auto const end = std::upper_bound(
+	    begin, endpoints.end(), last,
+	    [](uint32_t const value, NetworkEndpoint const& item) { return value < address(item.ip); });
+	return std::vector<NetworkEndpoint>(begin, end);
+}
+
+} // anonymous namespace
+
+Wafer NetworkEndpoint::get_wafer() const
+{
+	switch (owner) {
+		case EndpointOwner::fpga:
+		case EndpointOwner::ananas_data:
+		case EndpointOwner::ananas_reset:
+		case EndpointOwner::adc:
+		case EndpointOwner::macu:
+			return Wafer(setup);
+		default:
+			throw std::runtime_error("network endpoint is not located on a wafer");
+	}
+}
+
+FPGAGlobal NetworkEndpoint::get_fpga() const
+{
+	if (owner != EndpointOwner::fpga && owner != EndpointOwner::adc) {
+		throw std::runtime_error("network endpoint does not belong to a wafer FPGA");
+	}
+	return FPGAGlobal(FPGAOnWafer(Enum(index)), Wafer(setup));
+}
+
+AnanasGlobal NetworkEndpoint::get_ananas() const
+{
+	if (owner != EndpointOwner::ananas_data && owner != EndpointOwner::ananas_reset) {
+		throw std::runtime_error("network endpoint does not belong to an Ananas");
+	}
+	return AnanasGlobal(AnanasOnWafer(Enum(index)), Wafer(setup));
+}
+
+GlobalAnalog_t NetworkEndpoint::get_analog() const
+{
+	if (owner != EndpointOwner::adc) {
+		throw std::runtime_error("network endpoint does not belong to an ADC");
+	}
+	return GlobalAnalog_t(get_fpga(), AnalogOnHICANN(Enum(sub_index)));
+}
+
+bool NetworkEndpoint::operator==(NetworkEndpoint const& other) const
+{
+	return ip == other.ip && sort_key(*this) == sort_key(other);
+}
+
+bool NetworkEndpoint::operator!=(NetworkEndpoint const& other) const
+{
+	return !(*this == other);
+}
+
+namespace detail {
+
+void Indexes::add_endpoint(
+    IPv4 const& ip,
+    uint16_t const port,
+    EndpointOwner const owner,
+    size_t const setup,
+    size_t const index,
+    size_t const sub_index)
+{
+	if (ip.is_unspecified()) {
+		return;
+	}
+	m_endpoints.push_back(NetworkEndpoint{ip, port, owner, setup, index, sub_index});
+}
+
+void Indexes::add_wafer(Wafer const wafer, WaferEntry const& entry)
+{
+	for (auto const& item : entry.fpgas) {
+		add_endpoint(
+		    item.second.ip, 0, EndpointOwner::fpga, wafer, item.first.toFPGAOnWafer().value());
+	}
+	for (auto const& item : entry.ananas) {
+		size_t const ananas = item.first.toAnanasOnWafer().value();
+		for (size_t slice = 0; slice < AnanasSliceOnAnanas::size; ++slice) {
+			// slices use consecutive ports after the base ports
+			size_t const data = item.second.baseport_data.value() + slice;
+			size_t const reset = item.second.baseport_reset.value() + slice;
+			if (data <= std::numeric_limits<uint16_t>::max()) {
+				add_endpoint(
+				    item.second.ip, data, EndpointOwner::ananas_data, wafer, ananas, slice);
+			}
+			if (reset <= std::numeric_limits<uint16_t>::max()) {
+				add_endpoint(
+				    item.second.ip, reset, EndpointOwner::ananas_reset, wafer, ananas, slice);
+			}
+		}
+	}
+	for (auto const& item : entry.adcs) {
+		add_endpoint(
+		    item.second.remote_ip, item.second.remote_port.value(), EndpointOwner::adc, wafer,
+		    item.first.first.toFPGAOnWafer().value(), item.first.second.value());
+		auto const handle = m_adc_handles.emplace(item.second.coord, m_adc_serials.size());
+		if (handle.second) {
+			m_adc_serials.push_back(item.second.coord);
+			m_adc_channels.emplace_back();
+		}
+		m_adc_channels[handle.first->second].push_back(
+		    ADCChannel{item.first, item.second.channel, item.second.trigger});
+	}
+	add_endpoint(entry.macu, 0, EndpointOwner::macu, wafer, 0);
+	for (auto const& item : m_secondary_indexes) {
+		item.second->add_wafer(wafer, entry);
+	}
+}
+
+void Indexes::add_fpgas(
+    SetupFamily const family, size_t const setup_id, std::map<size_t, HXCubeFPGAEntry> const& fpgas)
+{
+	for (auto const& item : fpgas) {
+		if (item.second.fuse_dna) {
+			FPGALocation const fpga{family, setup_id, item.first};
+			m_fuse_dnas.emplace(*item.second.fuse_dna, fpga);
+			m_dna_ports.emplace(
+			    HXCubeFPGAEntry::dna_port_from_fuse_dna(*item.second.fuse_dna), fpga);
+		}
+		if (!item.second.wing) {
+			continue;
+		}
+		HXCubeWingEntry const& wing = *item.second.wing;
+		UniqueBranchIdentifier id;
+		id.family = family;
+		id.setup_id = setup_id;
+		id.fpga_id = item.first;
+		id.chip_serial = wing.handwritten_chip_serial;
+		// valid handwritten serials start from 1
+		if (wing.handwritten_chip_serial) {
+			m_handwritten_chip_serials.emplace(wing.handwritten_chip_serial, id);
+		}
+		if (wing.eeprom_chip_serial) {
+			m_eeprom_chip_serials.emplace(*wing.eeprom_chip_serial, id);
+		}
+	}
+}
+
+void Indexes::add_hxcube_setup(size_t const hxcube_id, HXCubeSetupEntry const& entry)
+{
+	for (auto const& item : entry.fpgas) {
+		add_endpoint(item.second.ip, 0, EndpointOwner::hxcube_fpga, hxcube_id, item.first);
+	}
+	add_fpgas(SetupFamily::hxcube, hxcube_id, entry.fpgas);
+	for (auto const& item : m_secondary_indexes) {
+		item.second->add_hxcube_setup(hxcube_id, entry);
+	}
+}
+
+void Indexes::add_jboa_setup(size_t const jboa_id, JboaSetupEntry const& entry)
+{
+	for (auto const& item : entry.fpgas) {
+		add_endpoint(item.second.ip, 0, EndpointOwner::jboa_fpga, jboa_id, item.first);
+	}
+	for (auto const& item : entry.aggregators) {
+		add_endpoint(item.second.ip, 0, EndpointOwner::jboa_aggregator, jboa_id, item.first);
+	}
+	add_fpgas(SetupFamily::jboa, jboa_id, entry.fpgas);
+	for (auto const& item : m_secondary_indexes) {
+		item.second->add_jboa_setup(jboa_id, entry);
+	}
+}
+
+void Indexes::add_secondary_index(
+    std::pair<std::type_index, std::string> const& id, SecondaryIndexBase const& prototype)
+{
+	m_secondary_indexes[id] = prototype.make_empty();
+}
+
+void Indexes::finish()
+{
+	std::sort(
+	    m_endpoints.begin(), m_endpoints.end(),
+	    [](NetworkEndpoint const& a, NetworkEndpoint const& b) {
+		    return sort_key(a) < sort_key(b);
+	    });
+	m_endpoints.shrink_to_fit();
+
+	// channels of an ADC are added in order of their analog output, the same ADC
+	// channel wired to several outputs yields a conflict for each pair
+	for (size_t handle = 0; handle < m_adc_channels.size(); ++handle) {
+		auto const& channels = m_adc_channels[handle];
+		for (auto first = channels.begin(); first != channels.end(); ++first) {
+			for (auto second = std::next(first); second != channels.end(); ++second) {
+				if (first->channel == second->channel) {
+					m_adc_conflicts.push_back(ADCConflict{m_adc_serials[handle], *first, *second});
+				}
+			}
+		}
+	}
+
+	for (auto const& item : m_secondary_indexes) {
+		item.second->finish();
+	}
+}
+
+std::vector<NetworkEndpoint> Indexes::find_endpoints(IPv4 const& ip) const
+{
+	return address_range(m_endpoints, address(ip), address(ip));
+}
+
+std::vector<NetworkEndpoint> Indexes::find_endpoints(IPv4 const& ip, uint16_t const port) const
+{
+	typedef std::pair<uint32_t, uint16_t> Key;
+	Key const key(address(ip), port);
+	auto const begin = std::lower_bound(
+	    m_endpoints.begin(), m_endpoints.end(), key,
+	    [](NetworkEndpoint const& item, Key const& value) {
+		    return Key(address(item.ip), item.port) < value;
+	    });
+	auto const end = std::upper_bound(
+	    begin, m_endpoints.end(), key, [](Key const& value, NetworkEndpoint const& item) {
+		    return value < Key(address(item.ip), item.port);
+	    });
+	return std::vector<NetworkEndpoint>(begin, end);
+}
+
+std::vector<NetworkEndpoint> Indexes::find_endpoints_in_subnet(
+    IPv4 const& network, size_t const prefix_length) const
+{
+	if (prefix_length > 32) {
+		throw std::invalid_argument(
+		    "invalid subnet prefix length " + std::to_string(prefix_length));
+	}
+	uint32_t const mask = prefix_length == 0 ? 0 : ~uint32_t(0) << (32 - prefix_length);
+	uint32_t const first = address(network) & mask;
+	return address_range(m_endpoints, first, first | ~mask);
+}
+
+UniqueBranchIdentifier const* Indexes::find_chip(size_t const chip_serial) const
+{
+	auto it = m_handwritten_chip_serials.find(chip_serial);
+	if (it != m_handwritten_chip_serials.end()) {
+		return &it->second;
+	}
+	it = m_eeprom_chip_serials.find(chip_serial);
+	return it == m_eeprom_chip_serials.end() ? nullptr : &it->second;
+}
+
+std::string Indexes::get_unique_branch_identifier(size_t const chip_serial) const
+{
+	UniqueBranchIdentifier const* const id = find_chip(chip_serial);
+	if (!id) {
+		throw std::runtime_error("No chip with serial " + std::to_string(chip_serial) + " found");
+	}
+	return id->to_string();
+}
+
+std::vector<std::string> Indexes::get_unique_branch_identifiers(
+    std::vector<size_t> const& chip_serials) const
+{
+	std::vector<std::string> ret;
+	ret.reserve(chip_serials.size());
+	for (size_t const chip_serial : chip_serials) {
+		ret.push_back(get_unique_branch_identifier(chip_serial));
+	}
+	return ret;
+}
+
+std::vector<std::string> const& Indexes::get_adc_serials() const
+{
+	return m_adc_serials;
+}
+
+std::vector<ADCChannel> const* Indexes::find_adc_channels(std::string const& adc) const
+{
+	auto const it = m_adc_handles.find(adc);
+	return it == m_adc_handles.end() ? nullptr : &m_adc_channels[it->second];
+}
+
+std::vector<ADCConflict> const& Indexes::get_adc_conflicts() const
+{
+	return m_adc_conflicts;
+}
+
+FPGALocation const* Indexes::find_fpga_by_fuse_dna(uint64_t const fuse_dna) const
+{
+	auto const it = m_fuse_dnas.find(fuse_dna);
+	return it == m_fuse_dnas.end() ? nullptr : &it->second;
+}
+
+FPGALocation const* Indexes::find_fpga_by_dna_port(uint64_t const dna_port) const
+{
+	auto const it = m_dna_ports.find(dna_port);
+	return it == m_dna_ports.end() ? nullptr : &it->second;
+}
+
+std::vector<std::optional<FPGALocation> > Indexes::find_fpgas_by_dna_port(
+    std::vector<uint64_t> const& dna_ports) const
+{
+	std::vector<std::optional<FPGALocation> > ret;
+	ret.reserve(dna_ports.size());
+	for (uint64_t const dna_port : dna_ports) {
+		FPGALocation const* const fpga = find_fpga_by_dna_port(dna_port);
+		ret.push_back(fpga ? std::optional<FPGALocation>(*fpga) : std::nullopt);
+	}
+	return ret;
+}
+
+template <typename Entity>
+SecondaryIndex<Entity>::SecondaryIndex(
+    std::string name, Extractor extractor, IndexKind const kind) :
+    m_name(std::move(name)), m_extractor(std::move(extractor)), m_kind(kind)
+{}
+
+template <typename Entity>
+std::unique_ptr<SecondaryIndexBase> SecondaryIndex<Entity>::make_empty() const
+{
+	return std::make_unique<SecondaryIndex<Entity> >(m_name, m_extractor, m_kind);
+}
+
+template <typename Entity>
+void SecondaryIndex<Entity>::add(Coordinate const& coordinate, Entity const& entry)
+{
+	std::optional<IndexKey> key = m_extractor(entry);
+	if (!key) {
+		return;
+	}
+	if (m_kind == IndexKind::hash) {
+		m_hashed[std::move(*key)].push_back(coordinate);
+	} else {
+		m_ordered.emplace_back(std::move(*key), coordinate);
+	}
+}
+
+template <typename Entity>
+void SecondaryIndex<Entity>::add_wafer(Wafer const wafer, WaferEntry const& entry)
+{
+	if constexpr (std::is_same_v<Entity, WaferEntry>) {
+		add(wafer, entry);
+	} else if constexpr (std::is_same_v<Entity, FPGAEntry>) {
+		for (auto const& item : entry.fpgas) {
+			add(item.first, item.second);
+		}
+	} else if constexpr (std::is_same_v<Entity, ReticleEntry>) {
+		for (auto const& item : entry.reticles) {
+			add(item.first, item.second);
+		}
+	} else if constexpr (std::is_same_v<Entity, AnanasEntry>) {
+		for (auto const& item : entry.ananas) {
+			add(item.first, item.second);
+		}
+	} else if constexpr (std::is_same_v<Entity, HICANNEntry>) {
+		entry.for_each_hicann(
+		    [this](HICANNGlobal const hicann, HICANNEntry const& item) { add(hicann, item); });
+	} else if constexpr (std::is_same_v<Entity, ADCEntry>) {
+		for (auto const& item : entry.adcs) {
+			add(item.first, item.second);
+		}
+	}
+}
+
+template <typename Entity>
+void SecondaryIndex<Entity>::add_hxcube_setup(size_t const hxcube_id, HXCubeSetupEntry const& entry)
+{
+	if constexpr (std::is_same_v<Entity, HXCubeSetupEntry>) {
+		add(hxcube_id, entry);
+	} else if constexpr (std::is_same_v<Entity, HXCubeFPGAEntry>) {
+		for (auto const& item : entry.fpgas) {
+			add(FPGALocation{SetupFamily::hxcube, hxcube_id, item.first}, item.second);
+		}
+	} else if constexpr (std::is_same_v<Entity, HXCubeWingEntry>) {
+		for (auto const& item : entry.fpgas) {
+			if (item.second.wing) {
+				add(FPGALocation{SetupFamily::hxcube, hxcube_id, item.first}, *item.second.wing);
+			}
+		}
+	}
+}
+
+template <typename Entity>
+void SecondaryIndex<Entity>::add_jboa_setup(size_t const jboa_id, JboaSetupEntry const& entry)
+{
+	if constexpr (std::is_same_v<Entity, JboaSetupEntry>) {
+		add(jboa_id, entry);
+	} else if constexpr (std::is_same_v<Entity, HXCubeFPGAEntry>) {
+		for (auto const& item : entry.fpgas) {
+			add(FPGALocation{SetupFamily::jboa, jboa_id, item.first}, item.second);
+		}
+	} else if constexpr (std::is_same_v<Entity, HXCubeWingEntry>) {
+		for (auto const& item : entry.fpgas) {
+			if (item.second.wing) {
+				add(FPGALocation{SetupFamily::jboa, jboa_id, item.first}, *item.second.wing);
+			}
+		}
+	} else if constexpr (std::is_same_v<Entity, JboaAggregatorEntry>) {
+		for (auto const& item : entry.aggregators) {
+			add(std::make_pair(jboa_id, item.first), item.second);
+		}
+	}
+}
+
+template <typename Entity>
+void SecondaryIndex<Entity>::finish()
+{
+	std::stable_sort(
+	    m_ordered.begin(), m_ordered.end(),
+	    [](auto const& a, auto const& b) { return a.first < b.first; });
+	m_ordered.shrink_to_fit();
+}
+
+template <typename Entity>
+std::vector<typename SecondaryIndex<Entity>::Coordinate> SecondaryIndex<Entity>::find(
+    IndexKey const& key) const
+{
+	if (m_kind == IndexKind::hash) {
+		auto const it = m_hashed.find(key);
+		return it == m_hashed.end() ? std::vector<Coordinate>() : it->second;
+	}
+	return find_range(key, key);
+}
+
+template <typename Entity>
+std::vector<typename SecondaryIndex<Entity>::Coordinate> SecondaryIndex<Entity>::find_range(
+    IndexKey const& lower, IndexKey const& upper) const
+{
+	if (m_kind != IndexKind::ordered) {
+		throw std::invalid_argument("index " + m_name + " does not support range lookups");
+	}
+	auto const begin = std::lower_bound(
+	    m_ordered.begin(), m_ordered.end(), lower,
+	    [](auto const& item, IndexKey const& value) { return item.first < value; });
+	auto const end = std::upper_bound(
+	    begin, m_ordered.end(), upper,
+	    [](IndexKey const& value, auto const& item) { return value < item.first; });
+	std::vector<Coordinate> ret;
+	ret.reserve(std::distance(begin, end));
+	for (auto it = begin; it != end; ++it) {
+		ret.push_back(it->second);
+	}
+	return ret;
+}
+
+template class SecondaryIndex<WaferEntry>;
+template class SecondaryIndex<FPGAEntry>;
+template class SecondaryIndex<ReticleEntry>;
+template class SecondaryIndex<AnanasEntry>;
+template class SecondaryIndex<HICANNEntry>;
+template class SecondaryIndex<ADCEntry>;
+template class SecondaryIndex<HXCubeSetupEntry>;
+template class SecondaryIndex<JboaSetupEntry>;
+template class SecondaryIndex<HXCubeFPGAEntry>;
+template class SecondaryIndex<HXCubeWingEntry>;
+template class SecondaryIndex<JboaAggregatorEntry>;
+
+} // namespace detail
+
+} // namespace hwdb4cpp
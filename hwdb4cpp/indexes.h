@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hwdb4cpp.h"
+
+namespace hwdb4cpp {
+namespace detail {
+
+/// Secondary index over a field of all entries of one type, see database::add_index.
+/// Registered indexes are unbuilt prototypes, make_empty() creates the index filled
+/// by Indexes.
+class SecondaryIndexBase
+{
+public:
+	virtual ~SecondaryIndexBase() = default;
+
+	virtual std::unique_ptr<SecondaryIndexBase> make_empty() const = 0;
+	virtual void add_wafer(halco::hicann::v2::Wafer const wafer, WaferEntry const& entry) = 0;
+	virtual void add_hxcube_setup(size_t const hxcube_id, HXCubeSetupEntry const& entry) = 0;
+	virtual void add_jboa_setup(size_t const jboa_id, JboaSetupEntry const& entry) = 0;
+	virtual void finish() = 0;
+};
+
+template <typename Entity>
+class SecondaryIndex : public SecondaryIndexBase
+{
+public:
+	typedef typename IndexedEntity<Entity>::coordinate_type Coordinate;
+	typedef database::IndexExtractor<Entity> Extractor;
+
+	SecondaryIndex(std::string name, Extractor extractor, IndexKind const kind);
+
+	std::unique_ptr<SecondaryIndexBase> make_empty() const override;
+	void add_wafer(halco::hicann::v2::Wafer const wafer, WaferEntry const& entry) override;
+	void add_hxcube_setup(size_t const hxcube_id, HXCubeSetupEntry const& entry) override;
+	void add_jboa_setup(size_t const jboa_id, JboaSetupEntry const& entry) override;
+	void finish() override;
+
+	std::vector<Coordinate> find(IndexKey const& key) const;
+	/// @throws std::invalid_argument if the index is not ordered
+	std::vector<Coordinate> find_range(IndexKey const& lower, IndexKey const& upper) const;
+
+private:
+	void add(Coordinate const& coordinate, Entity const& entry);
+
+	std::string m_name;
+	Extractor m_extractor;
+	IndexKind m_kind;
+	/// hash indexes, coordinates in order of addition
+	std::unordered_map<IndexKey, std::vector<Coordinate> > m_hashed;
+	/// ordered indexes, sorted by key and stable in order of addition
+	std::vector<std::pair<IndexKey, Coordinate> > m_ordered;
+};
+
+/// Reverse indexes over all entries of a database, internal to hwdb4cpp.
+/// Entries are added once, finish() sorts the tables and afterwards the indexes
+/// are immutable and shared between a database and the frozen_databases created
+/// from it.
+class Indexes
+{
+public:
+	void add_wafer(halco::hicann::v2::Wafer const wafer, WaferEntry const& entry);
+	void add_hxcube_setup(size_t const hxcube_id, HXCubeSetupEntry const& entry);
+	void add_jboa_setup(size_t const jboa_id, JboaSetupEntry const& entry);
+	/// add an empty copy of a registered index, before adding any setup
+	void add_secondary_index(
+	    std::pair<std::type_index, std::string> const& id, SecondaryIndexBase const& prototype);
+	void finish();
+
+	std::vector<NetworkEndpoint> find_endpoints(halco::common::IPv4 const& ip) const;
+	std::vector<NetworkEndpoint> find_endpoints(
+	    halco::common::IPv4 const& ip, uint16_t const port) const;
+	/// @throws std::invalid_argument if prefix_length exceeds 32
+	std::vector<NetworkEndpoint> find_endpoints_in_subnet(
+	    halco::common::IPv4 const& network, size_t const prefix_length) const;
+
+	/// see database::find_chip, nullptr if there is no such chip
+	UniqueBranchIdentifier const* find_chip(size_t const chip_serial) const;
+	/// @throws std::runtime_error if there is no chip with that serial
+	std::string get_unique_branch_identifier(size_t const chip_serial) const;
+	std::vector<std::string> get_unique_branch_identifiers(
+	    std::vector<size_t> const& chip_serials) const;
+
+	std::vector<std::string> const& get_adc_serials() const;
+	/// see database::get_adc_channels, nullptr if there is no such ADC
+	std::vector<ADCChannel> const* find_adc_channels(std::string const& adc) const;
+	std::vector<ADCConflict> const& get_adc_conflicts() const;
+
+	/// see database::find_fpga_by_fuse_dna, nullptr if there is no such FPGA
+	FPGALocation const* find_fpga_by_fuse_dna(uint64_t const fuse_dna) const;
+	FPGALocation const* find_fpga_by_dna_port(uint64_t const dna_port) const;
+	std::vector<std::optional<FPGALocation> > find_fpgas_by_dna_port(
+	    std::vector<uint64_t> const& dna_ports) const;
+
+	/// nullptr if there is no such index
+	template <typename Entity>
+	SecondaryIndex<Entity> const* find_secondary_index(std::string const& name) const
+	{
+		auto const it =
+		    m_secondary_indexes.find(std::make_pair(std::type_index(typeid(Entity)), name));
+		if (it == m_secondary_indexes.end()) {
+			return nullptr;
+		}
+		return static_cast<SecondaryIndex<Entity> const*>(it->second.get());
+	}
+
+	/// @throws std::out_of_range if there is no such index
+	template <typename Entity>
+	SecondaryIndex<Entity> const& get_secondary_index(std::string const& name) const
+	{
+		SecondaryIndex<Entity> const* const index = find_secondary_index<Entity>(name);
+		if (!index) {
+			throw std::out_of_range("no index " + name + " in hwdb");
+		}
+		return *index;
+	}
+
+private:
+	void add_endpoint(
+	    halco::common::IPv4 const& ip,
+	    uint16_t const port,
+	    EndpointOwner const owner,
+	    size_t const setup,
+	    size_t const index,
+	    size_t const sub_index = 0);
+	/// chips and FPGA DNAs of a HX cube or jBOA setup
+	void add_fpgas(
+	    SetupFamily const family,
+	    size_t const setup_id,
+	    std::map<size_t, HXCubeFPGAEntry> const& fpgas);
+
+	/// sorted by address, port, owner and coordinates
+	std::vector<NetworkEndpoint> m_endpoints;
+	/// chips by serial, the first chip added wins
+	std::unordered_map<size_t, UniqueBranchIdentifier> m_handwritten_chip_serials;
+	std::unordered_map<size_t, UniqueBranchIdentifier> m_eeprom_chip_serials;
+	/// ADC serials are interned, handles index m_adc_serials and m_adc_channels
+	std::unordered_map<std::string, size_t> m_adc_handles;
+	std::vector<std::string> m_adc_serials;
+	std::vector<std::vector<ADCChannel> > m_adc_channels;
+	std::vector<ADCConflict> m_adc_conflicts;
+	/// FPGAs by DNA, the first FPGA added wins
+	std::unordered_map<uint64_t, FPGALocation> m_fuse_dnas;
+	std::unordered_map<uint64_t, FPGALocation> m_dna_ports;
+	/// by entry type and name
+	std::map<std::pair<std::type_index, std::string>, std::unique_ptr<SecondaryIndexBase> >
+	    m_secondary_indexes;
+};
+
+} // namespace detail
+} // namespace hwdb4cpp
@@ -0,0 +1,79 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hwdb4cpp {
+namespace detail {
+
+MappedFile::MappedFile(std::string const& path) : m_mapping(MAP_FAILED), m_mapping_size(0)
+{
+	int const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		throw std::runtime_error("cannot open hwdb file " + path + ": " + std::strerror(errno));
+	}
+	try {
+		init(fd, "file " + path);
+	} catch (...) {
+		close(fd);
+		throw;
+	}
+	close(fd);
+}
+
+MappedFile::MappedFile(int const fd) : m_mapping(MAP_FAILED), m_mapping_size(0)
+{
+	init(fd, "descriptor " + std::to_string(fd));
+}
+
+void MappedFile::init(int const fd, std::string const& name)
+{
+	struct stat st;
+	bool const regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+	off_t const offset = regular ? lseek(fd, 0, SEEK_CUR) : -1;
+	if (regular && offset >= 0 && offset < st.st_size) {
+		size_t const size = static_cast<size_t>(st.st_size);
+		void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			madvise(mapping, size, MADV_SEQUENTIAL);
+			m_mapping = mapping;
+			m_mapping_size = size;
+			m_data = std::string_view(static_cast<char const*>(mapping), size).substr(offset);
+			lseek(fd, 0, SEEK_END);
+			return;
+		}
+	}
+
+	// not mappable, read whole file instead
+	if (regular) {
+		m_buffer.reserve(static_cast<size_t>(st.st_size));
+	}
+	char chunk[65536];
+	while (true) {
+		ssize_t const count = read(fd, chunk, sizeof(chunk));
+		if (count > 0) {
+			m_buffer.append(chunk, static_cast<size_t>(count));
+		} else if (count == 0) {
+			break;
+		} else if (errno != EINTR) {
+			throw std::runtime_error("cannot read hwdb " + name + ": " + std::strerror(errno));
+		}
+	}
+	m_data = m_buffer;
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_mapping != MAP_FAILED) {
+		munmap(m_mapping, m_mapping_size);
+	}
+}
+
+} // namespace detail
+} // namespace hwdb4cpp
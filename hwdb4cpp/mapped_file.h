@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace hwdb4cpp {
+namespace detail {
+
+/// Read-only contents of a file, internal to hwdb4cpp.
+/// Regular files are memory-mapped with sequential access advice, everything else
+/// (pipes, procfs, empty files) is read in one go into an owned buffer.
+class MappedFile
+{
+public:
+	/// @throws std::runtime_error if the file cannot be opened or read
+	explicit MappedFile(std::string const& path);
+	/// Contents of fd from its current position on, fd is not closed.
+	/// @throws std::runtime_error if fd cannot be read
+	explicit MappedFile(int fd);
+	~MappedFile();
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	std::string_view data() const { return m_data; }
+
+private:
+	void init(int fd, std::string const& name);
+
+	void* m_mapping;
+	size_t m_mapping_size;
+	std::string m_buffer;
+	std::string_view m_data;
+};
+
+/// Read-only stream buffer over memory owned by someone else, used to hand mapped
+/// contents to yaml-cpp without copying them into a std::string first.
+class MemoryStreambuf : public std::streambuf
+{
+public:
+	explicit MemoryStreambuf(std::string_view const data)
+	{
+		char* begin = const_cast<char*>(data.data());
+		setg(begin, begin, begin + data.size());
+	}
+};
+
+/// FNV-1a hash of data, used to detect changed file contents
+inline uint64_t fnv1a(char const* data, size_t size)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+} // namespace detail
+} // namespace hwdb4cpp
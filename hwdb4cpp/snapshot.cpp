@@ -0,0 +1,725 @@
+#include "hwdb4cpp.h"
+#include "mapped_file.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <sys/stat.h>
+
+#include <log4cxx/logger.h>
+#include "halco/common/iter_all.h"
+
+using namespace halco::common;
+using namespace halco::hicann::v2;
+using namespace hwdb4cpp;
+
+/// Binary Snapshot File Format:
+/// ============================
+///
+/// A snapshot is a compact binary image of the whole database which is stored
+/// next to the YAML source (see database::get_snapshot_path). It starts with a
+/// fixed size header, all integers are stored little-endian:
+///  - magic: 8 bytes "HWDBSNAP"
+///  - version: uint32, snapshot_format_version, bumped on every layout change
+///  - reserved: uint32, always 0
+///  - source_size: uint64, size of the YAML source in bytes
+///  - source_mtime: int64, modification time of the YAML source in ns
+///  - source_hash: uint64, FNV-1a hash of the YAML source contents
+///  - payload_size: uint64, size of the payload in bytes
+///  - payload_hash: uint64, FNV-1a hash of the payload
+///
+/// The payload contains the wafer, DLS, HX cube and jBOA tables in this order.
+/// Each table is a count followed by its key/entry pairs in map order. Strings
+/// are stored as uint32 length followed by the characters, optional values as a
+/// uint8 presence flag followed by the value if present.
+///
+/// The hwdb4cpp_embedded library carries a snapshot of the YAML database it was
+/// built from as static data (see embed_database.cpp and database::load_embedded).
+
+using detail::fnv1a;
+
+namespace {
+
+char const snapshot_magic[8] = {'H', 'W', 'D', 'B', 'S', 'N', 'A', 'P'};
+uint32_t const snapshot_format_version = 3;
+size_t const snapshot_header_size = 8 + 4 + 4 + 8 + 8 + 8 + 8 + 8;
+
+struct SourceInfo
+{
+	uint64_t size;
+	int64_t mtime;
+};
+
+bool stat_source(std::string const& path, SourceInfo& info)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+		return false;
+	}
+	info.size = static_cast<uint64_t>(st.st_size);
+	info.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+	return true;
+}
+
+bool read_file(std::string const& path, std::string& content)
+{
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	if (!in) {
+		return false;
+	}
+	in.seekg(0, std::ios::end);
+	auto const size = in.tellg();
+	if (size < 0) {
+		return false;
+	}
+	content.resize(static_cast<size_t>(size));
+	in.seekg(0, std::ios::beg);
+	in.read(&content[0], size);
+	return static_cast<bool>(in);
+}
+
+class SnapshotWriter
+{
+public:
+	void u8(uint8_t value) { m_data.push_back(static_cast<char>(value)); }
+
+	void u16(uint16_t value)
+	{
+		for (size_t i = 0; i < sizeof(value); ++i) {
+			u8(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	void u32(uint32_t value)
+	{
+		for (size_t i = 0; i < sizeof(value); ++i) {
+			u8(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	void u64(uint64_t value)
+	{
+		for (size_t i = 0; i < sizeof(value); ++i) {
+			u8(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	void boolean(bool value) { u8(value ? 1 : 0); }
+
+	void string(std::string const& value)
+	{
+		u32(static_cast<uint32_t>(value.size()));
+		m_data.append(value);
+	}
+
+	void ip(IPv4 const& value) { string(value.to_string()); }
+
+	std::string const& data() const { return m_data; }
+
+private:
+	std::string m_data;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(char const* data, size_t size) : m_data(data), m_size(size), m_pos(0) {}
+
+	uint8_t u8()
+	{
+		require(1);
+		return static_cast<uint8_t>(m_data[m_pos++]);
+	}
+
+	uint16_t u16() { return static_cast<uint16_t>(integer(sizeof(uint16_t))); }
+	uint32_t u32() { return static_cast<uint32_t>(integer(sizeof(uint32_t))); }
+	uint64_t u64() { return integer(sizeof(uint64_t)); }
+
+	bool boolean() { return u8() != 0; }
+
+	std::string string()
+	{
+		size_t const size = u32();
+		require(size);
+		std::string ret(m_data + m_pos, size);
+		m_pos += size;
+		return ret;
+	}
+
+	IPv4 ip() { return IPv4::from_string(string()); }
+
+	bool at_end() const { return m_pos == m_size; }
+
+private:
+	void require(size_t size) const
+	{
+		if (m_size - m_pos < size) {
+			throw std::runtime_error("truncated hwdb snapshot");
+		}
+	}
+
+	uint64_t integer(size_t bytes)
+	{
+		require(bytes);
+		uint64_t value = 0;
+		for (size_t i = 0; i < bytes; ++i) {
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(m_data[m_pos++])) << (8 * i);
+		}
+		return value;
+	}
+
+	char const* m_data;
+	size_t m_size;
+	size_t m_pos;
+};
+
+template <typename T>
+void write_optional(SnapshotWriter& out, std::optional<T> const& value, void (*write)(SnapshotWriter&, T const&))
+{
+	out.boolean(static_cast<bool>(value));
+	if (value) {
+		write(out, *value);
+	}
+}
+
+void write_timing(SnapshotWriter& out, std::array<std::array<uint16_t, 2>, 2> const& value)
+{
+	for (auto const& row : value) {
+		for (auto const& item : row) {
+			out.u16(item);
+		}
+	}
+}
+
+std::array<std::array<uint16_t, 2>, 2> read_timing(SnapshotReader& in)
+{
+	std::array<std::array<uint16_t, 2>, 2> value;
+	for (auto& row : value) {
+		for (auto& item : row) {
+			item = in.u16();
+		}
+	}
+	return value;
+}
+
+void write_wafer(SnapshotWriter& out, Wafer const wafer, WaferEntry const& entry)
+{
+	out.u8(static_cast<uint8_t>(entry.setup_type));
+
+	out.u32(static_cast<uint32_t>(entry.adcs.size()));
+	for (auto const& item : entry.adcs) {
+		out.u64(item.first.first.toEnum().value());
+		out.u64(item.first.second.value());
+		out.u8(static_cast<uint8_t>(item.second.loadCalibration));
+		out.string(item.second.coord);
+		out.u64(item.second.channel.value());
+		out.u64(item.second.trigger.value());
+		out.ip(item.second.remote_ip);
+		out.u64(item.second.remote_port.value());
+	}
+
+	out.u32(static_cast<uint32_t>(entry.fpgas.size()));
+	for (auto const& item : entry.fpgas) {
+		out.u64(item.first.toEnum().value());
+		out.ip(item.second.ip);
+		out.boolean(item.second.highspeed);
+	}
+
+	out.u32(static_cast<uint32_t>(entry.reticles.size()));
+	for (auto const& item : entry.reticles) {
+		out.u64(item.first.toEnum().value());
+		out.boolean(item.second.to_be_powered);
+	}
+
+	out.u32(static_cast<uint32_t>(entry.ananas.size()));
+	for (auto const& item : entry.ananas) {
+		out.u64(item.first.toEnum().value());
+		out.ip(item.second.ip);
+		out.u16(static_cast<uint16_t>(item.second.baseport_data.value()));
+		out.u16(static_cast<uint16_t>(item.second.baseport_reset.value()));
+	}
+
+	// HICANNs are stored individually or as the FPGAs covered by the full wafer
+	// shorthand followed by its shared entry
+	HICANNEntry const* shared = nullptr;
+	std::vector<FPGAGlobal> shared_fpgas;
+	for (auto fpga : iter_all<FPGAOnWafer>()) {
+		FPGAGlobal const fpga_global(fpga, wafer);
+		if (HICANNEntry const* const hicann_entry = entry.find_shared_hicann_entry(fpga_global)) {
+			shared = hicann_entry;
+			shared_fpgas.push_back(fpga_global);
+		}
+	}
+	std::vector<std::pair<HICANNGlobal, HICANNEntry const*> > hicanns;
+	if (!shared) {
+		entry.for_each_hicann([&hicanns](HICANNGlobal const hicann, HICANNEntry const& hicann_entry) {
+			hicanns.emplace_back(hicann, &hicann_entry);
+		});
+	}
+	out.u32(static_cast<uint32_t>(hicanns.size()));
+	for (auto const& item : hicanns) {
+		out.u64(item.first.toEnum().value());
+		out.u64(item.second->version);
+		out.string(item.second->label);
+	}
+	out.u32(static_cast<uint32_t>(shared_fpgas.size()));
+	for (auto const fpga : shared_fpgas) {
+		out.u64(fpga.toFPGAOnWafer().toEnum().value());
+	}
+	if (shared) {
+		out.u64(shared->version);
+		out.string(shared->label);
+	}
+
+	out.ip(entry.macu);
+	out.u64(entry.macu_version);
+}
+
+WaferEntry read_wafer(SnapshotReader& in, Wafer const wafer)
+{
+	WaferEntry entry;
+	entry.setup_type = static_cast<SetupType>(in.u8());
+
+	for (size_t n = in.u32(); n > 0; --n) {
+		FPGAGlobal const fpga{Enum(in.u64())};
+		AnalogOnHICANN const analog(in.u64());
+		ADCEntry adc;
+		adc.loadCalibration = static_cast<ADCEntry::CalibrationMode>(in.u8());
+		adc.coord = in.string();
+		adc.channel = ChannelOnADC(in.u64());
+		adc.trigger = TriggerOnADC(in.u64());
+		adc.remote_ip = in.ip();
+		adc.remote_port = TCPPort(in.u64());
+		entry.adcs[GlobalAnalog_t(fpga, analog)] = adc;
+	}
+
+	for (size_t n = in.u32(); n > 0; --n) {
+		FPGAGlobal const fpga{Enum(in.u64())};
+		FPGAEntry fpga_entry;
+		fpga_entry.ip = in.ip();
+		fpga_entry.highspeed = in.boolean();
+		entry.fpgas[fpga] = fpga_entry;
+	}
+
+	for (size_t n = in.u32(); n > 0; --n) {
+		DNCGlobal const reticle{Enum(in.u64())};
+		ReticleEntry reticle_entry;
+		reticle_entry.to_be_powered = in.boolean();
+		entry.reticles[reticle] = reticle_entry;
+	}
+
+	for (size_t n = in.u32(); n > 0; --n) {
+		AnanasGlobal const ananas{Enum(in.u64())};
+		AnanasEntry ananas_entry;
+		ananas_entry.ip = in.ip();
+		ananas_entry.baseport_data = UDPPort(in.u16());
+		ananas_entry.baseport_reset = UDPPort(in.u16());
+		entry.ananas[ananas] = ananas_entry;
+	}
+
+	for (size_t n = in.u32(); n > 0; --n) {
+		HICANNGlobal const hicann{Enum(in.u64())};
+		HICANNEntry hicann_entry;
+		hicann_entry.version = in.u64();
+		hicann_entry.label = in.string();
+		entry.set_hicann(hicann, hicann_entry);
+	}
+	std::vector<FPGAGlobal> shared_fpgas;
+	for (size_t n = in.u32(); n > 0; --n) {
+		shared_fpgas.push_back(FPGAGlobal(FPGAOnWafer(Enum(in.u64())), wafer));
+	}
+	if (!shared_fpgas.empty()) {
+		HICANNEntry shared;
+		shared.version = in.u64();
+		shared.label = in.string();
+		for (auto const fpga : shared_fpgas) {
+			entry.set_hicanns(fpga, shared);
+		}
+	}
+
+	entry.macu = in.ip();
+	entry.macu_version = in.u64();
+	return entry;
+}
+
+void write_dls(SnapshotWriter& out, DLSSetupEntry const& entry)
+{
+	out.string(entry.fpga_name);
+	out.string(entry.board_name);
+	out.u64(entry.board_version);
+	out.u64(entry.chip_id);
+	out.u64(entry.chip_version);
+	out.string(entry.ntpwr_ip);
+	out.u64(entry.ntpwr_slot);
+}
+
+DLSSetupEntry read_dls(SnapshotReader& in)
+{
+	DLSSetupEntry entry;
+	entry.fpga_name = in.string();
+	entry.board_name = in.string();
+	entry.board_version = in.u64();
+	entry.chip_id = in.u64();
+	entry.chip_version = in.u64();
+	entry.ntpwr_ip = in.string();
+	entry.ntpwr_slot = in.u64();
+	return entry;
+}
+
+void write_hx_fpga(SnapshotWriter& out, HXCubeFPGAEntry const& entry)
+{
+	out.ip(entry.ip);
+	out.boolean(static_cast<bool>(entry.wing));
+	if (entry.wing) {
+		HXCubeWingEntry const& wing = *entry.wing;
+		out.u64(wing.handwritten_chip_serial);
+		out.u64(wing.chip_revision);
+		out.boolean(static_cast<bool>(wing.eeprom_chip_serial));
+		if (wing.eeprom_chip_serial) {
+			out.u32(*wing.eeprom_chip_serial);
+		}
+		write_optional(out, wing.synram_timing_pcconf, &write_timing);
+		write_optional(out, wing.synram_timing_wconf, &write_timing);
+	}
+	out.boolean(static_cast<bool>(entry.fuse_dna));
+	if (entry.fuse_dna) {
+		out.u64(*entry.fuse_dna);
+	}
+	out.boolean(entry.ci_test_node);
+}
+
+HXCubeFPGAEntry read_hx_fpga(SnapshotReader& in)
+{
+	HXCubeFPGAEntry entry;
+	entry.ip = in.ip();
+	if (in.boolean()) {
+		HXCubeWingEntry wing;
+		wing.handwritten_chip_serial = in.u64();
+		wing.chip_revision = in.u64();
+		if (in.boolean()) {
+			wing.eeprom_chip_serial = in.u32();
+		}
+		if (in.boolean()) {
+			wing.synram_timing_pcconf = read_timing(in);
+		}
+		if (in.boolean()) {
+			wing.synram_timing_wconf = read_timing(in);
+		}
+		entry.wing = wing;
+	}
+	if (in.boolean()) {
+		entry.fuse_dna = in.u64();
+	}
+	entry.ci_test_node = in.boolean();
+	return entry;
+}
+
+void write_hx_fpgas(SnapshotWriter& out, std::map<size_t, HXCubeFPGAEntry> const& fpgas)
+{
+	out.u32(static_cast<uint32_t>(fpgas.size()));
+	for (auto const& item : fpgas) {
+		out.u64(item.first);
+		write_hx_fpga(out, item.second);
+	}
+}
+
+std::map<size_t, HXCubeFPGAEntry> read_hx_fpgas(SnapshotReader& in)
+{
+	std::map<size_t, HXCubeFPGAEntry> fpgas;
+	for (size_t n = in.u32(); n > 0; --n) {
+		size_t const fpga = in.u64();
+		fpgas[fpga] = read_hx_fpga(in);
+	}
+	return fpgas;
+}
+
+void write_optional_string(SnapshotWriter& out, std::optional<std::string> const& value)
+{
+	out.boolean(static_cast<bool>(value));
+	if (value) {
+		out.string(*value);
+	}
+}
+
+std::optional<std::string> read_optional_string(SnapshotReader& in)
+{
+	if (in.boolean()) {
+		return in.string();
+	}
+	return std::nullopt;
+}
+
+void write_hxcube(SnapshotWriter& out, HXCubeSetupEntry const& entry)
+{
+	out.u64(entry.hxcube_id);
+	write_hx_fpgas(out, entry.fpgas);
+	out.string(entry.usb_host);
+	out.string(entry.usb_serial);
+	write_optional_string(out, entry.xilinx_hw_server);
+}
+
+HXCubeSetupEntry read_hxcube(SnapshotReader& in)
+{
+	HXCubeSetupEntry entry;
+	entry.hxcube_id = in.u64();
+	entry.fpgas = read_hx_fpgas(in);
+	entry.usb_host = in.string();
+	entry.usb_serial = in.string();
+	entry.xilinx_hw_server = read_optional_string(in);
+	return entry;
+}
+
+void write_jboa(SnapshotWriter& out, JboaSetupEntry const& entry)
+{
+	out.u64(entry.jboa_id);
+	write_hx_fpgas(out, entry.fpgas);
+	out.u32(static_cast<uint32_t>(entry.aggregators.size()));
+	for (auto const& item : entry.aggregators) {
+		out.u64(item.first);
+		out.ip(item.second.ip);
+		out.boolean(item.second.ci_test_node);
+	}
+	write_optional_string(out, entry.xilinx_hw_server);
+}
+
+JboaSetupEntry read_jboa(SnapshotReader& in)
+{
+	JboaSetupEntry entry;
+	entry.jboa_id = in.u64();
+	entry.fpgas = read_hx_fpgas(in);
+	for (size_t n = in.u32(); n > 0; --n) {
+		size_t const aggregator = in.u64();
+		JboaAggregatorEntry aggregator_entry;
+		aggregator_entry.ip = in.ip();
+		aggregator_entry.ci_test_node = in.boolean();
+		entry.aggregators[aggregator] = aggregator_entry;
+	}
+	entry.xilinx_hw_server = read_optional_string(in);
+	return entry;
+}
+
+struct SnapshotHeader
+{
+	uint32_t version;
+	uint64_t source_size;
+	int64_t source_mtime;
+	uint64_t source_hash;
+	uint64_t payload_size;
+	uint64_t payload_hash;
+};
+
+bool read_header(std::string_view const snapshot, SnapshotHeader& header)
+{
+	if (snapshot.size() < snapshot_header_size ||
+	    std::memcmp(snapshot.data(), snapshot_magic, sizeof(snapshot_magic)) != 0) {
+		return false;
+	}
+	SnapshotReader in(snapshot.data() + sizeof(snapshot_magic), snapshot_header_size);
+	header.version = in.u32();
+	in.u32(); // reserved
+	header.source_size = in.u64();
+	header.source_mtime = static_cast<int64_t>(in.u64());
+	header.source_hash = in.u64();
+	header.payload_size = in.u64();
+	header.payload_hash = in.u64();
+	return header.version == snapshot_format_version &&
+	       header.payload_size == snapshot.size() - snapshot_header_size;
+}
+
+/// Check that the snapshot header matches the YAML source at path; the source
+/// is only hashed if size or modification time differ.
+bool matches_source(SnapshotHeader const& header, std::string const& path)
+{
+	SourceInfo info;
+	if (!stat_source(path, info) || info.size != header.source_size) {
+		return false;
+	}
+	if (info.mtime == header.source_mtime) {
+		return true;
+	}
+	try {
+		detail::MappedFile const source(path);
+		return fnv1a(source.data().data(), source.data().size()) == header.source_hash;
+	} catch (std::runtime_error const&) {
+		return false;
+	}
+}
+
+} // anonymous namespace
+
+namespace hwdb4cpp {
+
+std::string database::get_snapshot_path(std::string const& path)
+{
+	return path + ".snapshot";
+}
+
+bool database::has_valid_snapshot(std::string const& path)
+{
+	std::string snapshot;
+	SnapshotHeader header;
+	if (!read_file(get_snapshot_path(path), snapshot) || !read_header(snapshot, header)) {
+		return false;
+	}
+	return matches_source(header, path) &&
+	       fnv1a(snapshot.data() + snapshot_header_size, header.payload_size) ==
+	           header.payload_hash;
+}
+
+void database::dump_snapshot(std::string const& path)
+{
+	// write to a temporary file first, so concurrent readers never see a partial snapshot
+	std::string const snapshot_path = get_snapshot_path(path);
+	std::string const tmp_path = snapshot_path + ".tmp";
+	{
+		std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		try {
+			dump_snapshot(path, out);
+		} catch (...) {
+			std::remove(tmp_path.c_str());
+			throw;
+		}
+		if (!out) {
+			std::remove(tmp_path.c_str());
+			throw std::runtime_error("cannot write hwdb snapshot " + tmp_path);
+		}
+	}
+	if (std::rename(tmp_path.c_str(), snapshot_path.c_str()) != 0) {
+		std::remove(tmp_path.c_str());
+		throw std::runtime_error("cannot write hwdb snapshot " + snapshot_path);
+	}
+}
+
+void database::dump_snapshot(std::string const& path, std::ostream& out)
+{
+	SourceInfo info;
+	if (!stat_source(path, info)) {
+		throw std::runtime_error("cannot read hwdb source file " + path);
+	}
+	// Decode the hashed content itself, a database filtered or modified after loading
+	// would otherwise be stamped as the content of the file.
+	detail::MappedFile const source(path);
+	LoadOptions options;
+	options.use_snapshot = false;
+	database db;
+	db.load_content(source.data(), options);
+
+	SnapshotWriter payload;
+	payload.u32(static_cast<uint32_t>(db.mWaferData.size()));
+	for (auto const& item : db.mWaferData) {
+		payload.u64(item.first.value());
+		write_wafer(payload, item.first, item.second);
+	}
+	payload.u32(static_cast<uint32_t>(db.mDLSData.size()));
+	for (auto const& item : db.mDLSData) {
+		payload.string(item.first);
+		write_dls(payload, item.second);
+	}
+	payload.u32(static_cast<uint32_t>(db.mHXCubeData.size()));
+	for (auto const& item : db.mHXCubeData) {
+		payload.u64(item.first);
+		write_hxcube(payload, item.second);
+	}
+	payload.u32(static_cast<uint32_t>(db.mJboaData.size()));
+	for (auto const& item : db.mJboaData) {
+		payload.u64(item.first);
+		write_jboa(payload, item.second);
+	}
+
+	SnapshotWriter header;
+	header.u32(snapshot_format_version);
+	header.u32(0);
+	header.u64(info.size);
+	header.u64(static_cast<uint64_t>(info.mtime));
+	header.u64(fnv1a(source.data().data(), source.data().size()));
+	header.u64(payload.data().size());
+	header.u64(fnv1a(payload.data().data(), payload.data().size()));
+
+	out.write(snapshot_magic, sizeof(snapshot_magic));
+	out.write(header.data().data(), header.data().size());
+	out.write(payload.data().data(), payload.data().size());
+}
+
+bool database::load_snapshot(std::string const& path)
+{
+	std::string snapshot;
+	if (!read_file(get_snapshot_path(path), snapshot)) {
+		return false;
+	}
+
+	SnapshotHeader header;
+	if (read_header(snapshot, header) && !matches_source(header, path)) {
+		log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+		LOG4CXX_INFO(logger, "Ignoring stale snapshot " << get_snapshot_path(path));
+		return false;
+	}
+	return read_snapshot(snapshot, get_snapshot_path(path));
+}
+
+bool database::read_snapshot(std::string_view const snapshot, std::string const& name)
+{
+	log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("hwdb4cpp");
+	SnapshotHeader header;
+	if (!read_header(snapshot, header)) {
+		LOG4CXX_WARN(logger, "Ignoring incompatible snapshot " << name);
+		return false;
+	}
+
+	char const* const payload = snapshot.data() + snapshot_header_size;
+	if (fnv1a(payload, header.payload_size) != header.payload_hash) {
+		LOG4CXX_WARN(logger, "Ignoring corrupt snapshot " << name);
+		return false;
+	}
+
+	decltype(mWaferData) wafer_data;
+	decltype(mDLSData) dls_data;
+	decltype(mHXCubeData) hxcube_data;
+	decltype(mJboaData) jboa_data;
+	try {
+		SnapshotReader in(payload, header.payload_size);
+		for (size_t n = in.u32(); n > 0; --n) {
+			Wafer const wafer(in.u64());
+			wafer_data[wafer] = read_wafer(in, wafer);
+		}
+		for (size_t n = in.u32(); n > 0; --n) {
+			std::string const dls_setup = in.string();
+			dls_data[dls_setup] = read_dls(in);
+		}
+		for (size_t n = in.u32(); n > 0; --n) {
+			size_t const hxcube_id = in.u64();
+			hxcube_data[hxcube_id] = read_hxcube(in);
+		}
+		for (size_t n = in.u32(); n > 0; --n) {
+			size_t const jboa_id = in.u64();
+			jboa_data[jboa_id] = read_jboa(in);
+		}
+		if (!in.at_end()) {
+			throw std::runtime_error("trailing data in hwdb snapshot");
+		}
+	} catch (std::exception const& err) {
+		LOG4CXX_WARN(logger, "Ignoring malformed snapshot " << name << ": " << err.what());
+		return false;
+	}
+
+	mWaferData.swap(wafer_data);
+	mDLSData.swap(dls_data);
+	mHXCubeData.swap(hxcube_data);
+	mJboaData.swap(jboa_data);
+	LOG4CXX_DEBUG(logger, "Loaded snapshot " << name);
+	return true;
+}
+
+void database::load_embedded_snapshot(std::string_view const snapshot)
+{
+	check_empty();
+	if (!read_snapshot(snapshot, "embedded in hwdb4cpp_embedded")) {
+		throw std::runtime_error("hwdb4cpp_embedded does not match the hwdb4cpp library");
+	}
+	invalidate_indexes();
+}
+
+} // namespace hwdb4cpp
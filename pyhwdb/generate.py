@@ -15,6 +15,25 @@ ns_hwdb4cpp = mb.namespace('hwdb4cpp')
 ns_hwdb4cpp.include()
 namespaces.extend_array_operators(ns_hwdb4cpp)
 
+# python mapping protocol of DenseMap besides at() as __getitem__,
+# iteration yields the keys like for dicts
+dense_map_protocol = [
+    'def("__len__", &%(map)s::size)',
+    'def("__contains__", +[](%(map)s const& self, %(map)s::key_type const& key) {'
+    ' return self.count(key) != 0; })',
+    'def("__setitem__", +[](%(map)s& self, %(map)s::key_type const& key,'
+    ' %(map)s::mapped_type const& value) { self[key] = value; })',
+    'def("__delitem__", +[](%(map)s& self, %(map)s::key_type const& key) {'
+    ' if (!self.erase(key)) { throw std::out_of_range("DenseMap::erase"); } })',
+    'def("__iter__", +[](%(map)s const& self) {'
+    ' return bp::object(self.keys()).attr("__iter__")(); })',
+    'def("values", +[](%(map)s const& self) { bp::list ret;'
+    ' for (auto const& item : self) { ret.append(item.second); } return ret; })',
+    'def("items", +[](%(map)s const& self) { bp::list ret;'
+    ' for (auto const& item : self) { ret.append(bp::make_tuple(item.first, item.second)); }'
+    ' return ret; })',
+]
+
 for c in ns_hwdb4cpp.classes(allow_empty=True):
     c.include()
     if c.name.startswith('database'):
@@ -24,6 +43,19 @@ for c in ns_hwdb4cpp.classes(allow_empty=True):
             f.call_policies = call_policies.return_internal_reference()
         for f in c.mem_funs('get_hxcube_entry', allow_empty=True):
             f.call_policies = call_policies.return_internal_reference()
+    if c.name.startswith('DenseMap'):
+        # iterators are not exposed, see dense_map_protocol
+        c.classes(allow_empty=True).exclude()
+        c.operators(allow_empty=True).exclude()
+        for f in c.mem_funs(allow_empty=True):
+            if f.name == 'at' and not f.has_const:
+                # entries are modified in place like for std::map
+                f.alias = '__getitem__'
+                f.call_policies = call_policies.return_internal_reference()
+            elif f.name not in ['keys', 'size', 'empty', 'count']:
+                f.exclude()
+        for code in dense_map_protocol:
+            c.add_registration_code(code % {'map': c.decl_string})
 
 # expose only public interfaces
 namespaces.exclude_by_access_type(mb, ['variables', 'calldefs', 'classes'], 'private')
@@ -75,5 +75,41 @@ GENPYBIND_MANUAL({
 	apply_pickle<hwdb4cpp::HXCubeFPGAEntry>(parent, "HXCubeFPGAEntry");
 	apply_pickle<hwdb4cpp::HXCubeSetupEntry>(parent, "HXCubeSetupEntry");
 	apply_pickle<hwdb4cpp::JboaSetupEntry>(parent, "JboaSetupEntry");
+
+	auto database = parent.attr("database");
+	auto load_from_bytes = [](hwdb4cpp::database& self, pybind11::bytes const& data,
+	                          hwdb4cpp::LoadOptions const& options) {
+		char* buffer = nullptr;
+		Py_ssize_t size = 0;
+		if (PyBytes_AsStringAndSize(data.ptr(), &buffer, &size) != 0) {
+			throw pybind11::error_already_set();
+		}
+		// data is kept alive by the caller
+		pybind11::gil_scoped_release release;
+		self.load_from_buffer(std::string_view(buffer, static_cast<size_t>(size)), options);
+	};
+	database.attr("load_from_bytes") = pybind11::cpp_function(
+	    load_from_bytes, pybind11::is_method(database), pybind11::name("load_from_bytes"),
+	    pybind11::arg("data"), pybind11::arg("options") = hwdb4cpp::LoadOptions());
+
+	// parsing does not touch Python objects, other threads may run meanwhile
+	auto load = [](hwdb4cpp::database& self, std::string const& path,
+	               hwdb4cpp::LoadOptions const& options) { self.load(path, options); };
+	database.attr("load") = pybind11::cpp_function(
+	    load, pybind11::is_method(database), pybind11::name("load"), pybind11::arg("path"),
+	    pybind11::arg("options") = hwdb4cpp::LoadOptions(),
+	    pybind11::call_guard<pybind11::gil_scoped_release>());
+
+	// awaitable load, runs load in the default executor of the running asyncio loop
+	auto load_async = [](pybind11::object const& self, std::string const& path,
+	                     hwdb4cpp::LoadOptions const& options) {
+		auto const loop = pybind11::module::import("asyncio").attr("get_running_loop")();
+		auto const partial = pybind11::module::import("functools").attr("partial");
+		return loop.attr("run_in_executor")(
+		    pybind11::none(), partial(self.attr("load"), path, options));
+	};
+	database.attr("load_async") = pybind11::cpp_function(
+	    load_async, pybind11::is_method(database), pybind11::name("load_async"),
+	    pybind11::arg("path"), pybind11::arg("options") = hwdb4cpp::LoadOptions());
 })
 #endif
@@ -1,5 +1,6 @@
 #!/usr/bin/env python
 
+import asyncio
 import unittest
 import os
 import pyhwdb
@@ -55,6 +56,93 @@ class Test_Pyhwdb(unittest.TestCase):
             unique_serial_numbers.add(entry.usb_serial)
         self.assertEqual(len(all_ids), len(unique_serial_numbers), "HX cube setups have unique USB serial")
 
+    @unittest.skipUnless((os.path.split(os.getcwd())[-1] == "hwdb") and not IS_PYPLUSPLUS, "assuming test is executed with cwd == hwdb/ as done by waf")
+    def test_load_filtered(self):
+        path = os.path.join(os.getcwd(), "db.yaml")
+        options = pyhwdb.LoadOptions()
+        options.filter.add(pyhwdb.SetupFamily.hxcube, self.HXCUBE_ID)
+        db = pyhwdb.database()
+        db.load(path, options)
+        self.assertEqual(db.get_hxcube_ids(), [self.HXCUBE_ID])
+        self.assertEqual(db.get_jboa_ids(), [])
+        self.assertEqual(db.get_dls_setup_ids(), [])
+
+    @unittest.skipUnless((os.path.split(os.getcwd())[-1] == "hwdb") and not IS_PYPLUSPLUS, "assuming test is executed with cwd == hwdb/ as done by waf")
+    def test_load_from_bytes(self):
+        path = os.path.join(os.getcwd(), "db.yaml")
+        with open(path, "rb") as f:
+            content = f.read()
+        file_db = pyhwdb.database()
+        file_db.load(path)
+        db = pyhwdb.database()
+        db.load_from_bytes(content)
+        self.assertEqual(db.get_hxcube_ids(), file_db.get_hxcube_ids())
+        self.assertEqual(db.get_jboa_ids(), file_db.get_jboa_ids())
+
+        options = pyhwdb.LoadOptions()
+        options.filter.add(pyhwdb.SetupFamily.hxcube, self.HXCUBE_ID)
+        filtered_db = pyhwdb.database()
+        filtered_db.load_from_bytes(content, options)
+        self.assertEqual(filtered_db.get_hxcube_ids(), [self.HXCUBE_ID])
+
+        with open(path, "rb") as f:
+            fd_db = pyhwdb.database()
+            fd_db.load_from_fd(f.fileno())
+        self.assertEqual(fd_db.get_hxcube_ids(), file_db.get_hxcube_ids())
+
+    @unittest.skipUnless((os.path.split(os.getcwd())[-1] == "hwdb") and not IS_PYPLUSPLUS, "assuming test is executed with cwd == hwdb/ as done by waf")
+    def test_load_async(self):
+        path = os.path.join(os.getcwd(), "db.yaml")
+        file_db = pyhwdb.database()
+        file_db.load(path)
+
+        async def load():
+            db = pyhwdb.database()
+            await db.load_async(path)
+            return db
+
+        db = asyncio.run(load())
+        self.assertEqual(db.get_hxcube_ids(), file_db.get_hxcube_ids())
+
+        async def load_twice():
+            await db.load_async(path)
+
+        with self.assertRaises(RuntimeError):
+            asyncio.run(load_twice())
+
+    @unittest.skipIf(IS_PYPLUSPLUS, "HX cube setups are not available")
+    def test_fpga_dna(self):
+        fuse_dna = 0x3A0E92C402882A33
+        self.assertEqual(pyhwdb.HXCubeFPGAEntry.dna_port_from_fuse_dna(fuse_dna),
+                         0x5411402349705C)
+        self.assertEqual(pyhwdb.HXCubeFPGAEntry.dna_ports_from_fuse_dnas([fuse_dna, 0]),
+                         [0x5411402349705C, 0])
+
+        mydb = pyhwdb.database()
+        hxcube_entry = pyhwdb.HXCubeSetupEntry()
+        hxcube_entry.hxcube_id = self.HXCUBE_ID
+        fpga_entry = pyhwdb.HXCubeFPGAEntry()
+        fpga_entry.ip = self.FPGA_IP
+        fpga_entry.fuse_dna = fuse_dna
+        hxcube_entry.fpgas = {3: fpga_entry}
+        mydb.add_hxcube_setup_entry(self.HXCUBE_ID, hxcube_entry)
+        fpga = mydb.find_fpga_by_dna_port(fpga_entry.get_dna_port())
+        self.assertEqual(fpga.family, pyhwdb.SetupFamily.hxcube)
+        self.assertEqual((fpga.setup_id, fpga.fpga_id), (self.HXCUBE_ID, 3))
+        self.assertEqual(mydb.find_fpga_by_fuse_dna(fuse_dna), fpga)
+        self.assertEqual(mydb.find_fpgas_by_dna_port([0x5411402349705C, 0]), [fpga, None])
+
+    @unittest.skipUnless((os.path.split(os.getcwd())[-1] == "hwdb") and not IS_PYPLUSPLUS, "assuming test is executed with cwd == hwdb/ as done by waf")
+    def test_freeze(self):
+        db = pyhwdb.database()
+        db.load(os.path.join(os.getcwd(), "db.yaml"))
+        frozen = db.freeze()
+        self.assertEqual(frozen.get_hxcube_ids(), db.get_hxcube_ids())
+        self.assertEqual(frozen.get_dls_setup_ids(), db.get_dls_setup_ids())
+        self.assertEqual(frozen.get_hxcube_setup_entry(self.HXCUBE_ID).usb_host,
+                         db.get_hxcube_setup_entry(self.HXCUBE_ID).usb_host)
+        self.assertFalse(hasattr(frozen, "add_hxcube_setup_entry"))
+
     @unittest.skipUnless("GERRIT_EVENT_TYPE" in os.environ and os.environ["GERRIT_EVENT_TYPE"]=="change-merged", "for deployment tests only")
     def test_default_path_valid(self):
         db = pyhwdb.database()
@@ -123,8 +211,28 @@ class Test_Pyhwdb(unittest.TestCase):
             self.assertFalse(mydb.has_hxcube_setup_entry(hxcube_id))
             mydb.add_hxcube_setup_entry(hxcube_id, hxcube_entry)
             self.assertTrue(mydb.has_hxcube_setup_entry(hxcube_id))
+            endpoints = mydb.find_endpoints(self.FPGA_IP)
+            self.assertEqual(len(endpoints), 1)
+            self.assertEqual(endpoints[0].owner, pyhwdb.EndpointOwner.hxcube_fpga)
+            self.assertEqual((endpoints[0].setup, endpoints[0].index), (hxcube_id, 0))
+            self.assertEqual(len(mydb.find_endpoints_in_subnet(self.FPGA_IP, 24)), 1)
             mydb.remove_hxcube_setup_entry(hxcube_id)
             self.assertFalse(mydb.has_hxcube_setup_entry(hxcube_id))
+            self.assertEqual(mydb.find_endpoints(self.FPGA_IP), [])
+            mydb.add_hxcube_setup_entry(hxcube_id, hxcube_entry)
+            self.assertEqual(mydb.get_unique_branch_identifier(0x987DE),
+                             "hxcube9fpga0chip12_1")
+            self.assertEqual(mydb.find_chip(12).fpga_id, 0)
+            self.assertIsNone(mydb.find_chip(13))
+            self.assertIsNone(mydb.find_fpga_by_fuse_dna(0x3A0E92C402882A33))
+            mydb.remove_hxcube_setup_entry(hxcube_id)
+            branch = pyhwdb.UniqueBranchIdentifier.from_string("hxcube9fpga0chip12_1")
+            self.assertEqual(branch.family, pyhwdb.SetupFamily.hxcube)
+            self.assertEqual(branch.to_string(), "hxcube9fpga0chip12_1")
+            self.assertEqual(
+                pyhwdb.UniqueBranchIdentifier.to_strings(
+                    pyhwdb.UniqueBranchIdentifier.from_strings(["jboa7fpga12chip13_1"])),
+                ["jboa7fpga12chip13_1"])
             self.assertEqual(hxcube_entry.get_unique_branch_identifier(12),
                             "hxcube9fpga0chip12_1")
             self.assertEqual(
@@ -175,6 +283,21 @@ class Test_Pyhwdb(unittest.TestCase):
             mydb.add_fpga_entry(fpga_coord, fpga)
             self.assertTrue(mydb.has_fpga_entry(fpga_coord))
             self.assertEqual(mydb.get_fpga_entry(fpga_coord).ip, fpga.ip)
+
+            # per-wafer tables behave like dicts keyed by coordinate
+            fpgas = mydb.get_wafer_entry(wafer_coord).fpgas
+            self.assertIn(fpga_coord, fpgas)
+            self.assertEqual(len(fpgas), 1)
+            self.assertEqual(list(fpgas), [fpga_coord])
+            self.assertEqual([key for key, _ in fpgas.items()], [fpga_coord])
+            self.assertEqual(fpgas[fpga_coord].ip, fpga.ip)
+            fpgas[fpga_coord].highspeed = not self.FPGA_HIGHSPEED
+            self.assertEqual(mydb.get_fpga_entry(fpga_coord).highspeed, not self.FPGA_HIGHSPEED)
+            del fpgas[fpga_coord]
+            self.assertNotIn(fpga_coord, fpgas)
+            fpgas[fpga_coord] = fpga
+            self.assertTrue(mydb.has_fpga_entry(fpga_coord))
+
             mydb.remove_fpga_entry(fpga_coord)
             self.assertFalse(mydb.has_fpga_entry(fpga_coord))
 
@@ -202,12 +325,21 @@ class Test_Pyhwdb(unittest.TestCase):
             mydb.remove_hicann_entry(hicann_coord)
             self.assertFalse(mydb.has_hicann_entry(hicann_coord))
 
+            # sub-queries per FPGA and per reticle
+            mydb.add_hicann_entry(hicann_coord, hicann)
+            self.assertEqual(list(mydb.get_hicann_entries(fpga_coord).keys()), [hicann_coord])
+            self.assertEqual(list(mydb.get_hicann_entries(hicann_coord.toDNCGlobal()).keys()),
+                             [hicann_coord])
+            self.assertEqual(len(mydb.get_adc_entries(fpga_coord)), 0)
+            mydb.remove_hicann_entry(hicann_coord)
+
             # test clear()
             mydb.add_hicann_entry(hicann_coord, hicann)
             mydb.clear()
             self.assertFalse(mydb.has_hicann_entry(hicann_coord))
             self.assertFalse(mydb.has_fpga_entry(fpga_coord))
             self.assertFalse(mydb.has_wafer_entry(wafer_coord))
+            self.assertEqual(len(mydb.get_adc_serials()), 0)
 
             # FIXME: get usable ADC coord, i.e. proper wrapping
             #adc = pyhwdb.ADCEntry()
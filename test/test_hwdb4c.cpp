@@ -11,6 +11,7 @@
 
 extern "C" {
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <string.h>
 #include "hwdb4cpp/hwdb4c.h"
 }
@@ -426,6 +427,30 @@ void get_entry_test_impl(hwdb4c_database_t* hwdb)
 	EXPECT_EQ(num_hicanns, 1);
 	hwdb4c_free_hicann_entries(hicanns, num_hicanns);
 	hicanns = NULL;
+	num_hicanns = 0;
+	size_t reticle_id = 0;
+	ASSERT_EQ(hwdb4c_FPGAOnWafer_toReticleOnWafer(3, &reticle_id), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_get_hicann_entries_of_DNCGlobal(hwdb, reticles_per_wafer * testwafer_id + reticle_id, &hicanns, &num_hicanns), HWDB4C_SUCCESS);
+	ASSERT_TRUE(hicanns != NULL);
+	EXPECT_EQ(num_hicanns, 2);
+	hwdb4c_free_hicann_entries(hicanns, num_hicanns);
+	hicanns = NULL;
+	// reticles without HICANNs yield an empty list
+	ASSERT_EQ(hwdb4c_FPGAOnWafer_toReticleOnWafer(5, &reticle_id), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_get_hicann_entries_of_DNCGlobal(hwdb, reticles_per_wafer * testwafer_id + reticle_id, &hicanns, &num_hicanns), HWDB4C_SUCCESS);
+	EXPECT_EQ(num_hicanns, 0);
+	hwdb4c_free_hicann_entries(hicanns, num_hicanns);
+	hicanns = NULL;
+
+	hwdb4c_fpga_entry** fpgas = NULL;
+	size_t num_fpgas = 0;
+	ASSERT_EQ(hwdb4c_get_fpga_entries_of_Wafer(hwdb, testwafer_id, &fpgas, &num_fpgas), HWDB4C_SUCCESS);
+	ASSERT_TRUE(fpgas != NULL);
+	EXPECT_EQ(num_fpgas, 2);
+	EXPECT_EQ(fpgas[1]->fpgaglobal_id, fpgas_per_wafer * testwafer_id + 3);
+	hwdb4c_free_fpga_entries(fpgas, num_fpgas);
+	fpgas = NULL;
+	EXPECT_EQ(hwdb4c_get_fpga_entries_of_Wafer(hwdb, testwafer_id + 1, &fpgas, &num_fpgas), HWDB4C_FAILURE);
 
 	hwdb4c_adc_entry** adcs = NULL;
 	size_t num_adcs = 0;
@@ -473,6 +498,107 @@ TEST_F(HWDB4C_Test, get_entry)
 	hwdb4c_free_hwdb(hwdb);
 }
 
+TEST_F(HWDB4C_Test, get_missing_entry)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_hwdb(hwdb, test_path.c_str()), HWDB4C_SUCCESS);
+
+	// absent entries, also on absent wafers, are reported as failure
+	size_t const other_wafer_id = testwafer_id + 1;
+	hwdb4c_fpga_entry* fpga = NULL;
+	EXPECT_EQ(hwdb4c_get_fpga_entry(hwdb, fpgas_per_wafer * testwafer_id + 1, &fpga), HWDB4C_FAILURE);
+	EXPECT_EQ(hwdb4c_get_fpga_entry(hwdb, fpgas_per_wafer * other_wafer_id, &fpga), HWDB4C_FAILURE);
+	EXPECT_TRUE(fpga == NULL);
+	hwdb4c_hicann_entry* hicann = NULL;
+	EXPECT_EQ(hwdb4c_get_hicann_entry(hwdb, hicanns_per_wafer * testwafer_id + 20, &hicann), HWDB4C_FAILURE);
+	EXPECT_EQ(hwdb4c_get_hicann_entry(hwdb, hicanns_per_wafer * other_wafer_id, &hicann), HWDB4C_FAILURE);
+	EXPECT_TRUE(hicann == NULL);
+	hwdb4c_adc_entry* adc = NULL;
+	EXPECT_EQ(hwdb4c_get_adc_entry(hwdb, fpgas_per_wafer * other_wafer_id, 0, &adc), HWDB4C_FAILURE);
+	bool ret = true;
+	EXPECT_EQ(hwdb4c_has_adc_entry(hwdb, fpgas_per_wafer * other_wafer_id, 0, &ret), HWDB4C_SUCCESS);
+	EXPECT_FALSE(ret);
+	hwdb4c_wafer_entry* wafer = NULL;
+	EXPECT_EQ(hwdb4c_get_wafer_entry(hwdb, other_wafer_id, &wafer), HWDB4C_FAILURE);
+	hwdb4c_hxcube_setup_entry* hxcube = NULL;
+	EXPECT_EQ(hwdb4c_get_hxcube_setup_entry(hwdb, testhxcube_id + 1, &hxcube), HWDB4C_FAILURE);
+	EXPECT_TRUE(hxcube == NULL);
+	hwdb4c_free_hwdb(hwdb);
+}
+
+TEST_F(HWDB4C_Test, find_endpoints)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_hwdb(hwdb, test_path.c_str()), HWDB4C_SUCCESS);
+
+	struct in_addr ip;
+	hwdb4c_network_endpoint* endpoints = NULL;
+	size_t num_endpoints = 0;
+	inet_aton("192.168.5.4", &ip);
+	ASSERT_EQ(hwdb4c_find_endpoints(hwdb, ip, &endpoints, &num_endpoints), HWDB4C_SUCCESS);
+	ASSERT_EQ(num_endpoints, 1);
+	EXPECT_EQ(endpoints[0].ip.s_addr, ip.s_addr);
+	EXPECT_EQ(endpoints[0].owner, HWDB4C_ENDPOINT_FPGA);
+	EXPECT_EQ(endpoints[0].setup_id, testwafer_id);
+	EXPECT_EQ(endpoints[0].index, 3);
+	free(endpoints);
+
+	inet_aton("192.168.5.190", &ip);
+	ASSERT_EQ(
+	    hwdb4c_find_endpoints_with_port(hwdb, ip, 0x2572, &endpoints, &num_endpoints),
+	    HWDB4C_SUCCESS);
+	ASSERT_EQ(num_endpoints, 1);
+	EXPECT_EQ(endpoints[0].owner, HWDB4C_ENDPOINT_ANANAS_RESET);
+	EXPECT_EQ(endpoints[0].port, 0x2572);
+	EXPECT_EQ(endpoints[0].sub_index, 2);
+	free(endpoints);
+
+	inet_aton("192.168.87.0", &ip);
+	ASSERT_EQ(
+	    hwdb4c_find_endpoints_in_subnet(hwdb, ip, 24, &endpoints, &num_endpoints),
+	    HWDB4C_SUCCESS);
+	ASSERT_EQ(num_endpoints, 4);
+	EXPECT_EQ(endpoints[0].owner, HWDB4C_ENDPOINT_JBOA_AGGREGATOR);
+	EXPECT_EQ(endpoints[0].setup_id, testjboa_id);
+	free(endpoints);
+
+	inet_aton("10.0.0.1", &ip);
+	ASSERT_EQ(hwdb4c_find_endpoints(hwdb, ip, &endpoints, &num_endpoints), HWDB4C_SUCCESS);
+	EXPECT_EQ(num_endpoints, 0);
+	free(endpoints);
+	EXPECT_EQ(
+	    hwdb4c_find_endpoints_in_subnet(hwdb, ip, 33, &endpoints, &num_endpoints),
+	    HWDB4C_FAILURE);
+	hwdb4c_free_hwdb(hwdb);
+}
+
+TEST_F(HWDB4C_Test, find_fpga_by_dna)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_hwdb(hwdb, test_path.c_str()), HWDB4C_SUCCESS);
+
+	hwdb4c_fpga_location fpga;
+	ASSERT_EQ(hwdb4c_find_fpga_by_fuse_dna(hwdb, 0x123456789, &fpga), HWDB4C_SUCCESS);
+	EXPECT_EQ(fpga.family, HWDB4C_JBOA_SETUP);
+	EXPECT_EQ(fpga.setup_id, testjboa_id);
+	EXPECT_EQ(fpga.fpga_id, 13);
+	ASSERT_EQ(hwdb4c_find_fpga_by_dna_port(hwdb, 0x5411402349705C, &fpga), HWDB4C_SUCCESS);
+	EXPECT_EQ(fpga.family, HWDB4C_HXCUBE_SETUP);
+	EXPECT_EQ(fpga.setup_id, testhxcube_id);
+	EXPECT_EQ(fpga.fpga_id, 0);
+	EXPECT_EQ(hwdb4c_find_fpga_by_fuse_dna(hwdb, 0x5411402349705C, &fpga), HWDB4C_FAILURE);
+
+	uint64_t const fuse_dnas[] = {0x3A0E92C402882A33, 0};
+	uint64_t dna_ports[2];
+	hwdb4c_dna_ports_from_fuse_dnas(fuse_dnas, dna_ports, 2);
+	EXPECT_EQ(dna_ports[0], 0x5411402349705C);
+	EXPECT_EQ(dna_ports[1], 0);
+	hwdb4c_free_hwdb(hwdb);
+}
+
 TEST_F(HWDB4C_Test, get_entry_after_store_and_load)
 {
 	hwdb4c_database_t* hwdb = NULL;
@@ -624,3 +750,112 @@ TEST_F(HWDB4C_Test, coord)
 	EXPECT_EQ(std::string(ret_string), "W0T5");
 	free(ret_string);
 }
+
+TEST_F(HWDB4C_Test, load_filtered)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	hwdb4c_load_filter_t* filter = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_alloc_load_filter(&filter), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_filter_add_id(filter, HWDB4C_WAFER, testwafer_id), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_filter_add_dls_setup(filter, testdls_id1), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_filter_add_family(filter, HWDB4C_JBOA_SETUP), HWDB4C_SUCCESS);
+	EXPECT_EQ(hwdb4c_load_filter_add_id(filter, HWDB4C_DLS_SETUP, 3), HWDB4C_FAILURE);
+	ASSERT_EQ(hwdb4c_load_hwdb_filtered(hwdb, test_path.c_str(), filter), HWDB4C_SUCCESS);
+	hwdb4c_free_load_filter(filter);
+
+	bool ret = false;
+	ASSERT_EQ(hwdb4c_has_wafer_entry(hwdb, testwafer_id, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+	ASSERT_EQ(hwdb4c_has_dls_entry(hwdb, testdls_id0, &ret), HWDB4C_SUCCESS);
+	EXPECT_FALSE(ret);
+	ASSERT_EQ(hwdb4c_has_dls_entry(hwdb, testdls_id1, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+	ASSERT_EQ(hwdb4c_has_hxcube_setup_entry(hwdb, testhxcube_id, &ret), HWDB4C_SUCCESS);
+	EXPECT_FALSE(ret);
+	ASSERT_EQ(hwdb4c_has_jboa_setup_entry(hwdb, testjboa_id, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+	hwdb4c_free_hwdb(hwdb);
+}
+
+TEST_F(HWDB4C_Test, load_from_buffer_and_fd)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	ASSERT_EQ(
+	    hwdb4c_load_hwdb_from_buffer(hwdb, test_db_string.data(), test_db_string.size()),
+	    HWDB4C_SUCCESS);
+	bool ret = false;
+	ASSERT_EQ(hwdb4c_has_jboa_setup_entry(hwdb, testjboa_id, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+
+	// database has to be empty
+	EXPECT_EQ(
+	    hwdb4c_load_hwdb_from_buffer(hwdb, test_db_string.data(), test_db_string.size()),
+	    HWDB4C_FAILURE);
+	hwdb4c_clear_hwdb(hwdb);
+
+	int pipe_fds[2];
+	ASSERT_EQ(pipe(pipe_fds), 0);
+	ASSERT_EQ(
+	    write(pipe_fds[1], test_db_string.data(), test_db_string.size()),
+	    static_cast<ssize_t>(test_db_string.size()));
+	ASSERT_EQ(close(pipe_fds[1]), 0);
+	ASSERT_EQ(hwdb4c_load_hwdb_from_fd(hwdb, pipe_fds[0]), HWDB4C_SUCCESS);
+	close(pipe_fds[0]);
+	ASSERT_EQ(hwdb4c_has_wafer_entry(hwdb, testwafer_id, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+
+	hwdb4c_clear_hwdb(hwdb);
+	int const fd = open(test_path.c_str(), O_RDONLY);
+	ASSERT_GE(fd, 0);
+	ASSERT_EQ(hwdb4c_load_hwdb_from_fd(hwdb, fd), HWDB4C_SUCCESS);
+	close(fd);
+	ASSERT_EQ(hwdb4c_has_dls_entry(hwdb, testdls_id1, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+	hwdb4c_free_hwdb(hwdb);
+}
+
+#ifdef HWDB4CPP_EMBEDDED
+TEST_F(HWDB4C_Test, load_embedded)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	ASSERT_EQ(hwdb4c_load_embedded(hwdb), HWDB4C_SUCCESS);
+	// database has to be empty
+	EXPECT_EQ(hwdb4c_load_embedded(hwdb), HWDB4C_FAILURE);
+	hwdb4c_clear_hwdb(hwdb);
+	EXPECT_EQ(hwdb4c_load_embedded(hwdb), HWDB4C_SUCCESS);
+	hwdb4c_free_hwdb(hwdb);
+}
+#endif
+
+TEST_F(HWDB4C_Test, load_async)
+{
+	hwdb4c_database_t* hwdb = NULL;
+	ASSERT_EQ(hwdb4c_alloc_hwdb(&hwdb), HWDB4C_SUCCESS);
+	bool done = false;
+	ASSERT_EQ(hwdb4c_load_hwdb_poll(hwdb, &done), HWDB4C_SUCCESS);
+	EXPECT_TRUE(done);
+
+	ASSERT_EQ(hwdb4c_load_hwdb_async(hwdb, test_path.c_str()), HWDB4C_SUCCESS);
+	// only one load at a time
+	EXPECT_EQ(hwdb4c_load_hwdb_async(hwdb, test_path.c_str()), HWDB4C_FAILURE);
+	while (hwdb4c_load_hwdb_poll(hwdb, &done) == HWDB4C_SUCCESS && !done) {
+	}
+	EXPECT_TRUE(done);
+	ASSERT_EQ(hwdb4c_load_hwdb_wait(hwdb), HWDB4C_SUCCESS);
+	bool ret = false;
+	ASSERT_EQ(hwdb4c_has_hxcube_setup_entry(hwdb, testhxcube_id, &ret), HWDB4C_SUCCESS);
+	EXPECT_TRUE(ret);
+
+	// errors are reported by wait, database has to be empty
+	ASSERT_EQ(hwdb4c_load_hwdb_async(hwdb, test_path.c_str()), HWDB4C_SUCCESS);
+	EXPECT_EQ(hwdb4c_load_hwdb_wait(hwdb), HWDB4C_FAILURE);
+	EXPECT_EQ(hwdb4c_load_hwdb_wait(hwdb), HWDB4C_SUCCESS);
+
+	// free waits for a pending load
+	hwdb4c_clear_hwdb(hwdb);
+	ASSERT_EQ(hwdb4c_load_hwdb_async(hwdb, test_path.c_str()), HWDB4C_SUCCESS);
+	hwdb4c_free_hwdb(hwdb);
+}
@@ -0,0 +1,1454 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+#include "hwdb4cpp/hwdb4cpp.h"
+
+using namespace halco::hicann::v2;
+
+class HWDB4CPP_Test : public ::testing::Test
+{
+public:
+	HWDB4CPP_Test()
+	{
+		char tmp_path[] = {"/tmp/hwdbXXXXXX"};
+		int fd = mkstemp(tmp_path);
+		if (fd < 0)
+			std::cout << "ERROR open" << std::endl;
+		test_path = std::string(tmp_path);
+		write(fd, test_db_string.c_str(), test_db_string.size());
+		if (close(fd) != 0)
+			std::cout << "ERROR close" << std::endl;
+	}
+
+	~HWDB4CPP_Test()
+	{
+		remove(test_path.c_str());
+		remove(hwdb4cpp::database::get_snapshot_path(test_path).c_str());
+	}
+
+protected:
+	static std::string dump(hwdb4cpp::database const& db)
+	{
+		std::stringstream ss;
+		db.dump(ss);
+		return ss.str();
+	}
+
+	void write_file(std::string const& path, std::string const& content)
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		out << content;
+	}
+
+	std::string test_path;
+
+	std::string const test_db_string = "---\n\
+wafer: 5\n\
+setuptype: bsswafer\n\
+macu: 192.168.200.165\n\
+macuversion: 1\n\
+fpgas:\n\
+  - fpga: 0\n\
+    ip: 192.168.5.1\n\
+  - fpga: 3\n\
+    ip: 192.168.5.4\n\
+    highspeed: false\n\
+reticles:\n\
+  - reticle: 0\n\
+    to_be_powered: true\n\
+ananas:\n\
+  - ananas: 0\n\
+    ip: 192.168.5.190\n\
+    baseport_data: 0xafe0\n\
+    baseport_reset: 0x2570\n\
+adcs:\n\
+  - fpga: 3\n\
+    analog: 0\n\
+    adc: B201259\n\
+    channel: 0\n\
+    trigger: 1\n\
+    remote_ip: 192.168.200.44\n\
+    remote_port: 44489\n\
+hicanns:\n\
+  - hicann: 88\n\
+    version: 4\n\
+    label: v4-26\n\
+  - hicann: 144\n\
+    version: 4\n\
+---\n\
+dls_setup: '07_20'\n\
+fpga_name: '07'\n\
+board_name: 'Gaston'\n\
+board_version: 2\n\
+chip_id: '20'\n\
+chip_version: 2\n\
+ntpwr_ip: '192.168.200.54'\n\
+ntpwr_slot: 1\n\
+---\n\
+hxcube_id: 6\n\
+fpgas:\n\
+  - fpga: 0\n\
+    ip: 192.168.66.1\n\
+    ci_test_node: true\n\
+    handwritten_chip_serial: 12\n\
+    chip_revision: 42\n\
+    eeprom_chip_serial: 0x1234ABCD\n\
+    synram_timing_pcconf:\n\
+      - [1, 2]\n\
+      - [1, 2]\n\
+    fuse_dna: 0x3A0E92C402882A33\n\
+  - fpga: 7\n\
+    ip: 192.168.66.8\n\
+usb_host: 'AMTHost11'\n\
+usb_serial: 'AFEABC1230456789'\n\
+xilinx_hw_server: 'abc.de:1234'\n\
+---\n\
+jboa_id: 7\n\
+fpgas:\n\
+  - fpga: 12\n\
+    ip: 192.168.87.33\n\
+    handwritten_chip_serial: 13\n\
+    chip_revision: 43\n\
+aggregators:\n\
+  - aggregator: 0\n\
+    ip: 192.168.87.13\n\
+    ci_test_node: true\n\
+";
+};
+
+TEST_F(HWDB4CPP_Test, snapshot_roundtrip)
+{
+	hwdb4cpp::database yaml_db;
+	yaml_db.load(test_path);
+	EXPECT_FALSE(hwdb4cpp::database::has_valid_snapshot(test_path));
+
+	yaml_db.dump_snapshot(test_path);
+	EXPECT_TRUE(hwdb4cpp::database::has_valid_snapshot(test_path));
+
+	// snapshot is picked up instead of the yaml file and yields identical content
+	hwdb4cpp::database snapshot_db;
+	snapshot_db.load(test_path);
+	EXPECT_EQ(dump(yaml_db), dump(snapshot_db));
+
+	auto const& fpga = snapshot_db.get_hxcube_setup_entry(6).fpgas.at(0);
+	ASSERT_TRUE(fpga.wing);
+	EXPECT_EQ(fpga.wing->eeprom_chip_serial, 0x1234ABCDu);
+	EXPECT_TRUE(fpga.wing->synram_timing_pcconf);
+	EXPECT_FALSE(fpga.wing->synram_timing_wconf);
+	EXPECT_EQ(fpga.fuse_dna, 0x3A0E92C402882A33ull);
+	EXPECT_FALSE(snapshot_db.get_hxcube_setup_entry(6).fpgas.at(7).wing);
+	EXPECT_FALSE(snapshot_db.get_fpga_entry(FPGAGlobal(FPGAOnWafer(3), Wafer(5))).highspeed);
+}
+
+TEST_F(HWDB4CPP_Test, snapshot_stale)
+{
+	{
+		hwdb4cpp::database db;
+		db.load(test_path);
+		db.dump_snapshot(test_path);
+	}
+
+	// changed yaml file invalidates snapshot
+	write_file(test_path, test_db_string + "---\njboa_id: 8\n");
+	EXPECT_FALSE(hwdb4cpp::database::has_valid_snapshot(test_path));
+
+	hwdb4cpp::database db;
+	db.load(test_path);
+	EXPECT_TRUE(db.has_jboa_setup_entry(8));
+}
+
+TEST_F(HWDB4CPP_Test, snapshot_of_partial_database)
+{
+	// snapshots hold the file content, not the entries of a filtered or modified database
+	hwdb4cpp::LoadOptions options;
+	options.filter.add(hwdb4cpp::SetupFamily::hxcube, 6);
+	hwdb4cpp::database filtered_db;
+	filtered_db.load(test_path, options);
+	filtered_db.remove_hxcube_setup_entry(6);
+	filtered_db.dump_snapshot(test_path);
+	ASSERT_TRUE(hwdb4cpp::database::has_valid_snapshot(test_path));
+
+	hwdb4cpp::database db;
+	db.load(test_path);
+	EXPECT_TRUE(db.has_hxcube_setup_entry(6));
+	EXPECT_TRUE(db.has_jboa_setup_entry(7));
+}
+
+TEST_F(HWDB4CPP_Test, snapshot_corrupt)
+{
+	hwdb4cpp::database yaml_db;
+	yaml_db.load(test_path);
+	yaml_db.dump_snapshot(test_path);
+
+	std::string const snapshot_path = hwdb4cpp::database::get_snapshot_path(test_path);
+	std::string snapshot;
+	{
+		std::ifstream in(snapshot_path, std::ios::in | std::ios::binary);
+		std::stringstream ss;
+		ss << in.rdbuf();
+		snapshot = ss.str();
+	}
+	snapshot[snapshot.size() / 2] ^= 0xff;
+	write_file(snapshot_path, snapshot);
+	EXPECT_FALSE(hwdb4cpp::database::has_valid_snapshot(test_path));
+
+	// falls back to yaml file
+	hwdb4cpp::database db;
+	db.load(test_path);
+	EXPECT_EQ(dump(yaml_db), dump(db));
+
+	// truncated snapshot is ignored as well
+	write_file(snapshot_path, snapshot.substr(0, 20));
+	hwdb4cpp::database db_truncated;
+	db_truncated.load(test_path);
+	EXPECT_EQ(dump(yaml_db), dump(db_truncated));
+}
+
+TEST_F(HWDB4CPP_Test, load_documents_in_order)
+{
+	// later documents replace earlier ones with the same id
+	write_file(test_path, test_db_string + "---\ndls_setup: '07_20'\nboard_name: 'Other'\n");
+	hwdb4cpp::database db;
+	db.load(test_path);
+	EXPECT_EQ(db.get_dls_entry("07_20").board_name, "Other");
+	EXPECT_EQ(db.get_dls_entry("07_20").fpga_name, "");
+	EXPECT_TRUE(db.has_wafer_entry(Wafer(5)));
+	EXPECT_TRUE(db.has_jboa_setup_entry(7));
+
+	// failing document aborts loading
+	write_file(test_path, test_db_string + "---\nwafer: 6\nsetuptype: nosetup\n");
+	hwdb4cpp::database db_invalid;
+	EXPECT_ANY_THROW(db_invalid.load(test_path));
+	EXPECT_TRUE(db_invalid.get_dls_setup_ids().empty());
+}
+
+TEST_F(HWDB4CPP_Test, event_parser)
+{
+	// shorthand notations, anchors and alternative scalar spellings
+	write_file(test_path, test_db_string + "---\n\
+wafer: 8\n\
+setuptype: CubeSetup\n\
+fpgas:\n\
+  - {fpga: 0, ip: 192.168.8.1, highspeed: No}\n\
+  - fpga: 0x3\n\
+    ip: 192.168.8.4\n\
+hicanns: {version: 2}\n\
+adcs:\n\
+  - fpga: 3\n\
+    analog: 1\n\
+    adc: B201331\n\
+    channel: 2\n\
+    trigger: 0\n\
+    dnc_on_fpga: 0\n\
+---\n\
+jboa_id: 010\n\
+fpgas:\n\
+  - fpga: 1\n\
+    ip: &ip 192.168.8.4\n\
+aggregators:\n\
+  - aggregator: 1\n\
+    ip: *ip\n\
+    ci_test_node: on\n\
+---\n\
+dls_setup: unknown\n\
+board_name: ~\n\
+board_version: 1\n\
+chip_id: 0\n\
+chip_version: 1\n");
+
+	hwdb4cpp::LoadOptions options;
+	options.use_snapshot = false;
+	options.parser = hwdb4cpp::LoadOptions::Parser::node;
+	hwdb4cpp::database node_db;
+	node_db.load(test_path, options);
+
+	options.parser = hwdb4cpp::LoadOptions::Parser::event;
+	hwdb4cpp::database event_db;
+	event_db.load(test_path, options);
+
+	EXPECT_EQ(dump(node_db), dump(event_db));
+	EXPECT_FALSE(event_db.get_fpga_entry(FPGAGlobal(FPGAOnWafer(0), Wafer(8))).highspeed);
+	EXPECT_FALSE(event_db.get_hicann_entries(Wafer(8)).empty());
+	// dnc_on_fpga of old facets systems is accepted and ignored
+	hwdb4cpp::GlobalAnalog_t const analog(FPGAGlobal(FPGAOnWafer(3), Wafer(8)), AnalogOnHICANN(1));
+	EXPECT_EQ(node_db.get_adc_entry(analog).coord, "B201331");
+	EXPECT_EQ(event_db.get_adc_entry(analog).channel, ChannelOnADC(2));
+	EXPECT_TRUE(event_db.get_jboa_setup_entry(8).aggregators.at(1).ci_test_node);
+	EXPECT_EQ(event_db.get_jboa_setup_entry(8).aggregators.at(1).ip.to_string(), "192.168.8.4");
+	EXPECT_EQ(event_db.get_dls_entry("unknown").board_name, "null");
+
+	// invalid entries are rejected by both parsers
+	write_file(test_path, test_db_string + "---\nhxcube_id: 9\nfpgas:\n  - fpga: 08\n    ip: 192.168.66.1\n");
+	hwdb4cpp::database invalid_db;
+	EXPECT_ANY_THROW(invalid_db.load(test_path, options));
+	options.parser = hwdb4cpp::LoadOptions::Parser::node;
+	EXPECT_ANY_THROW(invalid_db.load(test_path, options));
+}
+
+TEST_F(HWDB4CPP_Test, unknown_keys)
+{
+	std::string const valid = "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0\n    ip: 192.168.66.1\n";
+	std::vector<std::string> const invalid = {
+	    // misspelled key
+	    "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0\n    ip: 192.168.66.1\n    ci_testnode: true\n",
+	    // repeated key
+	    "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0\n    ip: 192.168.66.1\n    fpga: 1\n",
+	    // missing required key
+	    "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0\n",
+	    // optional wing entry without hand serial and chip revision
+	    "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0\n    ip: 192.168.66.1\n    eeprom_chip_serial: 1\n"};
+
+	for (auto const parser :
+	     {hwdb4cpp::LoadOptions::Parser::node, hwdb4cpp::LoadOptions::Parser::event}) {
+		hwdb4cpp::LoadOptions options;
+		options.parser = parser;
+
+		hwdb4cpp::database valid_db;
+		valid_db.load_from_buffer(valid, options);
+		EXPECT_FALSE(valid_db.get_hxcube_setup_entry(9).fpgas.at(0).ci_test_node);
+
+		for (auto const& document : invalid) {
+			hwdb4cpp::database invalid_db;
+			EXPECT_ANY_THROW(invalid_db.load_from_buffer(document, options)) << document;
+		}
+	}
+}
+
+TEST_F(HWDB4CPP_Test, hicann_shorthand)
+{
+	std::string const shorthand = "---\n\
+wafer: 8\n\
+setuptype: bsswafer\n\
+macu: 192.168.200.165\n\
+macuversion: 1\n\
+fpgas:\n\
+  - fpga: 0\n\
+    ip: 192.168.8.1\n\
+  - fpga: 3\n\
+    ip: 192.168.8.4\n\
+hicanns:\n\
+  version: 4\n\
+  label: full\n";
+
+	for (auto const parser :
+	     {hwdb4cpp::LoadOptions::Parser::node, hwdb4cpp::LoadOptions::Parser::event}) {
+		hwdb4cpp::LoadOptions options;
+		options.parser = parser;
+		hwdb4cpp::database db;
+		db.load_from_buffer(shorthand, options);
+
+		Wafer const wafer(8);
+		FPGAGlobal const fpga0(FPGAOnWafer(0), wafer);
+		FPGAGlobal const fpga3(FPGAOnWafer(3), wafer);
+		FPGAGlobal const fpga5(FPGAOnWafer(5), wafer);
+		size_t const per_fpga = fpga0.toHICANNGlobal().size();
+
+		// kept symbolic, covering the FPGAs of the document
+		ASSERT_TRUE(db.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0));
+		EXPECT_EQ(db.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0)->label, "full");
+		EXPECT_FALSE(db.get_wafer_entry(wafer).find_shared_hicann_entry(fpga5));
+		EXPECT_EQ(db.get_hicann_entries(wafer).size(), 2 * per_fpga);
+		EXPECT_EQ(db.get_hicann_entries(fpga3).size(), per_fpga);
+		HICANNGlobal const hicann = fpga3.toHICANNGlobal().front();
+		EXPECT_TRUE(db.has_hicann_entry(hicann));
+		EXPECT_EQ(db.get_hicann_entry(hicann).label, "full");
+		EXPECT_FALSE(db.has_hicann_entry(fpga5.toHICANNGlobal().front()));
+		EXPECT_THROW(db.get_hicann_entry(fpga5.toHICANNGlobal().front()), std::out_of_range);
+		EXPECT_NE(dump(db).find("hicanns:\n  version: 4\n  label: full\n"), std::string::npos);
+
+		// changing the FPGAs doesn't change the HICANNs
+		db.add_fpga_entry(fpga5, db.get_fpga_entry(fpga0));
+		EXPECT_TRUE(db.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0));
+		EXPECT_FALSE(db.has_hicann_entry(fpga5.toHICANNGlobal().front()));
+		EXPECT_EQ(db.get_hicann_entries(wafer).size(), 2 * per_fpga);
+		// the shorthand no longer matches the FPGAs, HICANNs are listed individually
+		std::string const listed = dump(db);
+		EXPECT_EQ(listed.find("hicanns:\n  version: 4\n"), std::string::npos);
+		hwdb4cpp::database reloaded;
+		reloaded.load_from_buffer(listed, options);
+		EXPECT_EQ(reloaded.get_hicann_entries(wafer).keys(), db.get_hicann_entries(wafer).keys());
+		EXPECT_FALSE(reloaded.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0));
+		db.get_wafer_entry(wafer).fpgas.erase(fpga3);
+		EXPECT_TRUE(db.has_hicann_entry(hicann));
+		EXPECT_EQ(db.get_hicann_entries(wafer).size(), 2 * per_fpga);
+
+		// differing entries expand the shorthand
+		hwdb4cpp::database expanded;
+		expanded.load_from_buffer(shorthand, options);
+		hwdb4cpp::HICANNEntry entry = expanded.get_hicann_entry(hicann);
+		expanded.add_hicann_entry(hicann, entry);
+		EXPECT_TRUE(expanded.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0));
+		entry.label = "patched";
+		expanded.add_hicann_entry(hicann, entry);
+		EXPECT_FALSE(expanded.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0));
+		EXPECT_EQ(expanded.get_hicann_entries(wafer).size(), 2 * per_fpga);
+		EXPECT_EQ(expanded.get_hicann_entry(hicann).label, "patched");
+
+		// removing an FPGA drops its HICANNs without expanding
+		hwdb4cpp::database removed;
+		removed.load_from_buffer(shorthand, options);
+		EXPECT_TRUE(removed.remove_fpga_entry(fpga0));
+		EXPECT_FALSE(removed.get_wafer_entry(wafer).find_shared_hicann_entry(fpga0));
+		EXPECT_TRUE(removed.get_wafer_entry(wafer).find_shared_hicann_entry(fpga3));
+		EXPECT_EQ(removed.get_hicann_entries(wafer).size(), per_fpga);
+	}
+}
+
+TEST_F(HWDB4CPP_Test, range_entries)
+{
+	std::string const ranges = "---\n\
+wafer: 8\n\
+setuptype: bsswafer\n\
+macu: 192.168.200.165\n\
+macuversion: 1\n\
+fpgas:\n\
+  - fpga: 0-11\n\
+    ip: 192.168.8.1\n\
+  - fpga: 5\n\
+    ip: 192.168.8.6\n\
+    highspeed: false\n\
+  - fpga: 12-13\n\
+    ip: 192.168.8.255\n\
+reticles:\n\
+  - reticle: 0-47\n\
+  - reticle: 3\n\
+    to_be_powered: false\n\
+---\n\
+hxcube_id: 9\n\
+fpgas:\n\
+  - fpga: 0-3\n\
+    ip: 192.168.69.1\n\
+  - fpga: 2\n\
+    ip: 192.168.69.3\n\
+    handwritten_chip_serial: 12\n\
+    chip_revision: 42\n";
+
+	for (auto const parser :
+	     {hwdb4cpp::LoadOptions::Parser::node, hwdb4cpp::LoadOptions::Parser::event}) {
+		hwdb4cpp::LoadOptions options;
+		options.parser = parser;
+		hwdb4cpp::database db;
+		db.load_from_buffer(ranges, options);
+
+		Wafer const wafer(8);
+		auto const fpgas = db.get_fpga_entries(wafer);
+		ASSERT_EQ(fpgas.size(), 14);
+		EXPECT_EQ(fpgas.at(FPGAGlobal(FPGAOnWafer(11), wafer)).ip.to_string(), "192.168.8.12");
+		EXPECT_TRUE(fpgas.at(FPGAGlobal(FPGAOnWafer(4), wafer)).highspeed);
+		EXPECT_FALSE(fpgas.at(FPGAGlobal(FPGAOnWafer(5), wafer)).highspeed);
+		EXPECT_EQ(fpgas.at(FPGAGlobal(FPGAOnWafer(13), wafer)).ip.to_string(), "192.168.9.0");
+		auto const reticles = db.get_reticle_entries(wafer);
+		EXPECT_EQ(reticles.size(), 48);
+		EXPECT_FALSE(reticles.at(DNCGlobal(DNCOnWafer(Enum(3)), wafer)).to_be_powered);
+		EXPECT_TRUE(reticles.at(DNCGlobal(DNCOnWafer(Enum(47)), wafer)).to_be_powered);
+		auto const& hxcube = db.get_hxcube_setup_entry(9);
+		EXPECT_EQ(hxcube.fpgas.size(), 4);
+		EXPECT_EQ(hxcube.fpgas.at(3).ip.to_string(), "192.168.69.4");
+		EXPECT_TRUE(hxcube.fpgas.at(2).wing);
+
+		// runs matching the pattern are written back as ranges
+		std::string const dumped = dump(db);
+		EXPECT_NE(dumped.find("fpga: 0-4\n    ip: 192.168.8.1\n"), std::string::npos);
+		EXPECT_NE(dumped.find("fpga: 6-11\n    ip: 192.168.8.7\n"), std::string::npos);
+		EXPECT_NE(dumped.find("reticle: 4-47\n"), std::string::npos);
+		EXPECT_NE(dumped.find("fpga: 0-1\n    ip: 192.168.69.1\n"), std::string::npos);
+		hwdb4cpp::database reloaded;
+		reloaded.load_from_buffer(dumped, options);
+		EXPECT_EQ(dumped, dump(reloaded));
+
+		// malformed, out of range and overflowing ranges and ranges with per FPGA entries are
+		// rejected
+		for (auto const invalid :
+		     {"---\nhxcube_id: 9\nfpgas:\n  - fpga: 3-1\n    ip: 192.168.69.1\n",
+		      "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0-x\n    ip: 192.168.69.1\n",
+		      "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0-1\n    ip: 192.168.69.1\n    fuse_dna: 1\n",
+		      "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0-18446744073709551615\n    ip: 192.168.69.1\n",
+		      "---\nhxcube_id: 9\nfpgas:\n  - fpga: 0-1100000000\n    ip: 192.168.69.1\n",
+		      "---\nwafer: 8\nsetuptype: bsswafer\nmacu: 192.168.200.165\nmacuversion: 1\nfpgas:\n  - fpga: 40-48\n    ip: 192.168.8.1\n",
+		      "---\nwafer: 8\nsetuptype: bsswafer\nmacu: 192.168.200.165\nmacuversion: 1\nreticles:\n  - reticle: 0-48\n"}) {
+			hwdb4cpp::database invalid_db;
+			EXPECT_ANY_THROW(invalid_db.load_from_buffer(invalid, options)) << invalid;
+		}
+	}
+}
+
+TEST_F(HWDB4CPP_Test, dense_map)
+{
+	hwdb4cpp::HICANNEntryMap hicanns;
+	EXPECT_TRUE(hicanns.empty());
+	EXPECT_EQ(hicanns.begin(), hicanns.end());
+
+	HICANNGlobal const first(HICANNOnWafer(Enum(20)), Wafer(5));
+	HICANNGlobal const second(HICANNOnWafer(Enum(300)), Wafer(5));
+	hicanns[second].label = "second";
+	EXPECT_TRUE(hicanns.insert({first, hwdb4cpp::HICANNEntry{4, "first"}}).second);
+	EXPECT_FALSE(hicanns.insert({first, hwdb4cpp::HICANNEntry{2, "other"}}).second);
+	EXPECT_EQ(hicanns.size(), 2);
+	EXPECT_EQ(hicanns.at(first).version, 4);
+	EXPECT_EQ(hicanns.count(HICANNGlobal(HICANNOnWafer(Enum(21)), Wafer(5))), 0);
+
+	// iteration in coordinate order
+	EXPECT_EQ(hicanns.keys(), (std::vector<HICANNGlobal>{first, second}));
+	EXPECT_EQ(hicanns.begin()->first, first);
+	EXPECT_EQ(std::prev(hicanns.end())->second.label, "second");
+
+	// same on-wafer coordinate of another wafer is a different key
+	HICANNGlobal const other_wafer(HICANNOnWafer(Enum(20)), Wafer(6));
+	EXPECT_EQ(hicanns.find(other_wafer), hicanns.end());
+	EXPECT_THROW(hicanns.at(other_wafer), std::out_of_range);
+	EXPECT_THROW(hicanns[other_wafer], std::invalid_argument);
+
+	hwdb4cpp::HICANNEntryMap copy = hicanns;
+	EXPECT_EQ(hicanns.erase(first), 1);
+	EXPECT_EQ(hicanns.erase(first), 0);
+	EXPECT_EQ(hicanns.erase(hicanns.begin()), hicanns.end());
+	EXPECT_TRUE(hicanns.empty());
+	EXPECT_EQ(copy.size(), 2);
+	hicanns = std::move(copy);
+	EXPECT_EQ(hicanns.at(second).label, "second");
+}
+
+TEST_F(HWDB4CPP_Test, load_async)
+{
+	hwdb4cpp::database sync_db;
+	sync_db.load(test_path);
+
+	hwdb4cpp::LoadOptions options;
+	options.use_snapshot = false;
+	hwdb4cpp::database async_db;
+	auto loaded = async_db.load_async(test_path, options);
+	loaded.get();
+	EXPECT_EQ(dump(sync_db), dump(async_db));
+
+	// concurrent loads share the worker threads
+	std::vector<hwdb4cpp::database> dbs(8);
+	std::vector<std::future<void> > futures;
+	for (auto& db : dbs) {
+		futures.push_back(db.load_async(test_path, options));
+	}
+	for (size_t i = 0; i < dbs.size(); ++i) {
+		futures[i].get();
+		EXPECT_EQ(dump(sync_db), dump(dbs[i]));
+	}
+
+	// errors are rethrown by the future
+	EXPECT_THROW(async_db.load_async(test_path).get(), std::runtime_error);
+	hwdb4cpp::database missing_db;
+	auto missing = missing_db.load_async(test_path + ".missing");
+	EXPECT_ANY_THROW(missing.get());
+}
+
+TEST_F(HWDB4CPP_Test, copy_and_clear)
+{
+	hwdb4cpp::LoadOptions options;
+	options.use_snapshot = false;
+	options.lazy = true;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+	std::string const expected = dump(db);
+
+	// copies do not share storage, neither decoded nor pending entries
+	hwdb4cpp::database copy(db);
+	hwdb4cpp::database assigned;
+	assigned = db;
+	hwdb4cpp::database moved(std::move(assigned));
+	db.clear();
+	EXPECT_TRUE(db.get_wafer_coordinates().empty());
+	EXPECT_EQ(dump(copy), expected);
+	EXPECT_EQ(dump(moved), expected);
+	EXPECT_EQ(copy.get_hxcube_setup_entry(6).usb_host, "AMTHost11");
+
+	// a cleared database can be reused
+	db.load(test_path);
+	EXPECT_EQ(dump(db), expected);
+	db.clear();
+	db.add_dls_entry("07_20", copy.get_dls_entry("07_20"));
+	EXPECT_EQ(db.get_dls_setup_ids(), std::vector<std::string>{"07_20"});
+}
+
+TEST_F(HWDB4CPP_Test, move)
+{
+	hwdb4cpp::database db;
+	db.load(test_path);
+	std::string const expected = dump(db);
+	hwdb4cpp::database const& view = db;
+	hwdb4cpp::HXCubeSetupEntry const* const entry = &view.get_hxcube_setup_entry(6);
+	EXPECT_EQ(view.find_chip(12)->setup_id, 6);
+
+	// entries are not copied, the moved-from database is empty but usable
+	auto moved = std::make_unique<hwdb4cpp::database>(std::move(db));
+	EXPECT_EQ(&static_cast<hwdb4cpp::database const&>(*moved).get_hxcube_setup_entry(6), entry);
+	EXPECT_EQ(dump(*moved), expected);
+	EXPECT_EQ(moved->find_chip(12)->setup_id, 6);
+	EXPECT_TRUE(db.get_hxcube_ids().empty());
+	EXPECT_FALSE(db.find_chip(12));
+	EXPECT_TRUE(db.has_index<hwdb4cpp::HXCubeSetupEntry>("usb_host"));
+
+	// move assignment releases the previous entries
+	hwdb4cpp::database assigned;
+	assigned.load(test_path);
+	assigned.add_hxcube_setup_entry(9, hwdb4cpp::HXCubeSetupEntry());
+	assigned = std::move(*moved);
+	EXPECT_EQ(&static_cast<hwdb4cpp::database const&>(assigned).get_hxcube_setup_entry(6), entry);
+	EXPECT_EQ(assigned.get_hxcube_ids(), std::vector<size_t>{6});
+
+	// databases moved from own their storage
+	moved.reset();
+	db.load(test_path);
+	EXPECT_EQ(dump(db), expected);
+	EXPECT_EQ(dump(assigned), expected);
+}
+
+TEST_F(HWDB4CPP_Test, views)
+{
+	hwdb4cpp::LoadOptions options;
+	options.use_snapshot = false;
+	options.lazy = true;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+
+	// ids of decoded and pending entries are merged in ascending order
+	db.add_hxcube_setup_entry(3, hwdb4cpp::HXCubeSetupEntry());
+	db.add_hxcube_setup_entry(8, hwdb4cpp::HXCubeSetupEntry());
+	std::vector<size_t> hxcube_ids;
+	db.for_each_hxcube_id([&hxcube_ids](size_t const id) { hxcube_ids.push_back(id); });
+	EXPECT_EQ(hxcube_ids, (std::vector<size_t>{3, 6, 8}));
+	EXPECT_EQ(db.get_hxcube_ids(), hxcube_ids);
+	std::vector<Wafer> wafers;
+	db.for_each_wafer_coordinate([&wafers](Wafer const wafer) { wafers.push_back(wafer); });
+	EXPECT_EQ(wafers, db.get_wafer_coordinates());
+
+	// views refer to the stored tables
+	Wafer const wafer(5);
+	hwdb4cpp::FPGAEntryMap const& fpgas = db.view_fpga_entries(wafer);
+	EXPECT_EQ(&fpgas, &db.view_fpga_entries(wafer));
+	EXPECT_EQ(&fpgas, &db.get_wafer_entry(wafer).fpgas);
+	EXPECT_EQ(fpgas.keys(), db.get_fpga_entries(wafer).keys());
+	EXPECT_EQ(&db.view_adc_entries(wafer), &db.get_wafer_entry(wafer).adcs);
+	EXPECT_EQ(db.view_reticle_entries(wafer).size(), db.get_reticle_entries(wafer).size());
+	EXPECT_EQ(db.view_ananas_entries(wafer).size(), db.get_ananas_entries(wafer).size());
+	EXPECT_THROW(db.view_fpga_entries(Wafer(6)), std::out_of_range);
+
+	hwdb4cpp::HICANNEntryMap hicanns;
+	db.for_each_hicann_entry(
+	    wafer, [&hicanns](HICANNGlobal const hicann, hwdb4cpp::HICANNEntry const& entry) {
+		    hicanns.emplace(hicann, entry);
+	    });
+	EXPECT_EQ(hicanns.keys(), db.get_hicann_entries(wafer).keys());
+
+	// the full wafer shorthand is resolved in coordinate order
+	hwdb4cpp::database shorthand;
+	shorthand.load_from_buffer("---\n\
+wafer: 8\n\
+setuptype: bsswafer\n\
+macu: 192.168.200.165\n\
+macuversion: 1\n\
+fpgas:\n\
+  - fpga: 3\n\
+    ip: 192.168.8.4\n\
+  - fpga: 0\n\
+    ip: 192.168.8.1\n\
+hicanns:\n\
+  version: 4\n\
+  label: full\n");
+	std::vector<HICANNGlobal> keys;
+	shorthand.for_each_hicann_entry(
+	    Wafer(8), [&keys](HICANNGlobal const hicann, hwdb4cpp::HICANNEntry const& entry) {
+		    EXPECT_EQ(entry.label, "full");
+		    keys.push_back(hicann);
+	    });
+	EXPECT_EQ(keys, shorthand.get_hicann_entries(Wafer(8)).keys());
+	EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST_F(HWDB4CPP_Test, find_entries)
+{
+	hwdb4cpp::LoadOptions options;
+	options.lazy = true;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+
+	Wafer const wafer(5);
+	FPGAGlobal const fpga(FPGAOnWafer(3), wafer);
+	ASSERT_TRUE(db.find_fpga_entry(fpga));
+	EXPECT_EQ(db.find_fpga_entry(fpga), &db.get_fpga_entry(fpga));
+	EXPECT_EQ(db.find_wafer_entry(wafer), &db.get_wafer_entry(wafer));
+	EXPECT_EQ(db.find_hxcube_setup_entry(6), &db.get_hxcube_setup_entry(6));
+	EXPECT_EQ(db.find_jboa_setup_entry(7), &db.get_jboa_setup_entry(7));
+	EXPECT_EQ(db.find_dls_entry("07_20"), &db.get_dls_entry("07_20"));
+	HICANNGlobal const hicann(HICANNOnWafer(Enum(144)), wafer);
+	ASSERT_TRUE(db.find_hicann_entry(hicann));
+	EXPECT_EQ(db.find_hicann_entry(hicann)->label, db.get_hicann_entry(hicann).label);
+
+	// misses, also on absent wafers, return nullptr without throwing
+	Wafer const other(6);
+	EXPECT_FALSE(db.find_wafer_entry(other));
+	EXPECT_FALSE(db.find_fpga_entry(FPGAGlobal(FPGAOnWafer(1), wafer)));
+	EXPECT_FALSE(db.find_fpga_entry(FPGAGlobal(FPGAOnWafer(3), other)));
+	EXPECT_FALSE(db.find_reticle_entry(DNCGlobal(DNCOnWafer(Enum(0)), other)));
+	EXPECT_FALSE(db.find_ananas_entry(AnanasGlobal(AnanasOnWafer(1), wafer)));
+	EXPECT_FALSE(db.find_hicann_entry(HICANNGlobal(HICANNOnWafer(Enum(20)), wafer)));
+	EXPECT_FALSE(db.find_hicann_entry(HICANNGlobal(HICANNOnWafer(Enum(144)), other)));
+	EXPECT_FALSE(db.find_adc_entry(hwdb4cpp::GlobalAnalog_t(
+	    FPGAGlobal(FPGAOnWafer(3), other), AnalogOnHICANN(0))));
+	EXPECT_FALSE(db.has_adc_entry(hwdb4cpp::GlobalAnalog_t(
+	    FPGAGlobal(FPGAOnWafer(3), other), AnalogOnHICANN(0))));
+	EXPECT_FALSE(db.find_dls_entry("missing"));
+	EXPECT_FALSE(db.find_hxcube_setup_entry(7));
+	EXPECT_FALSE(db.find_jboa_setup_entry(6));
+}
+
+TEST_F(HWDB4CPP_Test, sub_queries)
+{
+	hwdb4cpp::database db;
+	db.load(test_path);
+
+	Wafer const wafer(5);
+	FPGAGlobal const fpga(FPGAOnWafer(3), wafer);
+	HICANNGlobal const hicann(HICANNOnWafer(Enum(88)), wafer);
+	DNCGlobal const reticle = hicann.toDNCGlobal();
+	HICANNOnDNC const other = hicann.toHICANNOnWafer().toHICANNOnDNC() == HICANNOnDNC(0)
+	                              ? HICANNOnDNC(1)
+	                              : HICANNOnDNC(0);
+	db.add_hicann_entry(
+	    HICANNGlobal(other.toHICANNOnWafer(reticle.toDNCOnWafer()), wafer),
+	    db.get_hicann_entry(hicann));
+	auto const hicanns = db.get_hicann_entries(reticle);
+	EXPECT_EQ(hicanns.size(), 2);
+	for (auto const& item : hicanns) {
+		EXPECT_EQ(item.first.toDNCGlobal(), reticle);
+	}
+	EXPECT_EQ(db.get_hicann_entries(reticle.toFPGAGlobal()).keys(), hicanns.keys());
+	EXPECT_TRUE(db.get_hicann_entries(DNCGlobal(reticle.toDNCOnWafer(), Wafer(6))).empty());
+
+	// only the ADCs of the requested FPGA
+	hwdb4cpp::ADCEntry const adc = db.get_adc_entry(hwdb4cpp::GlobalAnalog_t(fpga, AnalogOnHICANN(0)));
+	db.add_adc_entry(hwdb4cpp::GlobalAnalog_t(fpga, AnalogOnHICANN(1)), adc);
+	db.add_adc_entry(
+	    hwdb4cpp::GlobalAnalog_t(FPGAGlobal(FPGAOnWafer(2), wafer), AnalogOnHICANN(1)), adc);
+	db.add_adc_entry(
+	    hwdb4cpp::GlobalAnalog_t(FPGAGlobal(FPGAOnWafer(4), wafer), AnalogOnHICANN(0)), adc);
+	auto const adcs = db.get_adc_entries(fpga);
+	ASSERT_EQ(adcs.size(), 2);
+	EXPECT_EQ(adcs.begin()->first, hwdb4cpp::GlobalAnalog_t(fpga, AnalogOnHICANN(0)));
+	EXPECT_EQ(adcs.rbegin()->first, hwdb4cpp::GlobalAnalog_t(fpga, AnalogOnHICANN(1)));
+	EXPECT_TRUE(db.get_adc_entries(FPGAGlobal(FPGAOnWafer(1), wafer)).empty());
+
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+	EXPECT_EQ(frozen.get_hicann_entries(reticle).keys(), hicanns.keys());
+	EXPECT_EQ(frozen.get_adc_entries(fpga).size(), 2);
+}
+
+TEST_F(HWDB4CPP_Test, network_endpoints)
+{
+	hwdb4cpp::LoadOptions options;
+	options.lazy = true;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+
+	Wafer const wafer(5);
+	FPGAGlobal const fpga(FPGAOnWafer(3), wafer);
+	auto endpoints = db.find_endpoints(IPv4::from_string("192.168.5.4"));
+	ASSERT_EQ(endpoints.size(), 1);
+	EXPECT_EQ(endpoints[0].owner, hwdb4cpp::EndpointOwner::fpga);
+	EXPECT_EQ(endpoints[0].port, 0);
+	EXPECT_EQ(endpoints[0].get_fpga(), fpga);
+	EXPECT_THROW(endpoints[0].get_ananas(), std::runtime_error);
+
+	// each Ananas slice has a data and a reset port, ordered by port
+	IPv4 const ananas_ip = IPv4::from_string("192.168.5.190");
+	endpoints = db.find_endpoints(ananas_ip);
+	ASSERT_EQ(endpoints.size(), 2 * AnanasSliceOnAnanas::size);
+	EXPECT_EQ(endpoints.front().owner, hwdb4cpp::EndpointOwner::ananas_reset);
+	EXPECT_EQ(endpoints.front().port, 0x2570);
+	EXPECT_EQ(endpoints.back().owner, hwdb4cpp::EndpointOwner::ananas_data);
+	endpoints = db.find_endpoints(ananas_ip, 0xafe1);
+	ASSERT_EQ(endpoints.size(), 1);
+	EXPECT_EQ(endpoints[0].get_ananas(), AnanasGlobal(AnanasOnWafer(0), wafer));
+	EXPECT_EQ(endpoints[0].sub_index, 1);
+	EXPECT_TRUE(db.find_endpoints(ananas_ip, 0xafe0 + AnanasSliceOnAnanas::size).empty());
+
+	endpoints = db.find_endpoints(IPv4::from_string("192.168.200.44"), 44489);
+	ASSERT_EQ(endpoints.size(), 1);
+	EXPECT_EQ(endpoints[0].get_analog(), hwdb4cpp::GlobalAnalog_t(fpga, AnalogOnHICANN(0)));
+	endpoints = db.find_endpoints(IPv4::from_string("192.168.87.13"));
+	ASSERT_EQ(endpoints.size(), 1);
+	EXPECT_EQ(endpoints[0].owner, hwdb4cpp::EndpointOwner::jboa_aggregator);
+	EXPECT_EQ(endpoints[0].setup, 7);
+	EXPECT_THROW(endpoints[0].get_wafer(), std::runtime_error);
+	EXPECT_TRUE(db.find_endpoints(IPv4::from_string("192.168.5.2")).empty());
+
+	endpoints = db.find_endpoints_in_subnet(IPv4::from_string("192.168.66.0"), 24);
+	ASSERT_EQ(endpoints.size(), 2);
+	EXPECT_EQ(endpoints[0].owner, hwdb4cpp::EndpointOwner::hxcube_fpga);
+	EXPECT_EQ(endpoints[1].index, 7);
+	EXPECT_EQ(db.find_endpoints_in_subnet(IPv4::from_string("192.168.5.0"), 24).size(), 10);
+	EXPECT_EQ(db.find_endpoints_in_subnet(IPv4::from_string("192.168.200.160"), 28).size(), 1);
+	EXPECT_EQ(db.find_endpoints_in_subnet(IPv4::from_string("192.168.5.1"), 32).size(), 1);
+	EXPECT_EQ(db.find_endpoints_in_subnet(IPv4::from_string("10.0.0.0"), 0).size(), 16);
+	EXPECT_THROW(
+	    db.find_endpoints_in_subnet(IPv4::from_string("10.0.0.0"), 33), std::invalid_argument);
+
+	// modifications are visible to the next query, frozen databases keep their state
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+	IPv4 const added = IPv4::from_string("192.168.5.2");
+	db.add_fpga_entry(FPGAGlobal(FPGAOnWafer(1), wafer), hwdb4cpp::FPGAEntry{added, true});
+	EXPECT_EQ(db.find_endpoints(added).size(), 1);
+	EXPECT_TRUE(frozen.find_endpoints(added).empty());
+	db.remove_fpga_entry(FPGAGlobal(FPGAOnWafer(1), wafer));
+	EXPECT_TRUE(db.find_endpoints(added).empty());
+	db.get_hxcube_setup_entry(6).fpgas.at(7).ip = added;
+	EXPECT_EQ(db.find_endpoints(added).size(), 1);
+	EXPECT_EQ(frozen.find_endpoints(IPv4::from_string("192.168.66.8")).size(), 1);
+	EXPECT_EQ(frozen.find_endpoints_in_subnet(IPv4::from_string("192.168.0.0"), 16).size(), 16);
+	db.clear();
+	EXPECT_TRUE(db.find_endpoints(added).empty());
+}
+
+TEST_F(HWDB4CPP_Test, unique_branch_identifier)
+{
+	using hwdb4cpp::UniqueBranchIdentifier;
+	UniqueBranchIdentifier id;
+	ASSERT_TRUE(UniqueBranchIdentifier::parse("jboa7fpga12chip13_1", id));
+	EXPECT_EQ(id.family, hwdb4cpp::SetupFamily::jboa);
+	EXPECT_EQ(id.setup_id, 7);
+	EXPECT_EQ(id.fpga_id, 12);
+	EXPECT_EQ(id.chip_serial, 13);
+	EXPECT_EQ(id.setup_version, 1);
+	EXPECT_EQ(id.to_string(), "jboa7fpga12chip13_1");
+	for (auto const malformed :
+	     {"", "hxcube", "hxcube9fpga0chip12", "hxcube9fpga0chip12_1x", "hxcube9fpga-1chip12_1",
+	      "hxcubefpga0chip12_1", "dls9fpga0chip12_1", "hxcube99999999999999999999fpga0chip12_1"}) {
+		EXPECT_FALSE(UniqueBranchIdentifier::parse(malformed, id)) << malformed;
+	}
+	EXPECT_THROW(UniqueBranchIdentifier::from_string("jboa7"), std::runtime_error);
+
+	// formatting into a buffer reports too small buffers
+	id = UniqueBranchIdentifier::from_string("hxcube9fpga0chip12_1");
+	std::array<char, UniqueBranchIdentifier::max_size> buffer;
+	size_t const size = id.format(buffer.data(), buffer.size());
+	EXPECT_EQ(std::string(buffer.data(), size), "hxcube9fpga0chip12_1");
+	EXPECT_EQ(id.format(buffer.data(), size - 1), 0);
+	id.setup_id = id.fpga_id = id.chip_serial = id.setup_version = std::numeric_limits<size_t>::max();
+	EXPECT_GT(id.format(buffer.data(), buffer.size()), 0);
+	id.family = hwdb4cpp::SetupFamily::dls_setup;
+	EXPECT_THROW(id.to_string(), std::invalid_argument);
+
+	std::vector<std::string> const identifiers = {"hxcube9fpga0chip12_1", "jboa7fpga12chip13_1"};
+	EXPECT_EQ(
+	    UniqueBranchIdentifier::to_strings(UniqueBranchIdentifier::from_strings(identifiers)),
+	    identifiers);
+	EXPECT_THROW(
+	    UniqueBranchIdentifier::from_strings({"hxcube9fpga0chip12_1", "x"}), std::runtime_error);
+	EXPECT_EQ(
+	    hwdb4cpp::HXCubeSetupEntry::get_ids_from_unique_branch_identifier("hxcube9fpga0chip12_1"),
+	    std::make_tuple(9, 0, 12, 1));
+	EXPECT_THROW(
+	    hwdb4cpp::HXCubeSetupEntry::get_ids_from_unique_branch_identifier("jboa7fpga12chip13_1"),
+	    std::runtime_error);
+
+	// chips of all setups by handwritten and EEPROM serial
+	hwdb4cpp::database db;
+	db.load(test_path);
+	EXPECT_EQ(db.get_unique_branch_identifier(12), "hxcube6fpga0chip12_1");
+	EXPECT_EQ(db.get_unique_branch_identifier(0x1234ABCD), "hxcube6fpga0chip12_1");
+	EXPECT_EQ(
+	    db.get_unique_branch_identifiers({13, 12}),
+	    std::vector<std::string>({"jboa7fpga12chip13_1", "hxcube6fpga0chip12_1"}));
+	EXPECT_EQ(
+	    db.get_unique_branch_identifier(12),
+	    db.get_hxcube_setup_entry(6).get_unique_branch_identifier(12));
+	ASSERT_TRUE(db.find_chip(13));
+	EXPECT_EQ(db.find_chip(13)->family, hwdb4cpp::SetupFamily::jboa);
+	EXPECT_FALSE(db.find_chip(14));
+	EXPECT_FALSE(db.find_chip(0));
+	EXPECT_THROW(db.get_unique_branch_identifier(14), std::runtime_error);
+	EXPECT_THROW(db.get_unique_branch_identifiers({12, 14}), std::runtime_error);
+
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+	db.get_jboa_setup_entry(7).fpgas.at(12).wing->handwritten_chip_serial = 14;
+	EXPECT_EQ(db.get_unique_branch_identifier(14), "jboa7fpga12chip14_1");
+	EXPECT_FALSE(db.find_chip(13));
+	EXPECT_EQ(frozen.get_unique_branch_identifier(13), "jboa7fpga12chip13_1");
+}
+
+TEST_F(HWDB4CPP_Test, fpga_dna)
+{
+	// bit i of the DNA_PORT is bit 63 - i of the FUSE_DNA
+	std::vector<uint64_t> fuse_dnas = {
+	    0, ~uint64_t(0), 0x3A0E92C402882A33, uint64_t(1) << 63, 0x7f};
+	for (uint64_t value = 0x9E3779B97F4A7C15; fuse_dnas.size() < 64; value *= 0x9E3779B97F4A7C15) {
+		fuse_dnas.push_back(value);
+	}
+	auto const dna_ports = hwdb4cpp::HXCubeFPGAEntry::dna_ports_from_fuse_dnas(fuse_dnas);
+	ASSERT_EQ(dna_ports.size(), fuse_dnas.size());
+	for (size_t i = 0; i < fuse_dnas.size(); ++i) {
+		uint64_t expected = 0;
+		for (size_t bit = 0; bit < 57; ++bit) {
+			expected |= ((fuse_dnas[i] >> (63 - bit)) & 1) << bit;
+		}
+		EXPECT_EQ(dna_ports[i], expected) << std::hex << fuse_dnas[i];
+	}
+
+	hwdb4cpp::LoadOptions options;
+	options.lazy = true;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+	hwdb4cpp::FPGALocation const fpga{hwdb4cpp::SetupFamily::hxcube, 6, 0};
+	EXPECT_EQ(db.find_fpga_by_fuse_dna(0x3A0E92C402882A33), fpga);
+	EXPECT_EQ(
+	    db.find_fpga_by_dna_port(db.get_hxcube_setup_entry(6).fpgas.at(0).get_dna_port()), fpga);
+	EXPECT_FALSE(db.find_fpga_by_fuse_dna(0x5411402349705C));
+	EXPECT_FALSE(db.find_fpga_by_dna_port(0x3A0E92C402882A33));
+	auto const found = db.find_fpgas_by_dna_port({0x5411402349705C, 0});
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[0], fpga);
+	EXPECT_FALSE(found[1]);
+
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+	db.get_jboa_setup_entry(7).fpgas.at(12).fuse_dna = 0x123456789;
+	hwdb4cpp::FPGALocation const jboa_fpga{hwdb4cpp::SetupFamily::jboa, 7, 12};
+	EXPECT_EQ(db.find_fpga_by_fuse_dna(0x123456789), jboa_fpga);
+	EXPECT_EQ(
+	    db.find_fpga_by_dna_port(hwdb4cpp::HXCubeFPGAEntry::dna_port_from_fuse_dna(0x123456789)),
+	    jboa_fpga);
+	EXPECT_FALSE(frozen.find_fpga_by_fuse_dna(0x123456789));
+	EXPECT_EQ(frozen.find_fpga_by_dna_port(0x5411402349705C), fpga);
+}
+
+TEST_F(HWDB4CPP_Test, adc_index)
+{
+	hwdb4cpp::database db;
+	db.load(test_path);
+
+	Wafer const wafer(5);
+	hwdb4cpp::GlobalAnalog_t const analog(FPGAGlobal(FPGAOnWafer(3), wafer), AnalogOnHICANN(0));
+	ASSERT_EQ(db.get_adc_serials(), std::vector<std::string>{"B201259"});
+	auto channels = db.get_adc_channels("B201259");
+	ASSERT_EQ(channels.size(), 1);
+	EXPECT_EQ(channels[0].analog, analog);
+	EXPECT_EQ(channels[0].channel, ChannelOnADC(0));
+	EXPECT_EQ(channels[0].trigger, TriggerOnADC(1));
+	EXPECT_TRUE(db.get_adc_channels("B201331").empty());
+	EXPECT_TRUE(db.get_adc_conflicts().empty());
+
+	// the index follows modifications, channels are ordered by analog output
+	hwdb4cpp::ADCEntry adc = db.get_adc_entry(analog);
+	hwdb4cpp::GlobalAnalog_t const conflicting(
+	    FPGAGlobal(FPGAOnWafer(2), wafer), AnalogOnHICANN(0));
+	db.add_adc_entry(conflicting, adc);
+	adc.channel = ChannelOnADC(1);
+	db.add_adc_entry(hwdb4cpp::GlobalAnalog_t(analog.first, AnalogOnHICANN(1)), adc);
+	adc.coord = "B201331";
+	db.add_adc_entry(
+	    hwdb4cpp::GlobalAnalog_t(FPGAGlobal(FPGAOnWafer(4), wafer), AnalogOnHICANN(0)), adc);
+	EXPECT_EQ(db.get_adc_serials(), (std::vector<std::string>{"B201259", "B201331"}));
+	channels = db.get_adc_channels("B201259");
+	ASSERT_EQ(channels.size(), 3);
+	EXPECT_EQ(channels[0].analog, conflicting);
+	EXPECT_EQ(channels[1].analog, analog);
+	EXPECT_EQ(channels[2].channel, ChannelOnADC(1));
+	EXPECT_EQ(db.get_adc_channels("B201331").size(), 1);
+
+	auto const conflicts = db.get_adc_conflicts();
+	ASSERT_EQ(conflicts.size(), 1);
+	EXPECT_EQ(conflicts[0].adc, "B201259");
+	EXPECT_EQ(conflicts[0].first.analog, conflicting);
+	EXPECT_EQ(conflicts[0].second.analog, analog);
+
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+	EXPECT_EQ(frozen.get_adc_serials(), db.get_adc_serials());
+	EXPECT_EQ(frozen.get_adc_channels("B201331").size(), 1);
+	EXPECT_EQ(frozen.get_adc_conflicts().size(), 1);
+}
+
+TEST_F(HWDB4CPP_Test, secondary_indexes)
+{
+	using hwdb4cpp::FPGALocation;
+	using hwdb4cpp::IndexKey;
+	using hwdb4cpp::SetupFamily;
+
+	hwdb4cpp::database db;
+	db.load(test_path);
+
+	// default indexes
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HXCubeSetupEntry>("usb_host", std::string("AMTHost11")),
+	    std::vector<size_t>{6});
+	std::string const server = "abc.de:1234";
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HXCubeSetupEntry>("xilinx_hw_server", server),
+	    std::vector<size_t>{6});
+	EXPECT_TRUE(db.find_by_index<hwdb4cpp::JboaSetupEntry>("xilinx_hw_server", server).empty());
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HXCubeFPGAEntry>("ci_test_node", true),
+	    (std::vector<FPGALocation>{{SetupFamily::hxcube, 6, 0}}));
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HXCubeFPGAEntry>("ci_test_node", false),
+	    (std::vector<FPGALocation>{{SetupFamily::hxcube, 6, 7}, {SetupFamily::jboa, 7, 12}}));
+	EXPECT_EQ(
+	    db.find_by_index_range<hwdb4cpp::HXCubeWingEntry>(
+	        "chip_revision", IndexKey(int64_t(43)), IndexKey(int64_t(100))),
+	    (std::vector<FPGALocation>{{SetupFamily::jboa, 7, 12}}));
+	EXPECT_EQ(
+	    db.find_by_index_range<hwdb4cpp::HXCubeWingEntry>(
+	          "chip_revision", IndexKey(int64_t(0)), IndexKey(int64_t(100)))
+	        .size(),
+	    2);
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::JboaAggregatorEntry>("ci_test_node", true),
+	    (std::vector<std::pair<size_t, size_t> >{{7, 0}}));
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::ReticleEntry>("to_be_powered", true),
+	    std::vector<DNCGlobal>{DNCGlobal(DNCOnWafer(Enum(0)), Wafer(5))});
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HICANNEntry>("version", IndexKey(int64_t(4))).size(), 2);
+
+	// lookups only answer what the index supports
+	EXPECT_THROW(
+	    db.find_by_index_range<hwdb4cpp::HXCubeSetupEntry>("usb_host", server, server),
+	    std::invalid_argument);
+	EXPECT_THROW(db.find_by_index<hwdb4cpp::ReticleEntry>("usb_host", true), std::out_of_range);
+	EXPECT_FALSE(db.has_index<hwdb4cpp::ReticleEntry>("usb_host"));
+
+	// default indexes are kept consistent under modifications
+	DNCGlobal const reticle(DNCOnWafer(Enum(1)), Wafer(5));
+	db.add_reticle_entry(reticle, hwdb4cpp::ReticleEntry{true});
+	EXPECT_EQ(db.find_by_index<hwdb4cpp::ReticleEntry>("to_be_powered", true).size(), 2);
+	db.remove_reticle_entry(reticle);
+	EXPECT_EQ(db.find_by_index<hwdb4cpp::ReticleEntry>("to_be_powered", true).size(), 1);
+	// a HICANN behind the FPGA of HICANN 88
+	HICANNGlobal const hicann(
+	    HICANNOnWafer(Enum(88)).toHICANNOnDNC() == HICANNOnDNC(0)
+	        ? HICANNOnDNC(1).toHICANNOnWafer(HICANNOnWafer(Enum(88)).toDNCOnWafer())
+	        : HICANNOnDNC(0).toHICANNOnWafer(HICANNOnWafer(Enum(88)).toDNCOnWafer()),
+	    Wafer(5));
+	db.add_hicann_entry(hicann, hwdb4cpp::HICANNEntry{2, "v2"});
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HICANNEntry>("version", IndexKey(int64_t(2))),
+	    std::vector<HICANNGlobal>{hicann});
+	db.remove_hicann_entry(hicann);
+	EXPECT_TRUE(db.find_by_index<hwdb4cpp::HICANNEntry>("version", IndexKey(int64_t(2))).empty());
+
+	// custom index, kept consistent under modifications
+	db.add_index<hwdb4cpp::FPGAEntry>(
+	    "highspeed", [](hwdb4cpp::FPGAEntry const& entry) { return IndexKey(entry.highspeed); });
+	EXPECT_TRUE(db.has_index<hwdb4cpp::FPGAEntry>("highspeed"));
+	FPGAGlobal const fpga(FPGAOnWafer(3), Wafer(5));
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false), std::vector<FPGAGlobal>{fpga});
+	hwdb4cpp::FPGAEntry entry = db.get_fpga_entry(fpga);
+	db.add_fpga_entry(FPGAGlobal(FPGAOnWafer(4), Wafer(5)), entry);
+	EXPECT_EQ(db.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false).size(), 2);
+	db.remove_fpga_entry(fpga);
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false),
+	    std::vector<FPGAGlobal>{FPGAGlobal(FPGAOnWafer(4), Wafer(5))});
+
+	hwdb4cpp::HXCubeSetupEntry hxcube = db.get_hxcube_setup_entry(6);
+	db.add_hxcube_setup_entry(9, hxcube);
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HXCubeSetupEntry>("usb_host", std::string("AMTHost11")),
+	    (std::vector<size_t>{6, 9}));
+	db.get_hxcube_setup_entry(6).usb_host = "AMTHost12";
+	EXPECT_EQ(
+	    db.find_by_index<hwdb4cpp::HXCubeSetupEntry>("usb_host", std::string("AMTHost11")),
+	    std::vector<size_t>{9});
+
+	// registered indexes are kept by copies, clear() and frozen databases
+	hwdb4cpp::database copy(db);
+	EXPECT_EQ(copy.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false).size(), 1);
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+	EXPECT_TRUE(frozen.has_index<hwdb4cpp::FPGAEntry>("highspeed"));
+	EXPECT_EQ(
+	    frozen.find_by_index<hwdb4cpp::HXCubeSetupEntry>("usb_host", std::string("AMTHost12")),
+	    std::vector<size_t>{6});
+	EXPECT_TRUE(db.remove_index<hwdb4cpp::FPGAEntry>("highspeed"));
+	EXPECT_FALSE(db.remove_index<hwdb4cpp::FPGAEntry>("highspeed"));
+	EXPECT_THROW(db.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false), std::out_of_range);
+	EXPECT_EQ(frozen.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false).size(), 1);
+	copy.clear();
+	EXPECT_TRUE(copy.find_by_index<hwdb4cpp::FPGAEntry>("highspeed", false).empty());
+}
+
+TEST_F(HWDB4CPP_Test, freeze)
+{
+	hwdb4cpp::LoadOptions options;
+	options.lazy = true;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+	hwdb4cpp::frozen_database const frozen = db.freeze();
+
+	Wafer const wafer(5);
+	FPGAGlobal const fpga(FPGAOnWafer(3), wafer);
+	EXPECT_EQ(frozen.get_wafer_coordinates(), db.get_wafer_coordinates());
+	EXPECT_TRUE(frozen.has_fpga_entry(fpga));
+	EXPECT_FALSE(frozen.has_fpga_entry(FPGAGlobal(FPGAOnWafer(3), Wafer(6))));
+	EXPECT_FALSE(frozen.get_fpga_entry(fpga).highspeed);
+	EXPECT_EQ(frozen.get_fpga_entries(wafer).size(), db.get_fpga_entries(wafer).size());
+	EXPECT_TRUE(frozen.get_reticle_entry(DNCGlobal(DNCOnWafer(Enum(0)), wafer)).to_be_powered);
+	EXPECT_EQ(frozen.get_ananas_entry(AnanasGlobal(AnanasOnWafer(0), wafer)).baseport_data, UDPPort(0xafe0));
+	EXPECT_EQ(frozen.get_hicann_entries(wafer).keys(), db.get_hicann_entries(wafer).keys());
+	EXPECT_EQ(frozen.get_hicann_entry(HICANNGlobal(HICANNOnWafer(Enum(88)), wafer)).label, "v4-26");
+	EXPECT_EQ(frozen.get_adc_entries(fpga).size(), 1);
+	EXPECT_FALSE(frozen.has_adc_entry(hwdb4cpp::GlobalAnalog_t(FPGAGlobal(FPGAOnWafer(0), Wafer(6)), AnalogOnHICANN(0))));
+	EXPECT_EQ(frozen.get_dls_setup_ids(), db.get_dls_setup_ids());
+	EXPECT_EQ(frozen.get_dls_entry("07_20").board_name, "Gaston");
+	EXPECT_EQ(frozen.get_hxcube_ids(), db.get_hxcube_ids());
+	EXPECT_EQ(frozen.get_hxcube_setup_entry(6).usb_host, "AMTHost11");
+	EXPECT_TRUE(frozen.has_jboa_setup_entry(7));
+	EXPECT_FALSE(frozen.has_jboa_setup_entry(8));
+	EXPECT_THROW(frozen.get_jboa_setup_entry(8), std::out_of_range);
+	EXPECT_THROW(frozen.get_wafer_entry(Wafer(6)), std::out_of_range);
+
+	// shared between threads without synchronization
+	std::vector<std::thread> readers;
+	std::atomic<size_t> found(0);
+	for (size_t i = 0; i < 4; ++i) {
+		readers.emplace_back([&frozen, &found] {
+			hwdb4cpp::frozen_database const copy = frozen;
+			found += copy.has_hxcube_setup_entry(6) && copy.has_dls_entry("07_20");
+		});
+	}
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	EXPECT_EQ(found, 4);
+
+	// moving the entries leaves the database empty
+	hwdb4cpp::frozen_database const moved = std::move(db).freeze();
+	EXPECT_TRUE(db.get_hxcube_ids().empty());
+	EXPECT_EQ(moved.get_jboa_ids(), frozen.get_jboa_ids());
+	EXPECT_EQ(moved.get_wafer_entry(wafer).macu, frozen.get_wafer_entry(wafer).macu);
+}
+
+#ifdef HWDB4CPP_EMBEDDED
+TEST_F(HWDB4CPP_Test, load_embedded)
+{
+	hwdb4cpp::database db;
+	db.load_embedded();
+	std::string const embedded = dump(db);
+	EXPECT_THROW(db.load_embedded(), std::runtime_error);
+
+	// same content as the YAML database it was compiled from
+	write_file(test_path, embedded);
+	hwdb4cpp::database yaml_db;
+	yaml_db.load(test_path);
+	EXPECT_EQ(dump(yaml_db), embedded);
+
+	db.clear();
+	db.load_embedded();
+	EXPECT_EQ(dump(db), embedded);
+}
+#endif
+
+TEST_F(HWDB4CPP_Test, load_filtered)
+{
+	hwdb4cpp::LoadOptions options;
+	options.filter.add(hwdb4cpp::SetupFamily::hxcube, 6);
+	options.filter.add(hwdb4cpp::SetupFamily::dls_setup, "07_20");
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+	EXPECT_TRUE(db.get_wafer_coordinates().empty());
+	EXPECT_EQ(db.get_dls_setup_ids(), std::vector<std::string>{"07_20"});
+	EXPECT_EQ(db.get_hxcube_ids(), std::vector<size_t>{6});
+	EXPECT_TRUE(db.get_jboa_ids().empty());
+
+	// unselected documents are not decoded, ids are compared numerically
+	write_file(test_path, test_db_string + "---\nwafer: 6\nsetuptype: nosetup\n---\nhxcube_id: 0x9\nfpgas: []\n");
+	hwdb4cpp::LoadOptions hxcube_options;
+	hxcube_options.filter.add(hwdb4cpp::SetupFamily::hxcube, "9");
+	hwdb4cpp::database hxcube_db;
+	hxcube_db.load(test_path, hxcube_options);
+	EXPECT_EQ(hxcube_db.get_hxcube_ids(), std::vector<size_t>{9});
+
+	// family without discriminating key at start of line is decoded and filtered afterwards
+	write_file(test_path, test_db_string + "--- {jboa_id: 8}\n");
+	hwdb4cpp::LoadOptions jboa_options;
+	jboa_options.filter.add(hwdb4cpp::SetupFamily::jboa);
+	hwdb4cpp::database jboa_db;
+	jboa_db.load(test_path, jboa_options);
+	EXPECT_EQ(jboa_db.get_jboa_ids(), (std::vector<size_t>{7, 8}));
+	EXPECT_TRUE(jboa_db.get_hxcube_ids().empty());
+
+	EXPECT_THROW(jboa_options.filter.add(hwdb4cpp::SetupFamily::wafer, "abc"), std::invalid_argument);
+}
+
+TEST_F(HWDB4CPP_Test, load_lazy)
+{
+	hwdb4cpp::LoadOptions options;
+	options.use_snapshot = false;
+	hwdb4cpp::database eager_db;
+	eager_db.load(test_path, options);
+
+	options.lazy = true;
+	hwdb4cpp::database lazy_db;
+	lazy_db.load(test_path, options);
+	EXPECT_EQ(lazy_db.get_wafer_coordinates(), eager_db.get_wafer_coordinates());
+	EXPECT_EQ(lazy_db.get_dls_setup_ids(), eager_db.get_dls_setup_ids());
+	EXPECT_EQ(lazy_db.get_hxcube_ids(), eager_db.get_hxcube_ids());
+	EXPECT_EQ(lazy_db.get_jboa_ids(), eager_db.get_jboa_ids());
+	EXPECT_EQ(dump(lazy_db), dump(eager_db));
+
+	// const accessors may be used concurrently, entries are decoded under a lock
+	hwdb4cpp::database lazy_shared_db;
+	lazy_shared_db.load(test_path, options);
+	hwdb4cpp::database const& shared_db = lazy_shared_db;
+	std::vector<std::thread> readers;
+	for (size_t i = 0; i < 4; ++i) {
+		readers.emplace_back([&shared_db, &eager_db, i]() {
+			for (size_t n = 0; n < 2; ++n) {
+				if ((i + n) % 2) {
+					EXPECT_EQ(shared_db.get_hxcube_setup_entry(6).usb_host,
+					          eager_db.get_hxcube_setup_entry(6).usb_host);
+				} else {
+					EXPECT_EQ(shared_db.get_wafer_coordinates(), eager_db.get_wafer_coordinates());
+					EXPECT_TRUE(shared_db.has_jboa_setup_entry(7));
+					EXPECT_EQ(shared_db.get_dls_entry("07_20").board_name,
+					          eager_db.get_dls_entry("07_20").board_name);
+				}
+			}
+		});
+	}
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	EXPECT_EQ(dump(shared_db), dump(eager_db));
+
+	// pending documents are copied, the file may be truncated before they are decoded
+	hwdb4cpp::database truncated_db;
+	truncated_db.load(test_path, options);
+	write_file(test_path, "");
+	EXPECT_EQ(dump(truncated_db), dump(eager_db));
+
+	// malformed documents are only reported on access of the respective entry
+	write_file(
+	    test_path, test_db_string + "---\nhxcube_id: 9\nfpgas:\n  - fpga: 08\n    ip: 192.168.66.1\n");
+	hwdb4cpp::database invalid_db;
+	invalid_db.load(test_path, options);
+	EXPECT_EQ(invalid_db.get_hxcube_ids(), (std::vector<size_t>{6, 9}));
+	EXPECT_TRUE(invalid_db.has_jboa_setup_entry(7));
+	EXPECT_ANY_THROW(invalid_db.get_hxcube_setup_entry(9));
+
+	// replaced and removed entries are never decoded
+	invalid_db.add_hxcube_setup_entry(9, hwdb4cpp::HXCubeSetupEntry());
+	EXPECT_TRUE(invalid_db.get_hxcube_setup_entry(9).fpgas.empty());
+	invalid_db.remove_hxcube_setup_entry(9);
+	EXPECT_FALSE(invalid_db.has_hxcube_setup_entry(9));
+	EXPECT_TRUE(invalid_db.remove_wafer_entry(Wafer(5)));
+	EXPECT_TRUE(invalid_db.get_wafer_coordinates().empty());
+
+	// later documents replace earlier ones with the same id
+	write_file(test_path, test_db_string + "---\ndls_setup: '07_20'\nboard_name: 'Other'\n");
+	hwdb4cpp::database replaced_db;
+	replaced_db.load(test_path, options);
+	EXPECT_EQ(replaced_db.get_dls_setup_ids(), std::vector<std::string>{"07_20"});
+	EXPECT_EQ(replaced_db.get_dls_entry("07_20").board_name, "Other");
+
+	replaced_db.clear();
+	EXPECT_TRUE(replaced_db.get_jboa_ids().empty());
+}
+
+TEST_F(HWDB4CPP_Test, load_unmappable)
+{
+	hwdb4cpp::database file_db;
+	file_db.load(test_path);
+
+	// pipes cannot be mapped and are read instead
+	std::string const fifo_path = test_path + ".fifo";
+	ASSERT_EQ(mkfifo(fifo_path.c_str(), 0600), 0);
+	std::thread writer([&]() { write_file(fifo_path, test_db_string); });
+	hwdb4cpp::database fifo_db;
+	fifo_db.load(fifo_path);
+	writer.join();
+	remove(fifo_path.c_str());
+	EXPECT_EQ(dump(file_db), dump(fifo_db));
+
+	// empty files cannot be mapped either
+	write_file(test_path, "");
+	hwdb4cpp::database empty_db;
+	empty_db.load(test_path);
+	EXPECT_TRUE(empty_db.get_dls_setup_ids().empty());
+
+	hwdb4cpp::database missing_db;
+	EXPECT_THROW(missing_db.load(test_path + ".missing"), std::runtime_error);
+}
+
+TEST_F(HWDB4CPP_Test, load_from_buffer)
+{
+	hwdb4cpp::database file_db;
+	file_db.load(test_path);
+
+	hwdb4cpp::database buffer_db;
+	buffer_db.load_from_buffer(test_db_string);
+	EXPECT_EQ(dump(file_db), dump(buffer_db));
+	EXPECT_THROW(buffer_db.load_from_buffer(test_db_string), std::runtime_error);
+
+	// lazy loads keep a copy of pending documents
+	hwdb4cpp::LoadOptions options;
+	options.lazy = true;
+	hwdb4cpp::database lazy_db;
+	{
+		std::string buffer = test_db_string;
+		lazy_db.load_from_buffer(buffer, options);
+		buffer.assign(buffer.size(), '#');
+	}
+	EXPECT_EQ(dump(file_db), dump(lazy_db));
+
+	// file descriptors are read from their current position
+	int const fd = open(test_path.c_str(), O_RDONLY);
+	ASSERT_GE(fd, 0);
+	ASSERT_GE(lseek(fd, test_db_string.find("---\ndls_setup"), SEEK_SET), 0);
+	hwdb4cpp::database fd_db;
+	fd_db.load_from_fd(fd);
+	close(fd);
+	EXPECT_TRUE(fd_db.get_wafer_coordinates().empty());
+	EXPECT_EQ(fd_db.get_dls_setup_ids(), std::vector<std::string>{"07_20"});
+	EXPECT_EQ(fd_db.get_jboa_ids(), std::vector<size_t>{7});
+}
+
+TEST_F(HWDB4CPP_Test, load_fragments)
+{
+	hwdb4cpp::database file_db;
+	file_db.load(test_path);
+
+	std::string const directory = test_path + ".d";
+	file_db.dump_fragments(directory);
+	for (auto const& name : {"wafer_5.yaml", "dls_setup_07_20.yaml", "hxcube_id_6.yaml",
+	                         "jboa_id_7.yaml"}) {
+		EXPECT_EQ(access((directory + "/" + name).c_str(), F_OK), 0) << name;
+	}
+
+	hwdb4cpp::database directory_db;
+	directory_db.load(directory);
+	EXPECT_EQ(dump(file_db), dump(directory_db));
+
+	hwdb4cpp::LoadOptions options;
+	options.lazy = true;
+	options.filter.add(hwdb4cpp::SetupFamily::hxcube);
+	hwdb4cpp::database lazy_db;
+	lazy_db.load(directory, options);
+	EXPECT_EQ(lazy_db.get_hxcube_ids(), std::vector<size_t>{6});
+	EXPECT_EQ(
+	    lazy_db.get_hxcube_setup_entry(6).usb_serial,
+	    file_db.get_hxcube_setup_entry(6).usb_serial);
+
+	// other files are ignored
+	write_file(directory + "/README", "not yaml");
+	write_file(directory + "/.hxcube_id_9.yaml", "hxcube_id: 9\n");
+
+	// the same setup in several fragments is an error
+	write_file(directory + "/other.yaml", "---\njboa_id: 8\n---\njboa_id: 7\n");
+	hwdb4cpp::database conflict_db;
+	EXPECT_THROW(conflict_db.load(directory), std::runtime_error);
+	EXPECT_TRUE(conflict_db.get_jboa_ids().empty());
+
+	// but fine within a single one
+	write_file(directory + "/other.yaml", "---\njboa_id: 8\n---\njboa_id: 8\n");
+	hwdb4cpp::database other_db;
+	other_db.load(directory);
+	EXPECT_EQ(other_db.get_jboa_ids(), (std::vector<size_t>{7, 8}));
+	EXPECT_EQ(other_db.get_hxcube_ids(), std::vector<size_t>{6});
+
+	// other yaml files are neither overwritten nor removed by dumping
+	file_db.remove_hxcube_setup_entry(6);
+	EXPECT_THROW(file_db.dump_fragments(directory), std::runtime_error);
+	EXPECT_EQ(access((directory + "/hxcube_id_6.yaml").c_str(), F_OK), 0);
+	EXPECT_EQ(access((directory + "/other.yaml").c_str(), F_OK), 0);
+	remove((directory + "/other.yaml").c_str());
+
+	// dumping again removes fragments of removed setups
+	file_db.dump_fragments(directory);
+	EXPECT_NE(access((directory + "/hxcube_id_6.yaml").c_str(), F_OK), 0);
+	EXPECT_EQ(access((directory + "/README").c_str(), F_OK), 0);
+	EXPECT_EQ(access((directory + "/.hxcube_id_9.yaml").c_str(), F_OK), 0);
+	hwdb4cpp::database redumped_db;
+	redumped_db.load(directory);
+	EXPECT_EQ(dump(redumped_db), dump(file_db));
+
+	for (auto const& name : {"wafer_5.yaml", "dls_setup_07_20.yaml", "hxcube_id_6.yaml",
+	                         "jboa_id_7.yaml", "README", ".hxcube_id_9.yaml", "other.yaml"}) {
+		remove((directory + "/" + name).c_str());
+	}
+	rmdir(directory.c_str());
+}
+
+TEST_F(HWDB4CPP_Test, reload)
+{
+	typedef std::vector<hwdb4cpp::ReloadSummary::Setup> Setups;
+	hwdb4cpp::LoadOptions options;
+	options.use_snapshot = false;
+	hwdb4cpp::database db;
+	db.load(test_path, options);
+	EXPECT_TRUE(db.reload(test_path).empty());
+
+	// modifications of unchanged setups are kept
+	db.get_jboa_setup_entry(7).xilinx_hw_server = "modified";
+
+	std::string const hxcube_6 = test_db_string.substr(
+	    test_db_string.find("---\nhxcube_id"),
+	    test_db_string.find("---\njboa_id") - test_db_string.find("---\nhxcube_id"));
+	std::string content = test_db_string;
+	content.replace(content.find("AMTHost11"), 9, "AMTHost12");
+	content.replace(
+	    content.find("---\ndls_setup"), 4,
+	    "---\ndls_setup: 'B123'\nboard_version: 1\nchip_id: 0\nchip_version: 1\n---\n");
+	content.erase(content.find("wafer: 5"), 8).insert(content.find("setuptype"), "wafer: 6\n");
+	write_file(test_path, content);
+
+	auto const summary = db.reload(test_path);
+	EXPECT_EQ(
+	    summary.added, (Setups{{hwdb4cpp::SetupFamily::wafer, "6"},
+	                           {hwdb4cpp::SetupFamily::dls_setup, "B123"}}));
+	EXPECT_EQ(summary.changed, (Setups{{hwdb4cpp::SetupFamily::hxcube, "6"}}));
+	EXPECT_EQ(summary.removed, (Setups{{hwdb4cpp::SetupFamily::wafer, "5"}}));
+	EXPECT_EQ(db.get_hxcube_setup_entry(6).usb_host, "AMTHost12");
+	EXPECT_EQ(db.get_jboa_setup_entry(7).xilinx_hw_server, "modified");
+	EXPECT_TRUE(db.has_wafer_entry(Wafer(6)));
+	EXPECT_FALSE(db.has_wafer_entry(Wafer(5)));
+
+	hwdb4cpp::database fresh_db;
+	fresh_db.load(test_path, options);
+	db.get_jboa_setup_entry(7).xilinx_hw_server = std::nullopt;
+	EXPECT_EQ(dump(fresh_db), dump(db));
+
+	// only the last document of a setup determines its value
+	write_file(test_path, content + hxcube_6);
+	EXPECT_EQ(db.reload(test_path).changed, (Setups{{hwdb4cpp::SetupFamily::hxcube, "6"}}));
+	EXPECT_EQ(db.get_hxcube_setup_entry(6).usb_host, "AMTHost11");
+	content.replace(content.find("AMTHost12"), 9, "AMTHost13");
+	write_file(test_path, content + hxcube_6);
+	EXPECT_TRUE(db.reload(test_path).empty());
+	EXPECT_EQ(db.get_hxcube_setup_entry(6).usb_host, "AMTHost11");
+	write_file(test_path, content);
+	EXPECT_EQ(db.reload(test_path).changed, (Setups{{hwdb4cpp::SetupFamily::hxcube, "6"}}));
+	EXPECT_EQ(db.get_hxcube_setup_entry(6).usb_host, "AMTHost13");
+
+	// failing reload keeps the database as it is
+	write_file(test_path, content + "---\nwafer: 7\nsetuptype: nosetup\n");
+	EXPECT_ANY_THROW(db.reload(test_path));
+	EXPECT_EQ(db.get_hxcube_setup_entry(6).usb_host, "AMTHost13");
+	write_file(test_path, content);
+
+	// databases not loaded from yaml are reloaded completely
+	hwdb4cpp::database empty_db;
+	EXPECT_EQ(empty_db.reload(test_path).added.size(), 5u);
+	db.dump_snapshot(test_path);
+	hwdb4cpp::database snapshot_db;
+	snapshot_db.load(test_path);
+	EXPECT_EQ(snapshot_db.reload(test_path).changed.size(), 5u);
+	EXPECT_TRUE(snapshot_db.reload(test_path).empty());
+}